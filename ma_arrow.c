@@ -0,0 +1,662 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include <ma_odbc.h>
+#include <errno.h>
+
+
+/* Column of the batch being built. Buffers are laid out the way Arrow wants them, and are handed over to the exported array */
+typedef struct
+{
+  const char    *Format;
+  unsigned char *Validity;
+  char          *Values;        /* Values of fixed width, bits of boolean, or offsets of variable length values */
+  char          *Data;          /* Variable length values */
+  int64_t        DataLength;
+  size_t         DataAllocated;
+  int64_t        NullCount;
+} MADB_ArrowColumn;
+
+#define MADB_ARROW_VARIABLE(aFormat) ((aFormat)[0] == 'U' || (aFormat)[0] == 'Z')
+#define MADB_ARROW_BITMAP_SIZE(aRows) (((aRows) + 7) / 8)
+
+/* {{{ MADB_ArrowFormat - Arrow format of the column. Type is chosen by the column's SQL type, the same as in IRD */
+static const char* MADB_ArrowFormat(MYSQL_FIELD *Field, BOOL Utf8)
+{
+  my_bool Unsigned= test(Field->flags & UNSIGNED_FLAG);
+
+  /* Its value is 1 byte integer, whatever SQL type it is mapped to */
+  if (Field->type == MYSQL_TYPE_TINY)
+  {
+    return Unsigned ? "C" : "c";
+  }
+
+  switch (MapMariadDbToOdbcType(Field))
+  {
+  case SQL_BIT:
+    return "b";
+  case SQL_SMALLINT:
+    return Unsigned ? "S" : "s";
+  case SQL_INTEGER:
+    return Unsigned ? "I" : "i";
+  case SQL_BIGINT:
+    return Unsigned ? "L" : "l";
+  case SQL_REAL:
+    return "f";
+  case SQL_DOUBLE:
+    return "g";
+  case SQL_TYPE_DATE:
+    return "tdD";
+  case SQL_TYPE_TIME:
+    return "ttu";
+  case SQL_TYPE_TIMESTAMP:
+    return "tsu:";
+  case SQL_BINARY:
+  case SQL_VARBINARY:
+  case SQL_LONGVARBINARY:
+    return "Z";
+  default:
+    /* Character types, and decimals in their text form */
+    return Utf8 ? "U" : "Z";
+  }
+}
+/* }}} */
+
+/* {{{ MADB_ArrowWidth - width of the fixed width value of the format */
+static size_t MADB_ArrowWidth(const char *Format)
+{
+  switch (Format[0])
+  {
+  case 'c':
+  case 'C':
+    return 1;
+  case 's':
+  case 'S':
+    return 2;
+  case 'i':
+  case 'I':
+  case 'f':
+    return 4;
+  case 't':
+    return Format[1] == 'd' ? 4 : 8;
+  default:
+    return 8;
+  }
+}
+/* }}} */
+
+/* {{{ MADB_ArrowDays - number of days since 1970-01-01 */
+static int32_t MADB_ArrowDays(int Year, int Month, int Day)
+{
+  int Era, YearOfEra, DayOfYear;
+
+  Year-=     Month <= 2;
+  Era=       (Year >= 0 ? Year : Year - 399) / 400;
+  YearOfEra= Year - Era * 400;
+  DayOfYear= (153 * (Month + (Month > 2 ? -3 : 9)) + 2) / 5 + Day - 1;
+
+  return Era * 146097 + YearOfEra * 365 + YearOfEra / 4 - YearOfEra / 100 + DayOfYear - 719468;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowLe - reads little endian integer of the binary protocol */
+static uint64_t MADB_ArrowLe(const unsigned char *Ptr, size_t Width)
+{
+  uint64_t Value= 0;
+
+  while (Width-- > 0)
+  {
+    Value= (Value << 8) | Ptr[Width];
+  }
+  return Value;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowColumnFree */
+static void MADB_ArrowColumnFree(MADB_ArrowColumn *Column)
+{
+  MADB_FREE(Column->Validity);
+  MADB_FREE(Column->Values);
+  MADB_FREE(Column->Data);
+}
+/* }}} */
+
+/* {{{ MADB_ArrowColumnInit */
+static BOOL MADB_ArrowColumnInit(MADB_ArrowColumn *Column, const char *Format, size_t Rows)
+{
+  size_t Size;
+
+  if (MADB_ARROW_VARIABLE(Format))
+  {
+    Size= (Rows + 1) * sizeof(int64_t);
+  }
+  else if (Format[0] == 'b')
+  {
+    Size= MADB_ARROW_BITMAP_SIZE(Rows);
+  }
+  else
+  {
+    Size= Rows * MADB_ArrowWidth(Format);
+  }
+  Column->Format= Format;
+
+  return (Column->Validity= (unsigned char *)MADB_CALLOC(MADB_ARROW_BITMAP_SIZE(Rows))) != NULL &&
+         (Column->Values= (char *)MADB_CALLOC(MAX(Size, 1))) != NULL;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowAppend - appends the value Ptr points to in the row to the column. Ptr is NULL for NULL value.
+       Returns FALSE if memory could not be allocated */
+static BOOL MADB_ArrowAppend(MADB_ArrowColumn *Column, unsigned char *Ptr, size_t Row)
+{
+  BOOL IsNull= Ptr == NULL;
+
+  if (MADB_ARROW_VARIABLE(Column->Format))
+  {
+    int64_t *Offsets= (int64_t *)Column->Values;
+
+    if (!IsNull)
+    {
+      unsigned long long Length= MADB_NetFieldLength(&Ptr);
+
+      if (Column->DataLength + Length > Column->DataAllocated)
+      {
+        size_t Allocated= MAX(Column->DataAllocated * 2, (size_t)(Column->DataLength + Length));
+        char  *Data=      (char *)MADB_REALLOC(Column->Data, MAX(Allocated, 1024));
+
+        if (Data == NULL)
+        {
+          return FALSE;
+        }
+        Column->Data=          Data;
+        Column->DataAllocated= MAX(Allocated, 1024);
+      }
+      memcpy(Column->Data + Column->DataLength, Ptr, (size_t)Length);
+      Column->DataLength+= Length;
+    }
+    Offsets[Row + 1]= Column->DataLength;
+  }
+  else if (!IsNull)
+  {
+    switch (Column->Format[0])
+    {
+    case 'b':
+    {
+      /* BIT(1) is sent as 1 byte string */
+      unsigned long long Length= MADB_NetFieldLength(&Ptr);
+
+      if (Length > 0 && Ptr[Length - 1] != 0)
+      {
+        Column->Values[Row / 8]|= (char)(1 << (Row % 8));
+      }
+      break;
+    }
+    case 't':
+    {
+      /* Length of the value, then year(2), month, day, hour, minute, second, microseconds(4). Time starts with sign
+         and days(4) instead of the date */
+      unsigned char Length= *Ptr++;
+      int64_t       Value;
+
+      if (Column->Format[1] == 't')
+      {
+        Value= Length < 8 ? 0 : ((int64_t)MADB_ArrowLe(Ptr + 1, 4) * 86400 + Ptr[5] * 3600 + Ptr[6] * 60 + Ptr[7]) * 1000000 +
+                                (Length < 12 ? 0 : (int64_t)MADB_ArrowLe(Ptr + 8, 4));
+        if (Length >= 8 && Ptr[0])
+        {
+          Value= -Value;
+        }
+        memcpy(Column->Values + Row * 8, &Value, 8);
+        break;
+      }
+      /* Zero date can't be represented */
+      if (Length < 4 || Ptr[2] == 0 || Ptr[3] == 0)
+      {
+        IsNull= TRUE;
+        break;
+      }
+      if (Column->Format[1] == 'd')
+      {
+        int32_t Days= MADB_ArrowDays((int)MADB_ArrowLe(Ptr, 2), Ptr[2], Ptr[3]);
+        memcpy(Column->Values + Row * 4, &Days, 4);
+        break;
+      }
+      Value= (int64_t)MADB_ArrowDays((int)MADB_ArrowLe(Ptr, 2), Ptr[2], Ptr[3]) * 86400;
+      if (Length >= 7)
+      {
+        Value+= Ptr[4] * 3600 + Ptr[5] * 60 + Ptr[6];
+      }
+      Value*= 1000000;
+      if (Length >= 11)
+      {
+        Value+= (int64_t)MADB_ArrowLe(Ptr + 7, 4);
+      }
+      memcpy(Column->Values + Row * 8, &Value, 8);
+      break;
+    }
+    default:
+    {
+      /* Numbers are sent as little endian integers and IEEE floats of the same width */
+      size_t   Width= MADB_ArrowWidth(Column->Format);
+      uint64_t Value= MADB_ArrowLe(Ptr, Width);
+
+      switch (Width)
+      {
+      case 1:
+        Column->Values[Row]= (char)Value;
+        break;
+      case 2:
+        ((uint16_t *)Column->Values)[Row]= (uint16_t)Value;
+        break;
+      case 4:
+        ((uint32_t *)Column->Values)[Row]= (uint32_t)Value;
+        break;
+      default:
+        ((uint64_t *)Column->Values)[Row]= Value;
+      }
+    }
+    }
+  }
+
+  if (IsNull)
+  {
+    ++Column->NullCount;
+  }
+  else
+  {
+    Column->Validity[Row / 8]|= (unsigned char)(1 << (Row % 8));
+  }
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowSchemaRelease */
+static void MADB_ArrowSchemaRelease(struct ArrowSchema *Schema)
+{
+  int64_t i;
+
+  for (i= 0; i < Schema->n_children; ++i)
+  {
+    if (Schema->children[i]->release != NULL)
+    {
+      Schema->children[i]->release(Schema->children[i]);
+    }
+  }
+  MADB_FREE(Schema->private_data);
+  Schema->release= NULL;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowChildSchemaRelease - children's structures belong to the parent, and only the name is child's own */
+static void MADB_ArrowChildSchemaRelease(struct ArrowSchema *Schema)
+{
+  MADB_FREE(Schema->private_data);
+  Schema->release= NULL;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowArrayRelease */
+static void MADB_ArrowArrayRelease(struct ArrowArray *Array)
+{
+  int64_t i;
+
+  for (i= 0; i < Array->n_children; ++i)
+  {
+    if (Array->children[i]->release != NULL)
+    {
+      Array->children[i]->release(Array->children[i]);
+    }
+  }
+  MADB_FREE(Array->private_data);
+  Array->release= NULL;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowChildArrayRelease - child array owns its buffers, so it can be moved out of the batch */
+static void MADB_ArrowChildArrayRelease(struct ArrowArray *Array)
+{
+  int64_t i;
+
+  for (i= 0; i < Array->n_buffers; ++i)
+  {
+    free((void *)Array->buffers[i]);
+  }
+  MADB_FREE(Array->private_data);
+  Array->release= NULL;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowGetSchema */
+static int MADB_ArrowGetSchema(struct ArrowArrayStream *Stream, struct ArrowSchema *Out)
+{
+  MADB_ArrowStream    *Arrow= (MADB_ArrowStream *)Stream->private_data;
+  struct ArrowSchema **Children;
+  struct ArrowSchema  *Child;
+  unsigned int         i;
+
+  memset(Out, 0, sizeof(struct ArrowSchema));
+
+  if (!(Children= (struct ArrowSchema **)MADB_CALLOC(Arrow->ColumnCount * (sizeof(struct ArrowSchema *) + sizeof(struct ArrowSchema)) + 1)))
+  {
+    strcpy(Arrow->Error, "Could not allocate memory for the schema");
+    return ENOMEM;
+  }
+  Child= (struct ArrowSchema *)(Children + Arrow->ColumnCount);
+
+  Out->format=       "+s";
+  Out->name=         "";
+  Out->n_children=   Arrow->ColumnCount;
+  Out->children=     Children;
+  Out->release=      MADB_ArrowSchemaRelease;
+  Out->private_data= Children;
+
+  for (i= 0; i < Arrow->ColumnCount; ++i)
+  {
+    Children[i]=          &Child[i];
+    Child[i].format=      Arrow->Format[i];
+    Child[i].flags=       ARROW_FLAG_NULLABLE;
+    Child[i].release=     MADB_ArrowChildSchemaRelease;
+    Child[i].name=        Child[i].private_data= _strdup(Arrow->Name[i]);
+
+    if (Child[i].name == NULL)
+    {
+      MADB_ArrowSchemaRelease(Out);
+      strcpy(Arrow->Error, "Could not allocate memory for the schema");
+      return ENOMEM;
+    }
+  }
+
+  return 0;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowGetNext - reads next batch of rows of the result. At the end of the result returns released array */
+static int MADB_ArrowGetNext(struct ArrowArrayStream *Stream, struct ArrowArray *Out)
+{
+  MADB_ArrowStream   *Arrow= (MADB_ArrowStream *)Stream->private_data;
+  MADB_ArrowColumn   *Column;
+  struct ArrowArray **Children;
+  struct ArrowArray  *Child;
+  MYSQL_STMT         *stmt;
+  size_t              Rows= 0;
+  unsigned int        i;
+  int                 rc= 0, Error= 0;
+
+  memset(Out, 0, sizeof(struct ArrowArray));
+
+  if (Arrow->Done)
+  {
+    return 0;
+  }
+  if (Arrow->Stmt == NULL)
+  {
+    strcpy(Arrow->Error, "Result of the statement has been closed");
+    return EINVAL;
+  }
+  stmt= Arrow->Stmt->stmt;
+
+  if (!(Column= (MADB_ArrowColumn *)MADB_CALLOC(sizeof(MADB_ArrowColumn) * MAX(Arrow->ColumnCount, 1))))
+  {
+    strcpy(Arrow->Error, "Could not allocate memory for the batch");
+    return ENOMEM;
+  }
+  for (i= 0; i < Arrow->ColumnCount; ++i)
+  {
+    if (!MADB_ArrowColumnInit(&Column[i], Arrow->Format[i], Arrow->BatchRows))
+    {
+      Error= ENOMEM;
+      break;
+    }
+  }
+
+  LOCK_MARIADB(Arrow->Stmt->Connection);
+  /* The application may call this from other thread, than the one using the connection. If other statement is reading its
+     result from the connection, the rest of that result is stored first. Own unbuffered result is what the batch is read from */
+  if (Arrow->Stmt->Connection->Streamer != Arrow->Stmt)
+  {
+    MADB_StoreStreamer(Arrow->Stmt->Connection, NULL);
+  }
+
+  /* SQLFetch binds the driver's buffers for every rowset, thus the binding can't be kept between batches */
+  if (Error == 0 && mysql_stmt_bind_result(stmt, Arrow->Bind))
+  {
+    Error= EIO;
+  }
+  while (Error == 0 && Rows < Arrow->BatchRows && (rc= mysql_stmt_fetch(stmt)) != MYSQL_NO_DATA)
+  {
+    if (rc == 1)
+    {
+      Error= EIO;
+      break;
+    }
+    for (i= 0; i < Arrow->ColumnCount; ++i)
+    {
+      if (!MADB_ArrowAppend(&Column[i], stmt->bind[i].u.row_ptr, Rows))
+      {
+        Error= ENOMEM;
+        break;
+      }
+    }
+    ++Rows;
+  }
+
+  if (rc == MYSQL_NO_DATA)
+  {
+    Arrow->Done= TRUE;
+    /* Whole result has been read, and the connection can be used by others */
+    if (Arrow->Stmt->Connection->Streamer == Arrow->Stmt)
+    {
+      Arrow->Stmt->Connection->Streamer= NULL;
+    }
+  }
+  UNLOCK_MARIADB(Arrow->Stmt->Connection);
+
+  if (Error == 0 && Rows > 0 &&
+      !(Children= (struct ArrowArray **)MADB_CALLOC(Arrow->ColumnCount * (sizeof(struct ArrowArray *) + sizeof(struct ArrowArray)) +
+                                                    sizeof(void *))))
+  {
+    Error= ENOMEM;
+  }
+  if (Error != 0 || Rows == 0)
+  {
+    for (i= 0; i < Arrow->ColumnCount; ++i)
+    {
+      MADB_ArrowColumnFree(&Column[i]);
+    }
+    MADB_FREE(Column);
+
+    if (Error == EIO)
+    {
+      strncpy(Arrow->Error, mysql_stmt_error(stmt), sizeof(Arrow->Error) - 1);
+    }
+    else if (Error == ENOMEM)
+    {
+      strcpy(Arrow->Error, "Could not allocate memory for the batch");
+    }
+    return Error;
+  }
+
+  /* Struct array has only validity buffer, and it is not needed */
+  Child=             (struct ArrowArray *)(Children + Arrow->ColumnCount);
+  Out->length=       Rows;
+  Out->n_buffers=    1;
+  Out->buffers=      (const void **)(Child + Arrow->ColumnCount);
+  Out->n_children=   Arrow->ColumnCount;
+  Out->children=     Children;
+  Out->release=      MADB_ArrowArrayRelease;
+  Out->private_data= Children;
+
+  for (i= 0; i < Arrow->ColumnCount; ++i)
+  {
+    const void **Buffers= (const void **)MADB_CALLOC(3 * sizeof(void *));
+
+    Children[i]= &Child[i];
+    if (Buffers == NULL)
+    {
+      MADB_ArrowColumnFree(&Column[i]);
+      continue;
+    }
+    Child[i].length=       Rows;
+    Child[i].null_count=   Column[i].NullCount;
+    Child[i].n_buffers=    MADB_ARROW_VARIABLE(Column[i].Format) ? 3 : 2;
+    Child[i].buffers=      Buffers;
+    Child[i].release=      MADB_ArrowChildArrayRelease;
+    Child[i].private_data= (void *)Buffers;
+    Buffers[0]=            Column[i].Validity;
+    Buffers[1]=            Column[i].Values;
+    if (Child[i].n_buffers == 3)
+    {
+      /* Data buffer can't be NULL, even if all values are empty or NULL */
+      Buffers[2]= Column[i].Data != NULL ? Column[i].Data : MADB_CALLOC(1);
+    }
+  }
+  MADB_FREE(Column);
+
+  for (i= 0; i < Arrow->ColumnCount; ++i)
+  {
+    if (Child[i].release == NULL || (Child[i].n_buffers == 3 && Child[i].buffers[2] == NULL))
+    {
+      MADB_ArrowArrayRelease(Out);
+      strcpy(Arrow->Error, "Could not allocate memory for the batch");
+      return ENOMEM;
+    }
+  }
+
+  return 0;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowGetLastError */
+static const char* MADB_ArrowGetLastError(struct ArrowArrayStream *Stream)
+{
+  MADB_ArrowStream *Arrow= (MADB_ArrowStream *)Stream->private_data;
+
+  return Arrow->Error[0] != '\0' ? Arrow->Error : NULL;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowStreamFree */
+static void MADB_ArrowStreamFree(MADB_ArrowStream *Arrow)
+{
+  unsigned int i;
+
+  if (Arrow->Name != NULL)
+  {
+    for (i= 0; i < Arrow->ColumnCount; ++i)
+    {
+      MADB_FREE(Arrow->Name[i]);
+    }
+  }
+  MADB_FREE(Arrow->Name);
+  MADB_FREE(Arrow->Format);
+  MADB_FREE(Arrow->Bind);
+  MADB_FREE(Arrow);
+}
+/* }}} */
+
+/* {{{ MADB_ArrowRelease */
+static void MADB_ArrowRelease(struct ArrowArrayStream *Stream)
+{
+  MADB_ArrowStream *Arrow= (MADB_ArrowStream *)Stream->private_data;
+
+  if (Arrow->Stmt != NULL)
+  {
+    Arrow->Stmt->ArrowStream= NULL;
+  }
+  MADB_ArrowStreamFree(Arrow);
+  Stream->release= NULL;
+}
+/* }}} */
+
+/* {{{ MADB_ArrowExport - fills application's stream structure with the stream of the rest of the statement's current result */
+SQLRETURN MADB_ArrowExport(MADB_Stmt *Stmt, struct ArrowArrayStream *Stream, SQLINTEGER BufferLength)
+{
+  MADB_ArrowStream *Arrow;
+  BOOL              Utf8= MADB_IS_UTF8(Stmt->Connection->Charset.cs_info);
+  unsigned int      i, ColumnCount;
+
+  if (Stream == NULL || BufferLength < (SQLINTEGER)sizeof(struct ArrowArrayStream))
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY090, NULL, 0);
+  }
+  if (Stmt->State < MADB_SS_EXECUTED || MADB_STMT_COLUMN_COUNT(Stmt) == 0)
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_24000, NULL, 0);
+  }
+  /* Rows of the next rowset are in the prefetch buffers, and can't go to the stream anymore */
+  if (MADB_PrefetchDisable(Stmt))
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY010, NULL, 0);
+  }
+  ColumnCount= mysql_stmt_field_count(Stmt->stmt);
+
+  if (!(Arrow= (MADB_ArrowStream *)MADB_CALLOC(sizeof(MADB_ArrowStream))) ||
+      !(Arrow->Bind= (MYSQL_BIND *)MADB_CALLOC(sizeof(MYSQL_BIND) * ColumnCount)) ||
+      !(Arrow->Format= (const char **)MADB_CALLOC(sizeof(char *) * ColumnCount)) ||
+      !(Arrow->Name= (char **)MADB_CALLOC(sizeof(char *) * ColumnCount)))
+  {
+    goto memerror;
+  }
+  Arrow->ColumnCount= ColumnCount;
+
+  for (i= 0; i < ColumnCount; ++i)
+  {
+    MYSQL_FIELD *Field= &Stmt->stmt->fields[i];
+
+    Arrow->Bind[i].buffer_type= MYSQL_TYPE_STRING;
+    Arrow->Bind[i].flags=       MADB_BIND_DUMMY;
+    Arrow->Format[i]=           MADB_ArrowFormat(Field, Utf8);
+    if (!(Arrow->Name[i]= _strdup(Field->name != NULL ? Field->name : "")))
+    {
+      goto memerror;
+    }
+  }
+  Arrow->BatchRows= Stmt->Ard->Header.ArraySize > 1 ? (size_t)Stmt->Ard->Header.ArraySize : MADB_ARROW_BATCH_ROWS;
+
+  /* Only one stream reads the result */
+  MADB_ArrowDetach(Stmt);
+  Arrow->Stmt=       Stmt;
+  Stmt->ArrowStream= Arrow;
+
+  Stream->get_schema=     MADB_ArrowGetSchema;
+  Stream->get_next=       MADB_ArrowGetNext;
+  Stream->get_last_error= MADB_ArrowGetLastError;
+  Stream->release=        MADB_ArrowRelease;
+  Stream->private_data=   Arrow;
+
+  return SQL_SUCCESS;
+
+memerror:
+  if (Arrow != NULL)
+  {
+    MADB_ArrowStreamFree(Arrow);
+  }
+  return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+}
+/* }}} */
+
+/* {{{ MADB_ArrowDetach - statement's result is closed. Stream, if any, stays valid, but can't read rows anymore */
+void MADB_ArrowDetach(MADB_Stmt *Stmt)
+{
+  if (Stmt->ArrowStream != NULL)
+  {
+    Stmt->ArrowStream->Stmt= NULL;
+    Stmt->ArrowStream=       NULL;
+  }
+}
+/* }}} */
@@ -0,0 +1,100 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+/* Export of the statement's result as the stream of Arrow record batches(Arrow C Stream Interface). Application passes
+ * pointer to its struct ArrowArrayStream to SQLGetStmtAttr(MADB_ATTR_ARROW_STREAM), and the driver fills it. Batches are
+ * built column by column right from the rows C/C reads, without ODBC binding and conversion of every value. Stream reads
+ * the rest of the current result, each batch has up to SQL_ATTR_ROW_ARRAY_SIZE rows, or MADB_ARROW_BATCH_ROWS if the array
+ * size is 1 */
+
+#ifndef _ma_arrow_h_
+#define _ma_arrow_h_
+
+#include <stdint.h>
+
+#define MADB_ATTR_ARROW_STREAM  (SQL_DRIVER_STMT_ATTR_BASE + 1)
+#define MADB_ARROW_BATCH_ROWS   65536
+
+/* Structures below are defined by the Arrow C Data and C Stream Interfaces specification */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t     flags;
+  int64_t     n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema  *dictionary;
+  void (*release)(struct ArrowSchema *);
+  void       *private_data;
+};
+
+struct ArrowArray
+{
+  int64_t      length;
+  int64_t      null_count;
+  int64_t      offset;
+  int64_t      n_buffers;
+  int64_t      n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray  *dictionary;
+  void (*release)(struct ArrowArray *);
+  void        *private_data;
+};
+
+#endif
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream
+{
+  int         (*get_schema)(struct ArrowArrayStream *, struct ArrowSchema *out);
+  int         (*get_next)(struct ArrowArrayStream *, struct ArrowArray *out);
+  const char *(*get_last_error)(struct ArrowArrayStream *);
+  void        (*release)(struct ArrowArrayStream *);
+  void         *private_data;
+};
+
+#endif
+
+typedef struct st_ma_arrow_stream
+{
+  MADB_Stmt     *Stmt;        /* NULL once the statement's result is closed */
+  MYSQL_BIND    *Bind;        /* Dummy binds - C/C only points to values in the row */
+  const char   **Format;
+  char         **Name;
+  unsigned int   ColumnCount;
+  size_t         BatchRows;
+  my_bool        Done;
+  char           Error[SQL_MAX_MESSAGE_LENGTH];
+} MADB_ArrowStream;
+
+SQLRETURN MADB_ArrowExport(MADB_Stmt *Stmt, struct ArrowArrayStream *Stream, SQLINTEGER BufferLength);
+void      MADB_ArrowDetach(MADB_Stmt *Stmt);
+
+#endif
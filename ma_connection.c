@@ -186,6 +186,7 @@ SQLRETURN MADB_DbcSetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
         if (Dbc->EnlistInDtc) {
           return MADB_SetError(&Dbc->Error, MADB_ERR_25000, NULL, 0);
         }
+        MADB_StoreStreamer(Dbc, NULL);
         if (mysql_autocommit(Dbc->mariadb, (my_bool)(size_t)ValuePtr))
         {
           return MADB_SetError(&Dbc->Error, MADB_ERR_HY001, mysql_error(Dbc->mariadb), mysql_errno(Dbc->mariadb));
@@ -208,11 +209,19 @@ SQLRETURN MADB_DbcSetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
       else
         Dbc->CatalogName= _strdup((char *)ValuePtr);
 
+      if (Dbc->mariadb != NULL)
+      {
+        MADB_StoreStreamer(Dbc, NULL);
+      }
       if (Dbc->mariadb &&
           mysql_select_db(Dbc->mariadb, Dbc->CatalogName))
       {
         return MADB_SetError(&Dbc->Error, MADB_ERR_HY001, mysql_error(Dbc->mariadb), mysql_errno(Dbc->mariadb));
       }
+      /* Cached statements have been prepared in the previous catalog */
+      LOCK_MARIADB(Dbc);
+      MADB_PsCacheClear(Dbc);
+      UNLOCK_MARIADB(Dbc);
     }
     break;
   case SQL_ATTR_LOGIN_TIMEOUT:
@@ -265,6 +274,7 @@ SQLRETURN MADB_DbcSetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
           _snprintf(StmtStr, sizeof(StmtStr), "SET SESSION TRANSACTION ISOLATION LEVEL %s",
                       MADB_IsolationLevel[i].StrIsolation);
           LOCK_MARIADB(Dbc);
+          MADB_StoreStreamer(Dbc, NULL);
           if (mysql_query(Dbc->mariadb, StmtStr))
           {
             UNLOCK_MARIADB(Dbc);
@@ -282,6 +292,10 @@ SQLRETURN MADB_DbcSetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
     }
     Dbc->TxnIsolation= (SQLINTEGER)(SQLLEN)ValuePtr;
     break;
+  case MADB_ATTR_PS_CACHE_HITS:
+  case MADB_ATTR_PS_CACHE_MISSES:
+    /* read only! */
+    return MADB_SetError(&Dbc->Error, MADB_ERR_HY092, NULL, 0);
   default:
     break;
   }
@@ -392,6 +406,7 @@ SQLRETURN MADB_DbcGetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
         const char *StmtString= "SELECT VARIABLE_VALUE FROM INFORMATION_SCHEMA.SESSION_VARIABLES WHERE VARIABLE_NAME='TX_ISOLATION'";
 
         LOCK_MARIADB(Dbc);
+        MADB_StoreStreamer(Dbc, NULL);
         if (mysql_query(Dbc->mariadb, StmtString))
         {
           UNLOCK_MARIADB(Dbc);
@@ -416,6 +431,12 @@ SQLRETURN MADB_DbcGetAttr(MADB_Dbc *Dbc, SQLINTEGER Attribute, SQLPOINTER ValueP
     else 
       *(SQLULEN *)ValuePtr= Dbc->TxnIsolation;
     break;
+  case MADB_ATTR_PS_CACHE_HITS:
+    *(SQLULEN *)ValuePtr= Dbc->PsCache != NULL ? Dbc->PsCache->Hits : 0;
+    break;
+  case MADB_ATTR_PS_CACHE_MISSES:
+    *(SQLULEN *)ValuePtr= Dbc->PsCache != NULL ? Dbc->PsCache->Misses : 0;
+    break;
 
   default:
     MADB_SetError(&Dbc->Error, MADB_ERR_HYC00, NULL, 0);
@@ -480,6 +501,8 @@ SQLRETURN MADB_DbcFree(MADB_Dbc *Connection)
   /* TODO: If somebody uses connection it won't help if lock it here. At least it requires
            more fingers movements
     LOCK_MARIADB(Dbc);*/
+  MADB_PsCacheFree(Connection);
+  MADB_FixPoolFree(Connection);
   if (Connection->mariadb)
   {
     mysql_close(Connection->mariadb);
@@ -514,6 +537,7 @@ SQLRETURN MADB_Dbc_GetCurrentDB(MADB_Dbc *Connection, SQLPOINTER CurrentDB, SQLI
     MYSQL_ROW  row;
 
     MADB_CLEAR_ERROR(&Connection->Error);
+    MADB_StoreStreamer(Connection, NULL);
     if (mysql_query(Connection->mariadb, "SELECT DATABASE()")) {
         MADB_SetError(&Connection->Error, MADB_ERR_HY000, "Error while querying current catalog", 0);
         goto end;
@@ -569,10 +593,12 @@ SQLRETURN MADB_DbcEndTran(MADB_Dbc *Dbc, SQLSMALLINT CompletionType)
     return SQL_INVALID_HANDLE;
 
   LOCK_MARIADB(Dbc);
+  MADB_StoreStreamer(Dbc, NULL);
   switch (CompletionType) {
   case SQL_ROLLBACK:
     if (Dbc->mariadb && mysql_rollback(Dbc->mariadb))
       MADB_SetNativeError(&Dbc->Error, SQL_HANDLE_DBC, Dbc->mariadb);
+    ++Dbc->Changes;
     break;
   case SQL_COMMIT:
     if (Dbc->mariadb && mysql_commit(Dbc->mariadb))
@@ -1420,10 +1446,11 @@ SQLRETURN MADB_DbcGetInfo(MADB_Dbc *Dbc, SQLUSMALLINT InfoType, SQLPOINTER InfoV
                                      "N", SQL_NTS, &Dbc->Error);
     break;
   case SQL_KEYSET_CURSOR_ATTRIBUTES1:
-    MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, 0, StringLengthPtr);
+    MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, SQL_CA1_ABSOLUTE | SQL_CA1_NEXT | SQL_CA1_RELATIVE, StringLengthPtr);
     break;
   case SQL_KEYSET_CURSOR_ATTRIBUTES2:
-    MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, 0, StringLengthPtr);
+    MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, SQL_CA2_MAX_ROWS_SELECT | SQL_CA2_SENSITIVITY_DELETIONS |
+                                                SQL_CA2_SENSITIVITY_UPDATES, StringLengthPtr);
     break;
   case SQL_KEYWORDS:
     SLen= (SQLSMALLINT)MADB_SetString(isWChar ? &Dbc->Charset : NULL, (void *)InfoValuePtr, BUFFER_CHAR_LEN(BufferLength, isWChar),
@@ -1598,7 +1625,7 @@ SQLRETURN MADB_DbcGetInfo(MADB_Dbc *Dbc, SQLUSMALLINT InfoType, SQLPOINTER InfoV
     {
       SQLUINTEGER Options= SQL_SO_FORWARD_ONLY;
       if (!MA_ODBC_CURSOR_FORWARD_ONLY(Dbc))
-        Options|= SQL_SO_STATIC;
+        Options|= SQL_SO_STATIC | SQL_SO_KEYSET_DRIVEN;
       if (MA_ODBC_CURSOR_DYNAMIC(Dbc))
         Options|= SQL_SO_DYNAMIC;
       MADB_SET_NUM_VAL(SQLUINTEGER, InfoValuePtr, Options, StringLengthPtr);
@@ -0,0 +1,176 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include <ma_odbc.h>
+
+/* {{{ MADB_ScanNumber - reads decimal number the way %d and %u conversions of sscanf do: leading whitespace is skipped,
+       then optional sign, and at least one digit is required. Width, if not 0, limits number of sign and digit characters.
+       Negative values are returned in two's complement, as sscanf stores them into the unsigned fields of MYSQL_TIME */
+static BOOL MADB_ScanNumber(const char **Ptr, const char *End, size_t Width, unsigned long long *Value)
+{
+  const char        *Current= *Ptr, *Limit;
+  unsigned long long Result= 0;
+  BOOL               Negative= FALSE;
+
+  while (Current < End && isspace((unsigned char)*Current))
+  {
+    ++Current;
+  }
+  Limit= Width != 0 && (size_t)(End - Current) > Width ? Current + Width : End;
+
+  if (Current < Limit && (*Current == '-' || *Current == '+'))
+  {
+    Negative= *Current == '-';
+    ++Current;
+  }
+  if (Current == Limit || *Current < '0' || *Current > '9')
+  {
+    return FALSE;
+  }
+  while (Current < Limit && *Current >= '0' && *Current <= '9')
+  {
+    Result= Result * 10 + (*Current++ - '0');
+  }
+
+  *Value= Negative ? 0 - Result : Result;
+  *Ptr=   Current;
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_ScanField - reads number into the MYSQL_TIME field, and the separator following it, if one is given */
+static BOOL MADB_ScanField(const char **Ptr, const char *End, unsigned int *Field, char Separator)
+{
+  unsigned long long Value;
+
+  if (!MADB_ScanNumber(Ptr, End, 0, &Value))
+  {
+    return FALSE;
+  }
+  *Field= (unsigned int)Value;
+
+  if (Separator != '\0')
+  {
+    if (*Ptr == End || **Ptr != Separator)
+    {
+      return FALSE;
+    }
+    ++*Ptr;
+  }
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_ParseDateTime - parses [-]YY[YY]-MM-DD, [-]YY[YY]-MM-DD hh:mm:ss[.ffffff] and hh:mm:ss[.ffffff] values.
+       Returns FALSE if value is malformed. Fields, that have been read before the error was detected, stay in Tm.
+       Date part is recognized by the presence of '-' anywhere in the value, time part - by the ':' after the first space
+       in the value, or anywhere in it, if it's not a date. Two digits years are completed to 19YY or 20YY, unless Interval
+       is set. Empty value, or value of whitespaces only, yields zeroed Tm */
+BOOL MADB_ParseDateTime(const char *Str, size_t Length, MYSQL_TIME *Tm, BOOL Interval, BOOL *isTime)
+{
+  const char *Start= Str, *End, *Frac, *Nul;
+  my_bool     isDate= 0;
+
+  memset(Tm, 0, sizeof(MYSQL_TIME));
+
+  /* Value ends at the first null character, if there is one */
+  if ((Nul= memchr(Str, '\0', Length)) != NULL)
+  {
+    Length= Nul - Str;
+  }
+  End= Str + Length;
+
+  while (Start < End && isspace((unsigned char)*Start))
+  {
+    ++Start;
+  }
+  if (Start == End)
+  {
+    return TRUE;
+  }
+
+  if (memchr(Start, '-', End - Start) != NULL)
+  {
+    const char *Current= Start;
+
+    if (!MADB_ScanField(&Current, End, &Tm->year, '-') || !MADB_ScanField(&Current, End, &Tm->month, '-')
+     || !MADB_ScanField(&Current, End, &Tm->day, '\0'))
+    {
+      return FALSE;
+    }
+    isDate= 1;
+    if ((Start= memchr(Start, ' ', End - Start)) == NULL)
+    {
+      goto check;
+    }
+  }
+  if (memchr(Start, ':', End - Start) == NULL)
+  {
+    goto check;
+  }
+
+  if (isDate == 0)
+  {
+    *isTime= 1;
+  }
+
+  Frac= memchr(Start, '.', End - Start);
+
+  if (!MADB_ScanField(&Start, End, &Tm->hour, ':') || !MADB_ScanField(&Start, End, &Tm->minute, ':')
+   || !MADB_ScanField(&Start, End, &Tm->second, Frac != NULL ? '.' : '\0'))
+  {
+    return FALSE;
+  }
+
+  if (Frac != NULL) /* fractional seconds */
+  {
+    /* Fraction scale is taken from the number of characters following the point */
+    size_t             FracLength= End - Frac - 1;
+    unsigned long long Value;
+
+    /* ODBC - nano-seconds, MYSQL_TIME keeps microseconds, and the rest is not read */
+    if (!MADB_ScanNumber(&Start, End, 6, &Value))
+    {
+      return FALSE;
+    }
+    Tm->second_part= (unsigned long)Value;
+
+    if (FracLength > 0 && FracLength < 6)
+    {
+      static const unsigned long Mul[]= {100000, 10000, 1000, 100, 10};
+      Tm->second_part*= Mul[FracLength - 1];
+    }
+  }
+
+check:
+  if (Interval == FALSE && isDate && Tm->year > 0)
+  {
+    if (Tm->year < 70)
+    {
+      Tm->year+= 2000;
+    }
+    else if (Tm->year < 100)
+    {
+      Tm->year+= 1900;
+    }
+  }
+
+  return TRUE;
+}
+/* }}} */
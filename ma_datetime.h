@@ -0,0 +1,28 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+/* Parsing of date, time and timestamp values, that come as strings from the server, or from the application in character
+ * buffers. Parser works on the (pointer, length) pair in place, without copying or null-terminating the value */
+
+#ifndef _ma_datetime_h_
+#define _ma_datetime_h_
+
+BOOL MADB_ParseDateTime(const char *Str, size_t Length, MYSQL_TIME *Tm, BOOL Interval, BOOL *isTime);
+
+#endif
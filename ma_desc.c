@@ -117,6 +117,7 @@ SQLRETURN MADB_DescFree(MADB_Desc *Desc, my_bool RecordsOnly)
   if (!Desc)
     return SQL_ERROR;
 
+  ++Desc->Version;
   /* We need to free internal pointers first */
   for (i=0; i < Desc->Records.elements; i++)
   {
@@ -152,6 +153,7 @@ SQLRETURN MADB_DescFree(MADB_Desc *Desc, my_bool RecordsOnly)
       switch(Desc->DescType) {
       case MADB_DESC_ARD:
         Stmt->Ard=Stmt->IArd;
+        MADB_FetchPlanFree(Stmt);
         break;
       case MADB_DESC_APD:
         Stmt->Apd= Stmt->IApd;
@@ -635,6 +637,11 @@ MADB_DescRecord *MADB_DescGetInternalRecord(MADB_Desc *Desc, SQLSMALLINT RecordN
   if (RecordNumber + 1 > Desc->Header.Count)
     Desc->Header.Count= (SQLSMALLINT)(RecordNumber + 1);
 
+  if (Type == MADB_DESC_WRITE)
+  {
+    ++Desc->Version;
+  }
+
   DescRecord= ((MADB_DescRecord *)Desc->Records.buffer) + RecordNumber;
 
   return DescRecord;
@@ -864,9 +871,11 @@ SQLRETURN MADB_DescSetField(SQLHDESC DescriptorHandle,
     return SQL_SUCCESS;
   case SQL_DESC_BIND_TYPE:
     Desc->Header.BindType= (SQLINTEGER)(SQLLEN)ValuePtr;
+    ++Desc->Version;
     return SQL_SUCCESS;
   case SQL_DESC_COUNT:
     Desc->Header.Count= (SQLSMALLINT)(SQLLEN)ValuePtr;
+    ++Desc->Version;
     return SQL_SUCCESS;
   case SQL_DESC_ROWS_PROCESSED_PTR:
     Desc->Header.RowsProcessedPtr= (SQLULEN *)ValuePtr;
@@ -981,6 +990,7 @@ SQLRETURN MADB_DescCopyDesc(MADB_Desc *SrcDesc, MADB_Desc *DestDesc)
   /* We don't copy AppType from Src to Dest. If we copy internal descriptor to the explicit/external, it stays explicit/external */
 
   DestDesc->DescType= SrcDesc->DescType;
+  ++DestDesc->Version;
   memcpy(&DestDesc->Error, &SrcDesc->Error, sizeof(MADB_Error));
 
   /* Since we never allocate pointers we can just copy content */
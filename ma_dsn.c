@@ -88,6 +88,18 @@ MADB_DsnKey DsnKeys[]=
   { "CONNECTCFGFILE", offsetof(MADB_Dsn, ConnectCfgFile),   DSN_TYPE_STRING, 0, 0 },
   /*Add DB server connect whole url*/
   { "CONNECTURL",     offsetof(MADB_Dsn, ConnectUrl),       DSN_TYPE_STRING, 0, 0 },
+  /*Rows per COM_STMT_FETCH of server side cursor*/
+  { "PREFETCH_ROWS",  offsetof(MADB_Dsn, PrefetchRows),     DSN_TYPE_INT,    0, 0 },
+  /*Fetch next rowset of forward-only block cursor in background thread*/
+  { "PREFETCH_ROWSET", offsetof(MADB_Dsn, PrefetchRowset),  DSN_TYPE_BOOL,   0, 0 },
+  /*Memory budget of the connection's scrollable cursors, in megabytes*/
+  { "CURSOR_MEMORY_LIMIT", offsetof(MADB_Dsn, CursorMemoryLimit), DSN_TYPE_INT, 0, 0 },
+  /*Milliseconds dynamic cursor may scroll its result before re-reading it*/
+  { "DYNAMIC_CURSOR_REFRESH", offsetof(MADB_Dsn, DynCursorRefresh), DSN_TYPE_INT, 0, 0 },
+  /*Maximal number of threads converting large rowset*/
+  { "CONVERSION_THREADS", offsetof(MADB_Dsn, ConversionThreads), DSN_TYPE_INT, 0, 0 },
+  /*Size of prepared statements cache*/
+  { "PS_CACHE_SIZE", offsetof(MADB_Dsn, PsCacheSize), DSN_TYPE_INT, 0, 0 },
 
   /* Terminating Null */
   {NULL, 0, DSN_TYPE_BOOL,0,0}
@@ -150,6 +150,21 @@ typedef struct st_madb_dsn
   char    *Schema;
   char    *ConnectCfgFile;
   char    *ConnectUrl;
+
+  /* Number of rows to read at once via server side cursor for forward-only statements. 0 - no server side cursor */
+  unsigned int PrefetchRows;
+  /* Forward-only block cursor reads and converts next rowset in background, while application processes current one */
+  my_bool PrefetchRowset;
+  /* Megabytes of memory all scrollable cursors of the connection may use for their rows. The rest goes to temporary files. 0 - no limit */
+  unsigned int CursorMemoryLimit;
+  /* Milliseconds the result of dynamic cursor is scrolled without re-executing the query, unless data was changed via the
+     connection. 0 - the query is re-executed on every scroll */
+  unsigned int DynCursorRefresh;
+  /* Maximal number of threads converting values of large rowset fetched column-major(MADB_ATTR_COLUMN_MAJOR), including the
+     application's one. 0 or 1 - rowset is converted by the application's thread only */
+  unsigned int ConversionThreads;
+  /* Number of prepared statements handles connection keeps for re-use. 0 - statements are closed once re-prepared or dropped */
+  unsigned int PsCacheSize;
 } MADB_Dsn;
 
 /* this structure is used to store and retrieve DSN Information */
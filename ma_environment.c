@@ -44,6 +44,7 @@ SQLRETURN MADB_EnvFree(MADB_Env *Env)
 {
   if (!Env)
     return SQL_ERROR;
+  MADB_QCacheFree(Env);
   DeleteCriticalSection(&Env->cs);
   free(Env);
 
@@ -363,6 +363,8 @@ MYSQL_RES *MADB_GetDefaultColumnValues(MADB_Stmt *Stmt, MYSQL_FIELD *fields)
     goto error;
 
   LOCK_MARIADB(Stmt->Connection);
+  /* Rows are added to the positioned statement's result, which is stored rather than discarded, if it is being streamed */
+  MADB_StoreStreamer(Stmt->Connection, NULL);
   if (mysql_query(Stmt->Connection->mariadb, DynStr.str))
     goto error;
   result= mysql_store_result(Stmt->Connection->mariadb);
@@ -980,157 +982,22 @@ void MADB_NumericInit(SQL_NUMERIC_STRUCT *number, MADB_DescRecord *Ard)
 /* {{{ MADB_CharToSQLNumeric */
 int MADB_CharToSQLNumeric(char *buffer, MADB_Desc *Ard, MADB_DescRecord *ArdRecord, SQL_NUMERIC_STRUCT *dst_buffer, unsigned long RowNumber)
 {
-  char *p;
   SQL_NUMERIC_STRUCT *number= dst_buffer != NULL ? dst_buffer :
     (SQL_NUMERIC_STRUCT *)GetBindOffset(Ard, ArdRecord, ArdRecord->DataPtr, RowNumber, ArdRecord->OctetLength);
-  int ret= 0;
 
   if (!buffer || !number)
-    return ret;
+    return 0;
 
-  p= trim(buffer);
   MADB_NumericInit(number, ArdRecord);
 
-  if (!(number->sign= (*p=='-') ? 0 : 1))
-    p++;
-  if (!*p)
-    return FALSE;
-
   if (number->precision == 0)
   {
     number->precision= MADB_DEFAULT_PRECISION;
   }
 
-  while (*p=='0')
-  {
-    p++;
-  }
-  if (*p)
-  {
-    int i;
-    int bit, hval, tv, dig, sta, olen;
-    int tmp_digit= 0;
-    int leading_zeros= 0;
-    char *dot= strchr(p, '.');
-    char digits[100];
-    short digits_count= 0;
-
-    /* Overflow check */
-    if (number->precision > 0 && (dot - p) > number->precision)
-      return MADB_ERR_22003;
-    
-    if (dot && number->scale > 0)
-    {
-      short digits_total= 0, 
-            digits_significant= 0;
-      digits_count= (short)(dot - p);
-      memcpy(digits, p, digits_count);
-      p= dot + 1;
-      while (*p)
-      {
-        /* ignore non numbers */
-        if (!isdigit(0x000000ff & *p))
-          break;
-        digits_total++;
-        /* ignore trailing zeros */
-        if (*p != '0')
-        {
-          digits_significant= digits_total;
-        }
-        p++;
-      }
-
-      if (digits_count + number->scale > number->precision)
-      {
-        int i;
-        /* if digits are zero there is no overflow */
-        for (i=1; i <= digits_significant; i++)
-        {
-          p= dot + i;
-          if (*p != '0')
-            return MADB_ERR_22003;
-        }
-      }
-      
-      memcpy(digits + digits_count, dot + 1, digits_significant);
-      if (number->scale > digits_significant)
-      {
-        for (i= digits_count + digits_significant; i < number->precision && i < digits_count +number->scale; ++i)
-        {
-          digits[i]= '0';
-        }
-        digits_significant= number->scale;
-      }
-      digits_count+= digits_significant;
-    }
-    else 
-    {
-      char *start= p;
-      while (*p && isdigit(0x000000ff & *p))
-        p++;
-      /* check overflow */
-      if (p - start > number->precision)
-      {
-        return MADB_ERR_22003;
-      }
-      digits_count= (short)(p - start);
-      memcpy(digits, start, digits_count);
-      number->scale= ArdRecord->Scale ? ArdRecord->Scale : 0;
-    }
-
-    /* Rounding */
-    if (number->scale < 0)
-    {
-      int64_t OldVal, Val;
-      int64_t RoundNumber= (int64_t)pow(10.0, -number->scale);
-
-      digits[number->precision]= 0;
-      Val= _atoi64(digits);
-
-      OldVal= Val;
-      Val= (Val + RoundNumber / 2) / RoundNumber * RoundNumber;
-      if (OldVal != Val)
-        return MADB_ERR_22003;
-      _snprintf(digits, sizeof(digits), "%lld", Val);
-      digits_count= (short)strlen(digits);
-      if (digits_count > number->precision)
-        return MADB_ERR_22003;
-    }
-
-    digits_count= MIN(digits_count, MADB_DEFAULT_PRECISION);
-    for (hval = 0, bit = 1L, sta = 0, olen = 0; sta < digits_count;)
-    {
-      for (dig = 0, i = sta; i < digits_count; i++)
-      {
-        tv = dig * 10 + digits[i] - '0';
-        dig = tv % 2;
-        digits[i] = tv / 2 + '0';
-        if (i == sta && tv < 2)
-          sta++;
-      }
-      if (dig > 0)
-        hval |= bit;
-      bit <<= 1;
-      if (bit >= (1L << 8))
-      {
-        number->val[olen++] = hval;
-        hval = 0;
-        bit = 1L;
-        if (olen >= SQL_MAX_NUMERIC_LEN - 1)
-        {
-          //number->scale = sta - number->precision;
-          //ret= MADB_ERR_22003;
-          break;
-        }
-      } 
-    }
-    if (hval && olen < SQL_MAX_NUMERIC_LEN - 1)
-    {
-      number->val[olen++] = hval;
-    }
-  } 
-  return ret;
+  return MADB_StrToNumeric(buffer, number);
 }
+/* }}} */
 
 /* {{{ MADB_GetHexString */
 size_t MADB_GetHexString(char *BinaryBuffer, size_t BinaryLength,
@@ -1288,6 +1155,261 @@ BOOL MADB_IsIntType(SQLSMALLINT ConciseType)
   return FALSE;
 }
 
+/* {{{ MADB_NetFieldLength - reads length encoded integer, and moves the pointer past it */
+unsigned long long MADB_NetFieldLength(unsigned char **Ptr)
+{
+  unsigned char *Pos= *Ptr;
+
+  switch (*Pos)
+  {
+  case 252:
+    *Ptr+= 3;
+    return (unsigned long long)Pos[1] | ((unsigned long long)Pos[2] << 8);
+  case 253:
+    *Ptr+= 4;
+    return (unsigned long long)Pos[1] | ((unsigned long long)Pos[2] << 8) | ((unsigned long long)Pos[3] << 16);
+  case 254:
+  {
+    unsigned long long Value= 0;
+    int i;
+
+    for (i= 8; i > 0; --i)
+    {
+      Value= (Value << 8) | Pos[i];
+    }
+    *Ptr+= 9;
+    return Value;
+  }
+  default:
+    *Ptr+= 1;
+    return (unsigned long long)*Pos;
+  }
+}
+/* }}} */
+
+/* {{{ MADB_NetValueSize - returns number of bytes the value takes in binary protocol row, including its length */
+unsigned long MADB_NetValueSize(MYSQL_FIELD *Field, unsigned char *Ptr)
+{
+  unsigned char *Value= Ptr;
+
+  switch (Field->type)
+  {
+  case MYSQL_TYPE_NULL:
+    return 0;
+  case MYSQL_TYPE_TINY:
+    return 1;
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_YEAR:
+    return 2;
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_FLOAT:
+    return 4;
+  case MYSQL_TYPE_LONGLONG:
+  case MYSQL_TYPE_DOUBLE:
+    return 8;
+  default:
+  {
+    unsigned long long Length= MADB_NetFieldLength(&Value);
+    return (unsigned long)(Value - Ptr + Length);
+  }
+  }
+}
+/* }}} */
+
+/* {{{ MADB_NetRowLength - returns length of the binary protocol row, starting with its header byte */
+unsigned long MADB_NetRowLength(MYSQL_STMT *stmt, unsigned char *Row)
+{
+  unsigned char *NullPtr=   Row + 1,
+                *Ptr=       Row + 1 + (stmt->field_count + 9) / 8;
+  unsigned char  BitOffset= 4;
+  unsigned int   i;
+
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    if (!(*NullPtr & BitOffset))
+    {
+      Ptr+= MADB_NetValueSize(&stmt->fields[i], Ptr);
+    }
+    if (!((BitOffset<<= 1) & 255))
+    {
+      BitOffset= 1;
+      ++NullPtr;
+    }
+  }
+
+  return (unsigned long)(Ptr - Row);
+}
+/* }}} */
+
+/* {{{ MADB_MaxLengthField - SQL_ATTR_MAX_LENGTH applies to character and binary columns only */
+BOOL MADB_MaxLengthField(MYSQL_FIELD *Field)
+{
+  switch (Field->type)
+  {
+  case MYSQL_TYPE_VARCHAR:
+  case MYSQL_TYPE_VAR_STRING:
+  case MYSQL_TYPE_STRING:
+  case MYSQL_TYPE_TINY_BLOB:
+  case MYSQL_TYPE_MEDIUM_BLOB:
+  case MYSQL_TYPE_LONG_BLOB:
+  case MYSQL_TYPE_BLOB:
+  case MYSQL_TYPE_JSON:
+    return TRUE;
+  default:
+    return FALSE;
+  }
+}
+/* }}} */
+
+/* {{{ MADB_CutLength - returns length of the value cut to Limit bytes. Character value in utf8 is cut at the boundary of the
+       character, so that it does not end with incomplete sequence */
+unsigned long MADB_CutLength(const unsigned char *Value, unsigned long long Length, unsigned long Limit, BOOL Utf8)
+{
+  unsigned long Cut= Limit;
+
+  if (Length <= Limit)
+  {
+    return (unsigned long)Length;
+  }
+  if (Utf8)
+  {
+    /* Byte at Cut is not included. If it continues the sequence, the character started before the limit */
+    while (Cut > 0 && (Value[Cut] & 0xC0) == 0x80)
+    {
+      --Cut;
+    }
+  }
+  return Cut;
+}
+/* }}} */
+
+/* {{{ MADB_NetStoreLength - writes length encoded integer, and returns the position past it */
+unsigned char* MADB_NetStoreLength(unsigned char *Ptr, unsigned long long Length)
+{
+  int i;
+
+  if (Length < 251)
+  {
+    *Ptr++= (unsigned char)Length;
+    return Ptr;
+  }
+  if (Length < 65536)
+  {
+    *Ptr++= 252;
+    i= 2;
+  }
+  else if (Length < 16777216)
+  {
+    *Ptr++= 253;
+    i= 3;
+  }
+  else
+  {
+    *Ptr++= 254;
+    i= 8;
+  }
+  for (; i > 0; --i, Length>>= 8)
+  {
+    *Ptr++= (unsigned char)Length;
+  }
+
+  return Ptr;
+}
+/* }}} */
+
+/* {{{ MADB_CutNetField - returns length encoded value cut to Limit bytes. The row the value is in is never changed - longer
+       value is copied into the arena with the new length. Returns NULL if memory could not be allocated */
+unsigned char* MADB_CutNetField(MADB_Arena *Arena, unsigned char *Ptr, unsigned long Limit, BOOL Utf8)
+{
+  unsigned char     *Value=  Ptr, *Copy;
+  unsigned long long Length= MADB_NetFieldLength(&Value);
+  unsigned long      Cut;
+
+  if (Length <= Limit)
+  {
+    return Ptr;
+  }
+  Cut= MADB_CutLength(Value, Length, Limit, Utf8);
+
+  /* 9 bytes is the widest length */
+  if (!(Copy= (unsigned char *)MADB_ArenaAlloc(Arena, Cut + 9)))
+  {
+    return NULL;
+  }
+  memcpy(MADB_NetStoreLength(Copy, Cut), Value, Cut);
+
+  return Copy;
+}
+/* }}} */
+
+/* Data of the arena block follows its header, aligned for any type */
+#define MADB_ARENA_ALIGN(Size)  (((Size) + 15) & ~(size_t)15)
+#define MADB_ARENA_HEADER       MADB_ARENA_ALIGN(sizeof(MADB_ArenaBlock))
+#define MADB_ARENA_DATA(Block)  ((char *)(Block) + MADB_ARENA_HEADER)
+#define MADB_ARENA_MIN_BLOCK    4096
+
+/* {{{ MADB_ArenaAlloc - returns uninitialized buffer, that stays valid until the arena is reset or freed */
+void *MADB_ArenaAlloc(MADB_Arena *Arena, size_t Size)
+{
+  void *Result;
+
+  Size= MADB_ARENA_ALIGN(Size);
+
+  if (Arena->Block == NULL || Arena->Block->Size - Arena->Used < Size)
+  {
+    MADB_ArenaBlock *Block;
+    size_t           BlockSize= Arena->Block != NULL ? Arena->Block->Size * 2 : MADB_ARENA_MIN_BLOCK;
+
+    BlockSize= MAX(BlockSize, Size);
+
+    if ((Block= (MADB_ArenaBlock *)MADB_ALLOC(MADB_ARENA_HEADER + BlockSize)) == NULL)
+    {
+      return NULL;
+    }
+    Block->Prev=  Arena->Block;
+    Block->Size=  BlockSize;
+    Arena->Block= Block;
+    Arena->Used=  0;
+  }
+
+  Result= MADB_ARENA_DATA(Arena->Block) + Arena->Used;
+  Arena->Used+= Size;
+
+  return Result;
+}
+/* }}} */
+
+/* {{{ MADB_ArenaReset - releases all buffers. Only the last block is kept, it's the largest, and normally fits all
+       buffers needed between two resets */
+void MADB_ArenaReset(MADB_Arena *Arena)
+{
+  if (Arena->Block != NULL)
+  {
+    MADB_ArenaBlock *Prev= Arena->Block->Prev;
+
+    while (Prev != NULL)
+    {
+      MADB_ArenaBlock *Block= Prev;
+
+      Prev= Block->Prev;
+      MADB_FREE(Block);
+    }
+    Arena->Block->Prev= NULL;
+  }
+  Arena->Used= 0;
+}
+/* }}} */
+
+/* {{{ MADB_ArenaFree */
+void MADB_ArenaFree(MADB_Arena *Arena)
+{
+  MADB_ArenaReset(Arena);
+  MADB_FREE(Arena->Block);
+  Arena->Used= 0;
+}
+/* }}} */
+
 /* Now it's more like installing result */
 void MADB_InstallStmt(MADB_Stmt *Stmt, MYSQL_STMT *stmt)
 {
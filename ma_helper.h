@@ -71,6 +71,25 @@ BOOL          MADB_IsIntType    (SQLSMALLINT ConciseType);
 
 /* For multistatement picks stmt handler pointed by stored index, and sets it as "current" stmt handler */
 void          MADB_InstallStmt  (MADB_Stmt *Stmt, MYSQL_STMT *stmt);
+/* Reads length encoded integer of binary protocol row, and moves the pointer past it */
+unsigned long long MADB_NetFieldLength(unsigned char **Ptr);
+/* Size of the value in binary protocol row, including its length */
+unsigned long      MADB_NetValueSize(MYSQL_FIELD *Field, unsigned char *Ptr);
+/* Length of the whole binary protocol row, including its header byte */
+unsigned long      MADB_NetRowLength(MYSQL_STMT *stmt, unsigned char *Row);
+/* Cutting of character and binary values to SQL_ATTR_MAX_LENGTH in binary protocol row */
+BOOL               MADB_MaxLengthField(MYSQL_FIELD *Field);
+unsigned long      MADB_CutLength(const unsigned char *Value, unsigned long long Length, unsigned long Limit, BOOL Utf8);
+unsigned char*     MADB_CutNetField(MADB_Arena *Arena, unsigned char *Ptr, unsigned long Limit, BOOL Utf8);
+/* Writes length encoded integer, returns the position past it */
+unsigned char*     MADB_NetStoreLength(unsigned char *Ptr, unsigned long long Length);
+
+void *        MADB_ArenaAlloc(MADB_Arena *Arena, size_t Size);
+void          MADB_ArenaReset(MADB_Arena *Arena);
+void          MADB_ArenaFree (MADB_Arena *Arena);
+
+/* Platform specific, implemented in ma_platform_*.c. Milliseconds, not affected by system time changes */
+unsigned long long MADB_GetTickCount(void);
 
 /* for dummy binding */
 extern my_bool DummyError;
@@ -0,0 +1,616 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include <ma_odbc.h>
+
+
+/* {{{ MADB_KeysetGrow - makes sure the array has room for Required elements of Size bytes */
+static BOOL MADB_KeysetGrow(void **Array, size_t *Allocated, size_t Required, size_t Size)
+{
+  if (Required > *Allocated)
+  {
+    size_t Allocate= MAX(Required, *Allocated * 2);
+    void  *Grown;
+
+    if (Allocate > (size_t)-1 / Size || (Grown= MADB_REALLOC(*Array, Allocate * Size)) == NULL)
+    {
+      return FALSE;
+    }
+    *Array=     Grown;
+    *Allocated= Allocate;
+  }
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_KeysetKeyType - checks if the value of the field can be found by its literal */
+static BOOL MADB_KeysetKeyType(MYSQL_FIELD *Field)
+{
+  switch (Field->type)
+  {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_YEAR:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONGLONG:
+  case MYSQL_TYPE_DECIMAL:
+  case MYSQL_TYPE_NEWDECIMAL:
+  case MYSQL_TYPE_DATE:
+  case MYSQL_TYPE_DATETIME:
+  case MYSQL_TYPE_TIMESTAMP:
+  case MYSQL_TYPE_TIME:
+    return TRUE;
+  case MYSQL_TYPE_STRING:
+  case MYSQL_TYPE_VARCHAR:
+  case MYSQL_TYPE_VAR_STRING:
+    return !(Field->flags & BINARY_FLAG);
+  default:
+    return FALSE;
+  }
+}
+/* }}} */
+
+/* {{{ MADB_KeysetLe - reads little-endian integer of Width bytes */
+static unsigned long long MADB_KeysetLe(unsigned char *Ptr, unsigned int Width)
+{
+  unsigned long long Value= 0;
+
+  while (Width-- > 0)
+  {
+    Value= (Value << 8) | Ptr[Width];
+  }
+  return Value;
+}
+/* }}} */
+
+/* {{{ MADB_KeysetKey - appends raw values of key columns of the binary protocol row to the buffer */
+static BOOL MADB_KeysetKey(MADB_Keyset *Keyset, MYSQL_STMT *stmt, unsigned char *Row, unsigned char **Buffer,
+                           size_t *Length, size_t *Allocated)
+{
+  unsigned char *NullPtr=   Row + 1,
+                *Ptr=       Row + 1 + (stmt->field_count + 9) / 8;
+  unsigned char  BitOffset= 4;
+  unsigned int   i, k= 0;
+
+  for (i= 0; i < stmt->field_count && k < Keyset->KeyCount; ++i)
+  {
+    if (!(*NullPtr & BitOffset))
+    {
+      unsigned long Size= MADB_NetValueSize(&stmt->fields[i], Ptr);
+
+      if (i == Keyset->Key[k])
+      {
+        if (!MADB_KeysetGrow((void **)Buffer, Allocated, *Length + Size, 1))
+        {
+          return FALSE;
+        }
+        memcpy(*Buffer + *Length, Ptr, Size);
+        *Length+= Size;
+      }
+      Ptr+= Size;
+    }
+    if (i == Keyset->Key[k])
+    {
+      ++k;
+    }
+    if (!((BitOffset<<= 1) & 255))
+    {
+      BitOffset= 1;
+      ++NullPtr;
+    }
+  }
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_KeysetHash - FNV-1a hash of the key */
+static unsigned long MADB_KeysetHash(unsigned char *Key, size_t Length)
+{
+  unsigned long Hash= 2166136261UL;
+
+  while (Length-- > 0)
+  {
+    Hash= ((Hash ^ *Key++) * 16777619UL) & 0xFFFFFFFFUL;
+  }
+  return Hash;
+}
+/* }}} */
+
+/* {{{ MADB_KeysetAppendValue - appends the raw binary protocol value of the field to the query as SQL literal */
+static my_bool MADB_KeysetAppendValue(MADB_Keyset *Keyset, MYSQL_FIELD *Field, unsigned char *Ptr)
+{
+  char          Buffer[64];
+  char         *Value=  Buffer;
+  unsigned long Length= 0;
+
+  switch (Field->type)
+  {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_YEAR:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONGLONG:
+  {
+    unsigned int       Width=  MADB_NetValueSize(Field, Ptr);
+    unsigned long long Number= MADB_KeysetLe(Ptr, Width);
+
+    if (Field->flags & UNSIGNED_FLAG)
+    {
+      Length= _snprintf(Buffer, sizeof(Buffer), "%llu", Number);
+    }
+    else
+    {
+      /* Extending the sign */
+      if (Width < 8 && (Number & (1ULL << (Width * 8 - 1))))
+      {
+        Number|= ~0ULL << (Width * 8);
+      }
+      Length= _snprintf(Buffer, sizeof(Buffer), "%lld", (long long)Number);
+    }
+    break;
+  }
+  case MYSQL_TYPE_DATE:
+  case MYSQL_TYPE_DATETIME:
+  case MYSQL_TYPE_TIMESTAMP:
+  {
+    unsigned long long Size= MADB_NetFieldLength(&Ptr);
+
+    Length= _snprintf(Buffer, sizeof(Buffer), "%04u-%02u-%02u", Size >= 4 ? (unsigned int)MADB_KeysetLe(Ptr, 2) : 0,
+                      Size >= 4 ? Ptr[2] : 0, Size >= 4 ? Ptr[3] : 0);
+    if (Field->type != MYSQL_TYPE_DATE)
+    {
+      Length+= _snprintf(Buffer + Length, sizeof(Buffer) - Length, " %02u:%02u:%02u", Size >= 7 ? Ptr[4] : 0,
+                         Size >= 7 ? Ptr[5] : 0, Size >= 7 ? Ptr[6] : 0);
+      if (Size >= 11)
+      {
+        Length+= _snprintf(Buffer + Length, sizeof(Buffer) - Length, ".%06lu", (unsigned long)MADB_KeysetLe(Ptr + 7, 4));
+      }
+    }
+    break;
+  }
+  case MYSQL_TYPE_TIME:
+  {
+    unsigned long long Size= MADB_NetFieldLength(&Ptr);
+
+    if (Size >= 8)
+    {
+      Length= _snprintf(Buffer, sizeof(Buffer), "%s%02lu:%02u:%02u", Ptr[0] ? "-" : "",
+                        (unsigned long)MADB_KeysetLe(Ptr + 1, 4) * 24 + Ptr[5], Ptr[6], Ptr[7]);
+      if (Size >= 12)
+      {
+        Length+= _snprintf(Buffer + Length, sizeof(Buffer) - Length, ".%06lu", (unsigned long)MADB_KeysetLe(Ptr + 8, 4));
+      }
+    }
+    else
+    {
+      Length= _snprintf(Buffer, sizeof(Buffer), "00:00:00");
+    }
+    break;
+  }
+  default:
+    /* Decimal and string values are sent as strings */
+    Length= (unsigned long)MADB_NetFieldLength(&Ptr);
+    Value=  (char *)Ptr;
+  }
+
+  return MADB_DynStrAppendLiteral(Keyset->Stmt->Connection->mariadb, &Keyset->Query, Field, Value, Length);
+}
+/* }}} */
+
+/* {{{ MADB_KeysetAppendKey - appends key of the row to the query, as the tuple for the composite key */
+static my_bool MADB_KeysetAppendKey(MADB_Keyset *Keyset, size_t Row)
+{
+  unsigned char *Ptr= Keyset->Keys + Keyset->Offset[Row];
+  unsigned int   k;
+
+  if (Keyset->KeyCount > 1 && MADB_DynstrAppend(&Keyset->Query, "("))
+  {
+    return TRUE;
+  }
+  for (k= 0; k < Keyset->KeyCount; ++k)
+  {
+    MYSQL_FIELD *Field= &Keyset->Stmt->stmt->fields[Keyset->Key[k]];
+
+    if ((k > 0 && MADB_DynstrAppend(&Keyset->Query, ", ")) ||
+        MADB_KeysetAppendValue(Keyset, Field, Ptr))
+    {
+      return TRUE;
+    }
+    Ptr+= MADB_NetValueSize(Field, Ptr);
+  }
+
+  return Keyset->KeyCount > 1 && MADB_DynstrAppend(&Keyset->Query, ")");
+}
+/* }}} */
+
+/* {{{ MADB_KeysetSameFields - checks if rows of the 2nd handle can be returned as rows of the 1st one */
+static BOOL MADB_KeysetSameFields(MYSQL_STMT *stmt, MYSQL_STMT *Other)
+{
+  unsigned int i;
+
+  if (stmt->field_count != Other->field_count)
+  {
+    return FALSE;
+  }
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    if (stmt->fields[i].type != Other->fields[i].type ||
+        (stmt->fields[i].flags & UNSIGNED_FLAG) != (Other->fields[i].flags & UNSIGNED_FLAG))
+    {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_KeysetLoad - MADB_SpillLoad of the keyset-driven cursor. Re-reads rows of the window by their keys, and puts
+       them in the order of the keyset. Rows, that are not found, get the row of NULLs, and are marked as deleted */
+static BOOL MADB_KeysetLoad(MADB_Spill *Spill, unsigned long long First, unsigned long Count)
+{
+  MADB_Keyset  *Keyset= (MADB_Keyset *)Spill->Source;
+  MADB_Stmt    *Stmt=   Spill->Stmt;
+  MADB_Dbc     *Dbc=    Stmt->Connection;
+  MYSQL_ROWS   *Row;
+  unsigned long i, Mask= 1;
+  int           rc;
+
+  /* Hash of keys is at most half full */
+  while (Mask < 2 * Count)
+  {
+    Mask<<= 1;
+  }
+  if (!MADB_KeysetGrow((void **)&Keyset->Deleted, &Keyset->DeletedAllocated, Count, sizeof(char)) ||
+      !MADB_KeysetGrow((void **)&Keyset->Slot, &Keyset->SlotAllocated, Mask, sizeof(unsigned long)))
+  {
+    MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+    return FALSE;
+  }
+  memset(Keyset->Slot, 0, Mask * sizeof(unsigned long));
+  --Mask;
+
+  Keyset->Query.length= Keyset->QueryLength;
+  for (i= 0; i < Count; ++i)
+  {
+    size_t        Nr=   (size_t)First + i;
+    unsigned long Slot= MADB_KeysetHash(Keyset->Keys + Keyset->Offset[Nr], Keyset->Offset[Nr + 1] - Keyset->Offset[Nr]) & Mask;
+
+    if ((i > 0 && MADB_DynstrAppend(&Keyset->Query, ", ")) || MADB_KeysetAppendKey(Keyset, Nr))
+    {
+      MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+      return FALSE;
+    }
+    while (Keyset->Slot[Slot] != 0)
+    {
+      Slot= (Slot + 1) & Mask;
+    }
+    Keyset->Slot[Slot]=    i + 1;
+    Keyset->Deleted[i]=    1;
+    Spill->Window[i].data=   (MYSQL_ROW)Keyset->NullRow;
+    Spill->Window[i].length= Keyset->NullRowLength;
+  }
+  if (MADB_DynstrAppend(&Keyset->Query, ")"))
+  {
+    MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+    return FALSE;
+  }
+
+  LOCK_MARIADB(Dbc);
+  /* Rows of the statement, being streamed, have to be read before the query is sent */
+  MADB_StoreStreamer(Dbc, NULL);
+  if (Keyset->Handle == NULL && (Keyset->Handle= mysql_stmt_init(Dbc->mariadb)) == NULL)
+  {
+    UNLOCK_MARIADB(Dbc);
+    MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+    return FALSE;
+  }
+  MDBUG_C_PRINT(Dbc, "Re-reading rows %llu-%llu of keyset: %s", First, First + Count - 1, Keyset->Query.str);
+  rc= mysql_stmt_prepare(Keyset->Handle, Keyset->Query.str, (unsigned long)Keyset->Query.length) ||
+      mysql_stmt_execute(Keyset->Handle) || mysql_stmt_store_result(Keyset->Handle);
+  UNLOCK_MARIADB(Dbc);
+
+  if (rc)
+  {
+    MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Keyset->Handle);
+    return FALSE;
+  }
+  if (!MADB_KeysetSameFields(Stmt->stmt, Keyset->Handle))
+  {
+    MADB_SetError(&Stmt->Error, MADB_ERR_HY000, "Rows of keyset-driven cursor could not be re-read", 0);
+    return FALSE;
+  }
+
+  for (Row= Keyset->Handle->result.data; Row != NULL; Row= Row->next)
+  {
+    size_t        Length= 0;
+    unsigned long Slot;
+
+    if (!MADB_KeysetKey(Keyset, Keyset->Handle, (unsigned char *)Row->data, &Keyset->Scratch, &Length,
+                        &Keyset->ScratchAllocated))
+    {
+      MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+      return FALSE;
+    }
+    for (Slot= MADB_KeysetHash(Keyset->Scratch, Length) & Mask; Keyset->Slot[Slot] != 0; Slot= (Slot + 1) & Mask)
+    {
+      size_t Nr= (size_t)First + Keyset->Slot[Slot] - 1;
+
+      if (Keyset->Offset[Nr + 1] - Keyset->Offset[Nr] == Length &&
+          memcmp(Keyset->Keys + Keyset->Offset[Nr], Keyset->Scratch, Length) == 0)
+      {
+        i= Keyset->Slot[Slot] - 1;
+        Spill->Window[i].data=   Row->data;
+        Spill->Window[i].length= Row->length;
+        Keyset->Deleted[i]=      0;
+        break;
+      }
+    }
+  }
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_KeysetInit - finds out, if the keyset can be built for the result of the prepared statement. Has to be called
+       before the statement is executed, since nothing can be sent to the server, while the result is read */
+MADB_Keyset* MADB_KeysetInit(MADB_Stmt *Stmt)
+{
+  MYSQL_STMT   *stmt=   Stmt->stmt;
+  MYSQL_FIELD  *Fields= stmt->fields;
+  MADB_Keyset  *Keyset;
+  unsigned int  i, KeyFlag, Primary= 0, Unique= 0;
+  BOOL          UniqueNotNull= TRUE;
+
+  if (stmt->state < MYSQL_STMT_PREPARED || stmt->field_count == 0 || Fields == NULL)
+  {
+    return NULL;
+  }
+
+  /* Rows are re-read from the table by names of their columns */
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    if (Fields[i].org_table == NULL || Fields[i].org_table[0] == '\0' || strcmp(Fields[i].org_table, Fields[0].org_table) ||
+        Fields[i].org_name == NULL || Fields[i].org_name[0] == '\0' ||
+        strcmp(Fields[i].db != NULL ? Fields[i].db : "", Fields[0].db != NULL ? Fields[0].db : ""))
+    {
+      return NULL;
+    }
+    if (Fields[i].flags & PRI_KEY_FLAG)
+    {
+      ++Primary;
+    }
+    if (Fields[i].flags & UNIQUE_KEY_FLAG)
+    {
+      ++Unique;
+      UniqueNotNull= UniqueNotNull && (Fields[i].flags & NOT_NULL_FLAG);
+    }
+  }
+
+  /* All columns of the key have to be in the result, the same way MADB_DynStrGetWhere needs them */
+  if (Primary > 0 && Primary == (unsigned int)MADB_KeyTypeCount(Stmt->Connection, Fields[0].org_table, PRI_KEY_FLAG))
+  {
+    KeyFlag= PRI_KEY_FLAG;
+  }
+  else if (Unique > 0 && UniqueNotNull &&
+           Unique == (unsigned int)MADB_KeyTypeCount(Stmt->Connection, Fields[0].org_table, UNIQUE_KEY_FLAG))
+  {
+    KeyFlag= UNIQUE_KEY_FLAG;
+  }
+  else
+  {
+    return NULL;
+  }
+
+  if ((Keyset= (MADB_Keyset *)MADB_CALLOC(sizeof(MADB_Keyset))) == NULL ||
+      (Keyset->Key= (unsigned int *)MADB_CALLOC(sizeof(unsigned int) * stmt->field_count)) == NULL ||
+      !MADB_KeysetGrow((void **)&Keyset->Offset, &Keyset->OffsetAllocated, 1, sizeof(size_t)) ||
+      MADB_InitDynamicString(&Keyset->Query, "SELECT ", 1024, 1024))
+  {
+    MADB_KeysetFree(Keyset);
+    return NULL;
+  }
+  Keyset->Stmt=       Stmt;
+  Keyset->FieldCount= stmt->field_count;
+  Keyset->Offset[0]=  0;
+
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    if (Fields[i].flags & KeyFlag)
+    {
+      if (!MADB_KeysetKeyType(&Fields[i]))
+      {
+        MADB_KeysetFree(Keyset);
+        return NULL;
+      }
+      Keyset->Key[Keyset->KeyCount++]= i;
+    }
+    if ((i > 0 && MADB_DynstrAppend(&Keyset->Query, ", ")) || MADB_DynStrAppendQuoted(&Keyset->Query, Fields[i].org_name))
+    {
+      MADB_KeysetFree(Keyset);
+      return NULL;
+    }
+  }
+
+  if (MADB_DynstrAppend(&Keyset->Query, " FROM ") ||
+      (Fields[0].db != NULL && Fields[0].db[0] != '\0' &&
+       (MADB_DynStrAppendQuoted(&Keyset->Query, Fields[0].db) || MADB_DynstrAppend(&Keyset->Query, "."))) ||
+      MADB_DynStrAppendQuoted(&Keyset->Query, Fields[0].org_table) ||
+      MADB_DynstrAppend(&Keyset->Query, Keyset->KeyCount > 1 ? " WHERE (" : " WHERE "))
+  {
+    MADB_KeysetFree(Keyset);
+    return NULL;
+  }
+  for (i= 0; i < Keyset->KeyCount; ++i)
+  {
+    if ((i > 0 && MADB_DynstrAppend(&Keyset->Query, ", ")) ||
+        MADB_DynStrAppendQuoted(&Keyset->Query, Fields[Keyset->Key[i]].org_name))
+    {
+      MADB_KeysetFree(Keyset);
+      return NULL;
+    }
+  }
+  if (MADB_DynstrAppend(&Keyset->Query, Keyset->KeyCount > 1 ? ") IN (" : " IN ("))
+  {
+    MADB_KeysetFree(Keyset);
+    return NULL;
+  }
+  Keyset->QueryLength= Keyset->Query.length;
+
+  return Keyset;
+}
+/* }}} */
+
+/* {{{ MADB_KeysetBuild - reads the result keeping keys of rows only, and installs rows into the statement's handle to be
+       re-read on demand. Keyset is taken over. If it is NULL, or does not fit the result, the result is stored for static
+       cursor, and 01S02 is returned. Has to be called inside the lock */
+SQLRETURN MADB_KeysetBuild(MADB_Stmt *Stmt, MADB_Keyset **KeysetPtr)
+{
+  MADB_Keyset  *Keyset= *KeysetPtr;
+  MYSQL_STMT   *stmt=   Stmt->stmt;
+  char         *SavedFlag= NULL;
+  unsigned int  ServerStatus, i;
+  int           rc;
+  SQLRETURN     ret=    SQL_SUCCESS;
+
+  *KeysetPtr= NULL;
+  mariadb_get_infov(Stmt->Connection->mariadb, MARIADB_CONNECTION_SERVER_STATUS, (void*)&ServerStatus);
+
+  if (Keyset != NULL && (stmt->state != MYSQL_STMT_WAITING_USE_OR_STORE || (ServerStatus & SERVER_STATUS_CURSOR_EXISTS) ||
+                         stmt->field_count != Keyset->FieldCount ||
+                         (stmt->bind != NULL && (SavedFlag= (char *)MADB_CALLOC(stmt->field_count)) == NULL)))
+  {
+    MADB_KeysetFree(Keyset);
+    Keyset= NULL;
+  }
+  if (Keyset == NULL)
+  {
+    if (!SQL_SUCCEEDED(MADB_StoreResult(Stmt)))
+    {
+      return Stmt->Error.ReturnValue;
+    }
+    Stmt->Options.CursorType= SQL_CURSOR_STATIC;
+    return MADB_SetError(&Stmt->Error, MADB_ERR_01S02, "Cursor type changed to SQL_CURSOR_STATIC", 0);
+  }
+
+  /* We need raw rows - C/C does not need to convert them into application's buffers */
+  if (stmt->bind != NULL)
+  {
+    for (i= 0; i < stmt->field_count; ++i)
+    {
+      SavedFlag[i]= stmt->bind[i].flags & MADB_BIND_DUMMY;
+      stmt->bind[i].flags|= MADB_BIND_DUMMY;
+    }
+  }
+
+  while ((rc= mysql_stmt_fetch(stmt)) == 0 || rc == MYSQL_DATA_TRUNCATED)
+  {
+    /* Unbuffered fetch leaves the row packet in the connection's buffer */
+    if (!MADB_KeysetGrow((void **)&Keyset->Offset, &Keyset->OffsetAllocated, Keyset->Rows + 2, sizeof(size_t)) ||
+        !MADB_KeysetKey(Keyset, stmt, stmt->mysql->net.read_pos, &Keyset->Keys, &Keyset->KeysLength, &Keyset->KeysAllocated))
+    {
+      ret= MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+      break;
+    }
+    Keyset->Offset[++Keyset->Rows]= Keyset->KeysLength;
+  }
+
+  if (rc == 1)
+  {
+    ret= MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, stmt);
+  }
+  else if (ret == SQL_ERROR)
+  {
+    /* Rest of the result still has to be read from the connection */
+    while ((rc= mysql_stmt_fetch(stmt)) == 0 || rc == MYSQL_DATA_TRUNCATED);
+  }
+
+  if (stmt->bind != NULL)
+  {
+    for (i= 0; i < stmt->field_count; ++i)
+    {
+      stmt->bind[i].flags&= (~MADB_BIND_DUMMY | SavedFlag[i]);
+    }
+  }
+  MADB_FREE(SavedFlag);
+
+  /* Header byte, and all bits of NULL bitmap set, starting from the 3rd one */
+  Keyset->NullRowLength= 1 + (stmt->field_count + 9) / 8;
+  if (ret != SQL_ERROR && (Keyset->NullRow= (unsigned char *)MADB_CALLOC(Keyset->NullRowLength)) == NULL)
+  {
+    ret= MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+  }
+  if (ret == SQL_ERROR)
+  {
+    MADB_KeysetFree(Keyset);
+    return ret;
+  }
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    Keyset->NullRow[1 + (i + 2) / 8]|= (unsigned char)(1 << ((i + 2) % 8));
+  }
+
+  MDBUG_C_PRINT(Stmt->Connection, "Keyset of %0x: %lu rows, %lu bytes of keys", stmt, (unsigned long)Keyset->Rows,
+                (unsigned long)Keyset->KeysLength);
+
+  return MADB_SpillOnDemand(Stmt, Keyset->Rows, MADB_KeysetLoad, Keyset, MADB_KeysetFree);
+}
+/* }}} */
+
+/* {{{ MADB_KeysetRowDeleted - checks if the row of the keyset-driven cursor has not been found, when it was re-read */
+BOOL MADB_KeysetRowDeleted(MADB_Stmt *Stmt, unsigned long long Position)
+{
+  MADB_Spill *Spill= Stmt->Spill;
+
+  if (Spill == NULL || Spill->Load != MADB_KeysetLoad || Position < Spill->WindowStart ||
+      Position >= Spill->WindowStart + Spill->WindowRows)
+  {
+    return FALSE;
+  }
+  return ((MADB_Keyset *)Spill->Source)->Deleted[Position - Spill->WindowStart] != 0;
+}
+/* }}} */
+
+/* {{{ MADB_KeysetFree */
+void MADB_KeysetFree(void *Source)
+{
+  MADB_Keyset *Keyset= (MADB_Keyset *)Source;
+
+  if (Keyset == NULL)
+  {
+    return;
+  }
+  if (Keyset->Handle != NULL)
+  {
+    LOCK_MARIADB(Keyset->Stmt->Connection);
+    MADB_StoreStreamer(Keyset->Stmt->Connection, NULL);
+    mysql_stmt_close(Keyset->Handle);
+    UNLOCK_MARIADB(Keyset->Stmt->Connection);
+  }
+  MADB_DynstrFree(&Keyset->Query);
+  MADB_FREE(Keyset->Key);
+  MADB_FREE(Keyset->Keys);
+  MADB_FREE(Keyset->Offset);
+  MADB_FREE(Keyset->NullRow);
+  MADB_FREE(Keyset->Scratch);
+  MADB_FREE(Keyset->Deleted);
+  MADB_FREE(Keyset->Slot);
+  MADB_FREE(Keyset);
+}
+/* }}} */
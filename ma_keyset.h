@@ -0,0 +1,59 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+/* Keyset-driven cursor. While the result is read, only raw values of its key columns - of the primary key, or of the unique
+ * one, which columns are not nullable - are kept for each row. Rows are put into the window of the result(see ma_spill.h)
+ * by batches of at least the rowset size, re-read from the table with "SELECT ... WHERE <key> IN (...)". Thus the cursor
+ * takes memory for keys only, and returns rows as they are when the batch is re-read. Rows, that are not found anymore,
+ * have been deleted. If the result is not of a single table, or does not have all columns of such key, the cursor is static */
+
+#ifndef _ma_keyset_h_
+#define _ma_keyset_h_
+
+typedef struct st_ma_keyset
+{
+  MADB_Stmt      *Stmt;
+  MYSQL_STMT     *Handle;       /* Re-reads rows of the window */
+  MADB_DynString  Query;        /* "SELECT <columns> FROM <table> WHERE <key> IN (", keys of the batch are appended to */
+  size_t          QueryLength;
+  unsigned int    FieldCount;
+  unsigned int   *Key;          /* Numbers of key columns, ascending */
+  unsigned int    KeyCount;
+  unsigned char  *Keys;         /* Raw values of key columns of all rows, one after another */
+  size_t          KeysLength;
+  size_t          KeysAllocated;
+  size_t         *Offset;       /* Offset of the row's key in Keys. There is one more, than rows */
+  size_t          OffsetAllocated;
+  size_t          Rows;
+  unsigned char  *NullRow;      /* Row of NULLs, deleted rows get */
+  unsigned long   NullRowLength;
+  unsigned char  *Scratch;      /* Key of the re-read row */
+  size_t          ScratchAllocated;
+  char           *Deleted;      /* Flags of the window's rows */
+  size_t          DeletedAllocated;
+  unsigned long  *Slot;         /* Hash of the window's keys. Slot is the row number in the window + 1, 0 - free */
+  size_t          SlotAllocated;
+} MADB_Keyset;
+
+MADB_Keyset* MADB_KeysetInit      (MADB_Stmt *Stmt);
+SQLRETURN    MADB_KeysetBuild     (MADB_Stmt *Stmt, MADB_Keyset **Keyset);
+BOOL         MADB_KeysetRowDeleted(MADB_Stmt *Stmt, unsigned long long Position);
+void         MADB_KeysetFree      (void *Keyset);
+
+#endif
@@ -35,6 +35,13 @@
 
 #include <sql.h>
 #include <sqlext.h>
+/* Bases of driver specific statement and connection attributes, older headers do not have them */
+#ifndef SQL_DRIVER_STMT_ATTR_BASE
+# define SQL_DRIVER_STMT_ATTR_BASE 0x00004000
+#endif
+#ifndef SQL_DRIVER_CONN_ATTR_BASE
+# define SQL_DRIVER_CONN_ATTR_BASE 0x00004000
+#endif
 #include <odbcinst.h>
 
 #include <errmsg.h>
@@ -203,6 +210,7 @@ typedef struct
   MADB_Header Header;
   SQLINTEGER DescType;  /* SQL_ATTR_APP_ROW_DESC or SQL_ATTR_APP_PARAM_DESC */
   my_bool AppType;      /* Allocated by Application ? */
+  unsigned int Version; /* Changes with every change of records or bind type. Fetch plan built for other version is not valid */
   MADB_DynArray Records;
   MADB_DynArray Stmts;
   MADB_Error Error;
@@ -239,6 +247,7 @@ typedef struct
   SQLSMALLINT BookmarkType;
   SQLULEN	MetadataId;
   SQLULEN SimulateCursor;
+  SQLUINTEGER ColumnMajor;  /* MADB_ATTR_COLUMN_MAJOR */
 } MADB_StmtOptions;
 
 /* TODO: To check is it 0 or 1 based? not quite clear from its usage */
@@ -248,8 +257,21 @@ typedef struct
   SQLLEN           Position;
   SQLLEN           RowsetSize;
   MYSQL_ROW_OFFSET Next;
+  unsigned long long Refreshed;  /* Time the result of dynamic cursor was read, and connection's Changes at that time */
+  unsigned int     Changes;
 } MADB_Cursor;
 
+/* Pointers to the rows of the stored result, built on the first seek, so the cursor is positioned without walking the
+   rows list */
+typedef struct
+{
+  MYSQL_ROWS         **Rows;
+  MYSQL_STMT         *Handle;   /* C/C statement handle and its rows list the index was built for */
+  MYSQL_ROWS         *Data;
+  unsigned long long Count;
+  unsigned long long Allocated;
+} MADB_RowIndex;
+
 enum MADB_DaeType {MADB_DAE_NORMAL=0, MADB_DAE_ADD=1, MADB_DAE_UPDATE=2, MADB_DAE_DELETE=3};
 
 #define RESET_DAE_STATUS(Stmt_Hndl) (Stmt_Hndl)->Status=0; (Stmt_Hndl)->PutParam= -1
@@ -282,6 +304,20 @@ typedef struct
 
 } MADB_BulkOperationInfo;
 
+/* Bump allocator for temporary buffers, that are needed until the next fetch. Blocks grow geometrically, and on reset
+   all but the last(largest) one are freed */
+typedef struct st_ma_arena_block
+{
+  struct st_ma_arena_block *Prev;
+  size_t                    Size;
+} MADB_ArenaBlock;
+
+typedef struct
+{
+  MADB_ArenaBlock *Block;
+  size_t           Used;
+} MADB_Arena;
+
 /* Stmt struct needs definitions from my_parse.h */
 #include <ma_parse.h>
 
@@ -318,13 +354,22 @@ struct st_ma_odbc_stmt
   int                       PutParam;
   my_bool                   RebindParams;
   my_bool                   bind_done;
+  my_bool                   PsCacheable; /* Handle is prepared with STMT_STRING, and can be kept in connection's cache */
   long long                 AffectedRows;
   unsigned long             *CharOffset;
   unsigned long             *Lengths;
+  unsigned long             *ColumnLengths;  /* Lengths of values of the current row, looked up by MADB_ColumnLength, plus 1 */
+  unsigned long             ResultMaxLength; /* SQL_ATTR_MAX_LENGTH at the moment the current result has been produced */
   char                      *TableName;
   char                      *CatalogName;
   MADB_ShortTypeInfo        *ColsTypeFixArr;
   MADB_BulkOperationInfo    Bulk;
+  struct st_ma_prefetch     *Prefetch;
+  struct st_ma_spill        *Spill;
+  struct st_ma_arrow_stream *ArrowStream;
+  struct st_ma_fetch_plan   *FetchPlan;
+  MADB_Arena                Scratch;  /* SQLGetData conversion buffers */
+  MADB_RowIndex             RowIndex;
   /* Application Descriptors */
   MADB_Desc *Apd;
   MADB_Desc *Ard;
@@ -345,6 +390,7 @@ typedef struct st_ma_odbc_environment {
   SQLWCHAR *TraceFile;
   SQLINTEGER OdbcVersion;
   SQLINTEGER OutputNTS;
+  struct st_ma_qcache *QueryCache; /* parsed long queries, shared by all connections */
 } MADB_Env;
 
 
@@ -375,6 +421,11 @@ struct st_ma_odbc_connection
   MADB_List ListItem;
   MADB_List *Stmts;
   MADB_List *Descrs;
+  MADB_Stmt *Streamer;           /* forward-only statement, which result is currently being read unbuffered from the connection */
+  size_t CursorMemory;           /* memory used by rows of statements' results stored by MADB_StoreResult */
+  unsigned int Changes;          /* counter of statements, that could change data. Dynamic cursors re-read results once it changes */
+  struct st_ma_ps_cache *PsCache; /* prepared handles of statements, that have been re-prepared or dropped */
+  struct st_ma_fix_pool *FixPool; /* threads converting large rowsets column-major, started on first use */
   /* Attributes */
   SQLINTEGER AccessMode;
   my_bool IsAnsi;
@@ -451,6 +502,14 @@ void            CloseClientCharset(Client_Charset *cc);
 #include <ma_server.h>
 #include <ma_typeconv.h>
 #include <ma_bulk.h>
+#include <ma_prefetch.h>
+#include <ma_spill.h>
+#include <ma_keyset.h>
+#include <ma_arrow.h>
+#include <ma_pscache.h>
+#include <ma_qcache.h>
+#include <ma_unicode.h>
+#include <ma_datetime.h>
 
 /* SQLFunction calls inside MariaDB Connector/ODBC needs to be mapped,
  * on non Windows platforms these function calls will call the driver
@@ -25,6 +25,8 @@
 
 #include <ma_odbc.h>
 #include <stdarg.h>
+#include <sys/mman.h>
+#include <time.h>
 
 extern MARIADB_CHARSET_INFO *DmUnicodeCs;
 extern Client_Charset utf8;
@@ -158,6 +160,19 @@ SQLWCHAR *MADB_ConvertToWchar(const char *Ptr, SQLLEN PtrLength, Client_Charset*
   if (!cc || !cc->CodePage)
     cc= &utf8;
 
+  if (MADB_IS_UTF8(cc->cs_info))
+  {
+    BOOL Truncated;
+
+    /* Number of units is not bigger than number of bytes */
+    Length= PtrLength < 0 ? strlen(Ptr) : (size_t)PtrLength;
+    if ((WStr= (SQLWCHAR *)MADB_CALLOC(sizeof(SQLWCHAR) * (Length + 1))))
+    {
+      MADB_Utf8ToWchar(Ptr, Length, WStr, (SQLLEN)Length + 1, TRUE, &Truncated);
+    }
+    return WStr;
+  }
+
   Length+= MbstrOctetLen(Ptr, &PtrLength, cc->cs_info);
 
   if ((WStr= (SQLWCHAR *)MADB_CALLOC(sizeof(SQLWCHAR) * (PtrLength + 1))))
@@ -193,6 +208,22 @@ char *MADB_ConvertFromWChar(const SQLWCHAR *Ptr, SQLINTEGER PtrLength, SQLULEN *
     cc= &utf8;
   }
 
+  if (MADB_IS_UTF8(cc->cs_info))
+  {
+    size_t Units= PtrLength < 0 ? (size_t)SqlwcsLen((SQLWCHAR *)Ptr, -1) : (size_t)PtrLength;
+
+    if (!(AscStr= (char *)MADB_CALLOC(Units * MADB_UTF8_PER_WCHAR + 1)))
+      return NULL;
+
+    AscLen= MADB_WcharToUtf8(Ptr, Units, AscStr, Error);
+    AscStr[AscLen]= '\0';
+
+    if (Length)
+      *Length= (SQLINTEGER)AscLen;
+
+    return AscStr;
+  }
+
   if (PtrLength == SQL_NTS)
   {
     /*-1 - to calculate length as of nts */
@@ -268,6 +299,24 @@ int MADB_ConvertAnsi2Unicode(Client_Charset *cc, const char *AnsiString, SQLLEN
     AnsiLength= strlen(AnsiString);
   }
 
+  if (MADB_IS_UTF8(cc->cs_info))
+  {
+    BOOL   Truncated;
+    SQLLEN Length= MADB_Utf8ToWchar(AnsiString, AnsiLength, UnicodeString, UnicodeLength, IsNull, &Truncated);
+
+    /* As well as the generic conversion, truncated string is always null terminated */
+    if (Truncated && !IsNull)
+    {
+      MADB_Utf8ToWchar(AnsiString, AnsiLength, UnicodeString, UnicodeLength, TRUE, &Truncated);
+    }
+    if (LengthIndicator)
+      *LengthIndicator= Length;
+    if (Truncated && UnicodeLength > 0 && Error)
+      MADB_SetError(Error, MADB_ERR_01004, NULL, 0);
+
+    return 0;
+  }
+
   /* calculate required length */
   RequiredLength= MbstrCharLen(AnsiString, AnsiLength, cc->cs_info) + IsNull;
 
@@ -402,3 +451,44 @@ const char* MADB_GetDefaultPluginsDir(MADB_Dbc *Dbc)
 {
   return NULL;
 }
+
+
+/* {{{ MADB_GetTickCount */
+unsigned long long MADB_GetTickCount(void)
+{
+  struct timespec Now;
+
+  clock_gettime(CLOCK_MONOTONIC, &Now);
+
+  return (unsigned long long)Now.tv_sec * 1000 + Now.tv_nsec / 1000000;
+}
+/* }}} */
+
+/* {{{ MADB_OpenTmpFile - creates temporary file, that is removed when closed */
+FILE* MADB_OpenTmpFile(void)
+{
+  return tmpfile();
+}
+/* }}} */
+
+/* {{{ MADB_MapTmpFile - maps Size first bytes of the temporary file for reading */
+char* MADB_MapTmpFile(FILE *File, size_t Size)
+{
+  void *Map;
+
+  if (fflush(File) != 0)
+  {
+    return NULL;
+  }
+  Map= mmap(NULL, Size, PROT_READ, MAP_SHARED, fileno(File), 0);
+
+  return Map == MAP_FAILED ? NULL : (char *)Map;
+}
+/* }}} */
+
+/* {{{ MADB_UnmapTmpFile */
+void MADB_UnmapTmpFile(char *Map, size_t Size)
+{
+  munmap(Map, Size);
+}
+/* }}} */
@@ -81,5 +81,20 @@ int strcpy_s(char *dest, size_t buffer_size, const char *src);
 
 void InitializeCriticalSection(CRITICAL_SECTION *cs);
 
+/* Threads. MADB_ThreadCreate returns 0 on success */
+#define MADB_THREAD                         pthread_t
+#define MADB_THREAD_FUNC(FuncName, ArgName) void* FuncName(void *ArgName)
+#define MADB_THREAD_RETURN                  return NULL
+
+#define MADB_ThreadCreate(Thread, Func, Arg) pthread_create(&(Thread), NULL, (Func), (Arg))
+#define MADB_ThreadJoin(Thread)              pthread_join((Thread), NULL)
+
+/* Condition variables, waited for with CRITICAL_SECTION locked once */
+#define MADB_COND                            pthread_cond_t
+#define MADB_CondInit(Cond)                  pthread_cond_init((Cond), NULL)
+#define MADB_CondWait(Cond, cs)              pthread_cond_wait((Cond), (cs))
+#define MADB_CondBroadcast(Cond)             pthread_cond_broadcast((Cond))
+#define MADB_CondDestroy(Cond)               pthread_cond_destroy((Cond))
+
 #endif /*_ma_platform_x_h_ */
 
@@ -25,6 +25,8 @@
 
 #include <ma_odbc.h>
 #include "Shlwapi.h"
+#include <io.h>
+#include <fcntl.h>
 
 extern Client_Charset utf8;
 char LogFile[256];
@@ -323,3 +325,74 @@ BOOL MADB_DSN_PossibleConnect(MADB_Dsn *Dsn)
 }
 /* }}} */
 
+
+
+/* {{{ MADB_GetTickCount */
+unsigned long long MADB_GetTickCount(void)
+{
+  return GetTickCount64();
+}
+/* }}} */
+
+/* {{{ MADB_OpenTmpFile - creates temporary file, that is removed when closed. tmpfile() would create it in the root
+       directory, where user may have no rights to write */
+FILE* MADB_OpenTmpFile(void)
+{
+  char   Path[MAX_PATH], Name[MAX_PATH];
+  HANDLE Handle;
+  int    Fd;
+  FILE  *File;
+
+  if (GetTempPathA(sizeof(Path), Path) == 0 || GetTempFileNameA(Path, "MAO", 0, Name) == 0)
+  {
+    return NULL;
+  }
+  Handle= CreateFileA(Name, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                      FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+  if (Handle == INVALID_HANDLE_VALUE)
+  {
+    DeleteFileA(Name);
+    return NULL;
+  }
+  if ((Fd= _open_osfhandle((intptr_t)Handle, _O_RDWR | _O_BINARY)) == -1)
+  {
+    CloseHandle(Handle);
+    return NULL;
+  }
+  if ((File= _fdopen(Fd, "w+b")) == NULL)
+  {
+    _close(Fd);
+  }
+  return File;
+}
+/* }}} */
+
+/* {{{ MADB_MapTmpFile - maps Size first bytes of the temporary file for reading */
+char* MADB_MapTmpFile(FILE *File, size_t Size)
+{
+  HANDLE Mapping;
+  void  *Map;
+
+  if (fflush(File) != 0)
+  {
+    return NULL;
+  }
+  Mapping= CreateFileMapping((HANDLE)_get_osfhandle(_fileno(File)), NULL, PAGE_READONLY, 0, 0, NULL);
+  if (Mapping == NULL)
+  {
+    return NULL;
+  }
+  Map= MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, Size);
+  /* The view keeps the mapping object open */
+  CloseHandle(Mapping);
+
+  return (char *)Map;
+}
+/* }}} */
+
+/* {{{ MADB_UnmapTmpFile */
+void MADB_UnmapTmpFile(char *Map, size_t Size)
+{
+  UnmapViewOfFile(Map);
+}
+/* }}} */
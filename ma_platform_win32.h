@@ -36,6 +36,7 @@
 #include <windows.h>
 #include <WinSock2.h>
 #include <shlwapi.h>
+#include <process.h>
 
 #if !defined(HAVE_mit_thread) && !defined(HAVE_STRTOK_R)
 #define strtok_r(A,B,C) strtok((A),(B))
@@ -44,6 +45,21 @@
 
 #define MADB_DRIVER_NAME "maodbc.dll"
 
+/* Threads. MADB_ThreadCreate returns 0 on success */
+#define MADB_THREAD                         HANDLE
+#define MADB_THREAD_FUNC(FuncName, ArgName) unsigned __stdcall FuncName(void *ArgName)
+#define MADB_THREAD_RETURN                  return 0
+
+#define MADB_ThreadCreate(Thread, Func, Arg) (((Thread)= (HANDLE)_beginthreadex(NULL, 0, (Func), (Arg), 0, NULL)) == NULL)
+#define MADB_ThreadJoin(Thread)              (WaitForSingleObject((Thread), INFINITE), CloseHandle((Thread)))
+
+/* Condition variables, waited for with CRITICAL_SECTION locked once */
+#define MADB_COND                            CONDITION_VARIABLE
+#define MADB_CondInit(Cond)                  InitializeConditionVariable((Cond))
+#define MADB_CondWait(Cond, cs)              SleepConditionVariableCS((Cond), (cs), INFINITE)
+#define MADB_CondBroadcast(Cond)             WakeAllConditionVariable((Cond))
+#define MADB_CondDestroy(Cond)
+
 char *strndup(const char *s, size_t n);
 char* strcasestr(const char* HayStack, const char* Needle);
 
@@ -0,0 +1,738 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+/* Background prefetch of the next rowset of forward-only block cursor.
+ *
+ * Worker thread reads raw rows of the rowset from the connection, and then runs regular fetch over them on the copy of
+ * the statement("shadow"), that has its own error, IRD, per column arrays, and ARD, which columns are bound column-wise
+ * to driver's buffers. Application's ARD is never touched by the worker. Next SQLFetch joins the worker, and copies
+ * converted values to the application's buffers, or, if the application has changed binding meanwhile, converts raw rows
+ * again. Application's thread does not touch the statement's connection handle, while the worker is running - every
+ * path, that communicates with the server, goes via MADB_StoreStreamer, which waits for the worker. Last row of the
+ * current rowset is kept as well, so SQLGetData can read it after the worker has read past it */
+
+#include <ma_odbc.h>
+
+
+/* {{{ MADB_PrefetchFetchRow - C/C's fetch_row_func, reading rows of the list instead of the connection */
+static int MADB_PrefetchFetchRow(MYSQL_STMT *stmt, unsigned char **Row)
+{
+  MYSQL_ROWS *Current= stmt->result_cursor;
+
+  if (Current == NULL || Current->data == NULL)
+  {
+    *Row= NULL;
+    return Current != NULL ? (int)Current->length : MYSQL_NO_DATA;
+  }
+
+  stmt->state=         MYSQL_STMT_USER_FETCHING;
+  *Row=                (unsigned char *)Current->data;
+  stmt->result_cursor= Current->next;
+
+  return 0;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchPointRow - reads next row without conversion, so C/C only points to its values */
+static SQLRETURN MADB_PrefetchPointRow(MADB_Stmt *Stmt)
+{
+  MYSQL_STMT   *stmt=      Stmt->stmt;
+  char         *SavedFlag= Stmt->Prefetch->SavedFlag;
+  unsigned int  i;
+  int           rc;
+
+  if (stmt->bind == NULL || SavedFlag == NULL || Stmt->Prefetch->FieldCount != stmt->field_count)
+  {
+    return SQL_ERROR;
+  }
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    SavedFlag[i]= stmt->bind[i].flags & MADB_BIND_DUMMY;
+    stmt->bind[i].flags|= MADB_BIND_DUMMY;
+  }
+
+  rc= mysql_stmt_fetch(stmt);
+
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    stmt->bind[i].flags&= (~MADB_BIND_DUMMY | SavedFlag[i]);
+  }
+
+  return rc == 0 ? SQL_SUCCESS : SQL_ERROR;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchReplay - makes C/C read rows of the list, starting from Row, instead of the connection, and fetches them
+       with the statement by Fetch. If Fetch is NULL, C/C is only pointed to values of the Row, as SQLGetData needs. Afterwards C/C
+       reads from where it has been reading before */
+static SQLRETURN MADB_PrefetchReplay(MADB_Stmt *Stmt, MYSQL_ROWS *Row, SQLRETURN (*Fetch)(MADB_Stmt *Stmt))
+{
+  MYSQL_STMT                *stmt=     Stmt->stmt;
+  mysql_stmt_fetch_row_func  FetchRow= stmt->fetch_row_func;
+  MYSQL_ROWS                *Cursor=   stmt->result_cursor;
+  enum mysql_stmt_state      State=    stmt->state;
+  SQLRETURN                  Result;
+
+  stmt->fetch_row_func= MADB_PrefetchFetchRow;
+  stmt->result_cursor=  Row;
+  stmt->state=          MYSQL_STMT_USER_FETCHING;
+
+  if (Fetch == NULL)
+  {
+    Result= MADB_PrefetchPointRow(Stmt);
+    /* Kept row is not cut. Copies of cut values live till the next fetch */
+    if (SQL_SUCCEEDED(Result) && Stmt->ResultMaxLength > 0 && MADB_CutFetchedRow(Stmt, &Stmt->Scratch))
+    {
+      Result= SQL_ERROR;
+    }
+  }
+  else
+  {
+    Result= Fetch(Stmt);
+  }
+
+  stmt->fetch_row_func= FetchRow;
+  stmt->result_cursor=  Cursor;
+  /* If the list has ended with the end of the result, it stays ended */
+  if (stmt->state != MYSQL_STMT_FETCH_DONE)
+  {
+    stmt->state= State;
+  }
+
+  return Result;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchAddRow - appends the copy of the row to the list. Row NULL appends the entry, that ends the list with rc */
+static BOOL MADB_PrefetchAddRow(MADB_PrefetchRows *Rows, MYSQL_STMT *stmt, unsigned char *Row, int rc)
+{
+  unsigned long  Length= Row != NULL ? MADB_NetRowLength(stmt, Row) : 0;
+  MYSQL_ROWS    *Entry=  (MYSQL_ROWS *)MADB_ArenaAlloc(&Rows->Arena, sizeof(MYSQL_ROWS) + Length);
+
+  if (Entry == NULL)
+  {
+    return FALSE;
+  }
+
+  Entry->next= NULL;
+  if (Row != NULL)
+  {
+    Entry->data=   (MYSQL_ROW)(Entry + 1);
+    Entry->length= Length;
+    memcpy(Entry->data, Row, Length);
+  }
+  else
+  {
+    Entry->data=   NULL;
+    Entry->length= (unsigned long)rc;
+  }
+
+  if (Rows->First == NULL)
+  {
+    Rows->First= Entry;
+  }
+  else
+  {
+    /* Only the ending entry can follow the last row with data */
+    Rows->Last->next= Entry;
+  }
+  if (Row != NULL)
+  {
+    Rows->Last= Entry;
+  }
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchReadRows - reads rows of the rowset from the connection. They are copied, since C/C reads every row into
+       the same network buffer. Returns FALSE, if memory could not be allocated */
+static BOOL MADB_PrefetchReadRows(MADB_Prefetch *Prefetch, MADB_PrefetchRows *Rows)
+{
+  MYSQL_STMT    *stmt= Prefetch->Shadow.stmt;
+  unsigned char *Row;
+  SQLULEN        i;
+  int            rc;
+
+  MADB_ArenaReset(&Rows->Arena);
+  Rows->First= Rows->Last= NULL;
+
+  for (i= 0; i < Prefetch->ArraySize; ++i)
+  {
+    /* Same as mysql_stmt_fetch does, except the conversion of the row */
+    if ((rc= stmt->fetch_row_func(stmt, &Row)) != 0)
+    {
+      /* The connection is not used by the result anymore. The thread, that owns the statement, releases it */
+      Prefetch->Finished= TRUE;
+      return MADB_PrefetchAddRow(Rows, stmt, NULL, rc);
+    }
+    if (!MADB_PrefetchAddRow(Rows, stmt, Row, 0))
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchWorker */
+static MADB_THREAD_FUNC(MADB_PrefetchWorker, Arg)
+{
+  MADB_Prefetch     *Prefetch= (MADB_Prefetch *)Arg;
+  MADB_PrefetchRows *Rows=     &Prefetch->Rows[!Prefetch->Current];
+
+  if (MADB_PrefetchReadRows(Prefetch, Rows))
+  {
+    Prefetch->Result= MADB_PrefetchReplay(&Prefetch->Shadow, Rows->First, MADB_StmtFetchBound);
+  }
+  else
+  {
+    Prefetch->Result= MADB_SetError(&Prefetch->Shadow.Error, MADB_ERR_HY001, NULL, 0);
+  }
+
+  MADB_THREAD_RETURN;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchKeepRow - copies the row of the unbuffered result, C/C has been pointed to by the last fetch, so SQLGetData
+       can read it, once the worker has read past it. Returns FALSE, if that is not possible */
+static BOOL MADB_PrefetchKeepRow(MADB_Stmt *Stmt, MADB_PrefetchRows *Rows)
+{
+  MYSQL_STMT *stmt= Stmt->stmt;
+
+  /* Rows of other kinds of results are not in the network buffer */
+  if (stmt->result_cursor != NULL || stmt->result.data != NULL)
+  {
+    return FALSE;
+  }
+
+  MADB_ArenaReset(&Rows->Arena);
+  Rows->First= Rows->Last= NULL;
+
+  return MADB_PrefetchAddRow(Rows, stmt, stmt->mysql->net.read_pos, 0);
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchShadowArrays - gives the shadow its own per column arrays and IRD records, which the fetch writes to.
+       Application's thread uses statement's ones meanwhile */
+static BOOL MADB_PrefetchShadowArrays(MADB_Stmt *Stmt, MADB_Prefetch *Prefetch)
+{
+  unsigned int     FieldCount= mysql_stmt_field_count(Stmt->stmt), i;
+  size_t           Size=       Stmt->Ird->Records.elements * sizeof(MADB_DescRecord);
+  MADB_DescRecord *Records;
+
+  if (Prefetch->FieldCount != FieldCount)
+  {
+    MADB_FREE(Prefetch->Bind);
+    MADB_FREE(Prefetch->CharOffset);
+    MADB_FREE(Prefetch->Lengths);
+    MADB_FREE(Prefetch->SavedFlag);
+    Prefetch->FieldCount= FieldCount;
+  }
+  if ((Prefetch->Bind == NULL && !(Prefetch->Bind= (MYSQL_BIND *)MADB_CALLOC(sizeof(MYSQL_BIND) * FieldCount))) ||
+      (Prefetch->CharOffset == NULL && !(Prefetch->CharOffset= (unsigned long *)MADB_CALLOC(sizeof(unsigned long) * FieldCount))) ||
+      (Prefetch->Lengths == NULL && !(Prefetch->Lengths= (unsigned long *)MADB_CALLOC(sizeof(unsigned long) * FieldCount))) ||
+      (Prefetch->SavedFlag == NULL && !(Prefetch->SavedFlag= (char *)MADB_CALLOC(MAX(FieldCount, 1)))))
+  {
+    return FALSE;
+  }
+
+  /* Conversion buffers of records are freed by the fetch */
+  if (Prefetch->IrdRecords != NULL)
+  {
+    ResetDescIntBuffers(&Prefetch->Ird);
+  }
+  if (!(Records= (MADB_DescRecord *)MADB_REALLOC(Prefetch->IrdRecords, MAX(Size, sizeof(MADB_DescRecord)))))
+  {
+    return FALSE;
+  }
+  Prefetch->IrdRecords= Records;
+
+  memcpy(&Prefetch->Ird, Stmt->Ird, sizeof(MADB_Desc));
+  memcpy(Records, Stmt->Ird->Records.buffer, Size);
+  for (i= 0; i < Stmt->Ird->Records.elements; ++i)
+  {
+    Records[i].InternalBuffer= NULL;
+  }
+  Prefetch->Ird.Records.buffer=      (char *)Records;
+  Prefetch->Ird.Records.max_element= Prefetch->Ird.Records.elements;
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchFreeBuffers */
+static void MADB_PrefetchFreeBuffers(MADB_Prefetch *Prefetch)
+{
+  SQLSMALLINT i;
+
+  for (i= 0; i < Prefetch->ColumnCount; ++i)
+  {
+    if (Prefetch->Data != NULL)
+    {
+      MADB_FREE(Prefetch->Data[i]);
+    }
+    if (Prefetch->Length != NULL)
+    {
+      MADB_FREE(Prefetch->Length[i]);
+    }
+    if (Prefetch->Indicator != NULL)
+    {
+      MADB_FREE(Prefetch->Indicator[i]);
+    }
+  }
+  MADB_FREE(Prefetch->Data);
+  MADB_FREE(Prefetch->Length);
+  MADB_FREE(Prefetch->Indicator);
+  MADB_FREE(Prefetch->RowStatus);
+  Prefetch->ColumnCount= 0;
+
+  if (Prefetch->Ard != NULL)
+  {
+    ResetDescIntBuffers(Prefetch->Ard);
+  }
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchBindBuffers - binds columns of the shadow ARD to driver's buffers */
+static BOOL MADB_PrefetchBindBuffers(MADB_Stmt *Stmt, MADB_Prefetch *Prefetch)
+{
+  MADB_DescRecord *Rec;
+  SQLSMALLINT      i;
+
+  if (Prefetch->Ard == NULL && !(Prefetch->Ard= MADB_DescInit(Stmt->Connection, MADB_DESC_ARD, FALSE)))
+  {
+    return FALSE;
+  }
+  if (MADB_DescCopyDesc(Stmt->Ard, Prefetch->Ard) != SQL_SUCCESS)
+  {
+    return FALSE;
+  }
+
+  Prefetch->Ard->Header.BindType=         SQL_BIND_BY_COLUMN;
+  Prefetch->Ard->Header.BindOffsetPtr=    NULL;
+  Prefetch->Ard->Header.ArrayStatusPtr=   NULL;
+  Prefetch->Ard->Header.RowsProcessedPtr= NULL;
+
+  Prefetch->ColumnCount= MADB_STMT_COLUMN_COUNT(Stmt);
+  Prefetch->ArraySize=   Stmt->Ard->Header.ArraySize;
+
+  if (!(Prefetch->Data=      (char **)MADB_CALLOC(sizeof(char *) * Prefetch->ColumnCount)) ||
+      !(Prefetch->Length=    (SQLLEN **)MADB_CALLOC(sizeof(SQLLEN *) * Prefetch->ColumnCount)) ||
+      !(Prefetch->Indicator= (SQLLEN **)MADB_CALLOC(sizeof(SQLLEN *) * Prefetch->ColumnCount)) ||
+      !(Prefetch->RowStatus= (SQLUSMALLINT *)MADB_CALLOC(sizeof(SQLUSMALLINT) * Prefetch->ArraySize)))
+  {
+    return FALSE;
+  }
+
+  for (i= 0; i < Prefetch->ColumnCount; ++i)
+  {
+    Rec= MADB_DescGetInternalRecord(Prefetch->Ard, i, MADB_DESC_READ);
+
+    if (Rec == NULL || !Rec->inUse)
+    {
+      continue;
+    }
+    if (Rec->DataPtr != NULL)
+    {
+      if (!(Prefetch->Data[i]= (char *)MADB_CALLOC(MAX(Rec->OctetLength, 1) * Prefetch->ArraySize)))
+      {
+        return FALSE;
+      }
+      Rec->DataPtr= Prefetch->Data[i];
+    }
+    if (Rec->OctetLengthPtr != NULL)
+    {
+      if (!(Prefetch->Length[i]= (SQLLEN *)MADB_CALLOC(sizeof(SQLLEN) * Prefetch->ArraySize)))
+      {
+        return FALSE;
+      }
+    }
+    if (Rec->IndicatorPtr != NULL)
+    {
+      if (Rec->IndicatorPtr == Rec->OctetLengthPtr)
+      {
+        Rec->IndicatorPtr= Prefetch->Length[i];
+      }
+      else if (!(Prefetch->Indicator[i]= (SQLLEN *)MADB_CALLOC(sizeof(SQLLEN) * Prefetch->ArraySize)))
+      {
+        return FALSE;
+      }
+      else
+      {
+        Rec->IndicatorPtr= Prefetch->Indicator[i];
+      }
+    }
+    Rec->OctetLengthPtr= Prefetch->Length[i];
+  }
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchBindingChanged - checks if the application has changed columns binding after the rowset was prefetched.
+       Buffers addresses may change - values are copied to current ones */
+static BOOL MADB_PrefetchBindingChanged(MADB_Stmt *Stmt, MADB_Prefetch *Prefetch)
+{
+  MADB_DescRecord *ArdRec, *ShadowRec;
+  SQLSMALLINT      i;
+
+  if (Stmt->Ard->Header.ArraySize != Prefetch->ArraySize || MADB_STMT_COLUMN_COUNT(Stmt) != Prefetch->ColumnCount)
+  {
+    return TRUE;
+  }
+
+  for (i= 0; i < Prefetch->ColumnCount; ++i)
+  {
+    ArdRec=    MADB_DescGetInternalRecord(Stmt->Ard, i, MADB_DESC_READ);
+    ShadowRec= MADB_DescGetInternalRecord(Prefetch->Ard, i, MADB_DESC_READ);
+
+    if ((ArdRec == NULL || !ArdRec->inUse) && (ShadowRec == NULL || !ShadowRec->inUse))
+    {
+      continue;
+    }
+    if (ArdRec == NULL || ShadowRec == NULL || ArdRec->inUse != ShadowRec->inUse
+      || ArdRec->ConciseType != ShadowRec->ConciseType || ArdRec->OctetLength != ShadowRec->OctetLength
+      || (ArdRec->DataPtr == NULL) != (Prefetch->Data[i] == NULL)
+      || (ArdRec->OctetLengthPtr == NULL) != (Prefetch->Length[i] == NULL)
+      || (ArdRec->IndicatorPtr == NULL) != (ShadowRec->IndicatorPtr == NULL)
+      || (ArdRec->IndicatorPtr == ArdRec->OctetLengthPtr) != (ShadowRec->IndicatorPtr == ShadowRec->OctetLengthPtr))
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchCopyLength - how many bytes of the value have to be copied to the application's buffer */
+static size_t MADB_PrefetchCopyLength(MADB_DescRecord *ArdRec, SQLLEN *Length)
+{
+  SQLLEN Terminator= 0;
+
+  if (Length == NULL || *Length < 0)
+  {
+    return (size_t)ArdRec->OctetLength;
+  }
+
+  switch (ArdRec->ConciseType)
+  {
+  case SQL_C_CHAR:
+    Terminator= 1;
+    break;
+  case SQL_C_WCHAR:
+    Terminator= sizeof(SQLWCHAR);
+    break;
+  case SQL_C_BINARY:
+    break;
+  default:
+    return (size_t)ArdRec->OctetLength;
+  }
+
+  return (size_t)MIN(*Length + Terminator, ArdRec->OctetLength);
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchNext - starts the worker, if the application reads the result in the way, allowing to fetch next rowset
+       in advance. Taken tells, if the current rowset has been prefetched, and its rows are kept already */
+static void MADB_PrefetchNext(MADB_Stmt *Stmt, SQLRETURN FetchResult, BOOL Taken)
+{
+  MADB_Prefetch  *Prefetch;
+  MADB_FetchPlan *ShadowPlan;
+
+  /* Rows, the worker has read, are being converted again */
+  if (Stmt->stmt->fetch_row_func == MADB_PrefetchFetchRow)
+  {
+    return;
+  }
+  if (!MADB_PREFETCH_POSSIBLE(Stmt) || !SQL_SUCCEEDED(FetchResult) ||
+      (SQLULEN)Stmt->LastRowFetched < Stmt->Ard->Header.ArraySize)
+  {
+    return;
+  }
+
+  if (Stmt->Prefetch == NULL && !(Stmt->Prefetch= (MADB_Prefetch *)MADB_CALLOC(sizeof(MADB_Prefetch))))
+  {
+    return;
+  }
+  Prefetch= Stmt->Prefetch;
+
+  /* 1st rowset tells nothing about how the application reads the result - if it uses SQLGetData, there is no need to
+     keep its row */
+  if (Prefetch->Disabled || ++Prefetch->Rowsets < 2)
+  {
+    return;
+  }
+
+  if (!Taken && !MADB_PrefetchKeepRow(Stmt, &Prefetch->Rows[Prefetch->Current]))
+  {
+    return;
+  }
+
+  MADB_PrefetchFreeBuffers(Prefetch);
+  if (!MADB_PrefetchBindBuffers(Stmt, Prefetch) || !MADB_PrefetchShadowArrays(Stmt, Prefetch))
+  {
+    MDBUG_C_PRINT(Stmt->Connection, "Could not allocate buffers to prefetch rowset of %0x", Stmt);
+    MADB_PrefetchFreeBuffers(Prefetch);
+    return;
+  }
+
+  /* Shadow has its own fetch plan, that stays with it between rowsets */
+  ShadowPlan= Prefetch->Shadow.FetchPlan;
+  memcpy(&Prefetch->Shadow, Stmt, sizeof(MADB_Stmt));
+
+  Prefetch->Ird.Header.ArrayStatusPtr=   Prefetch->RowStatus;
+  Prefetch->Ird.Header.RowsProcessedPtr= &Prefetch->RowsProcessed;
+
+  Prefetch->Shadow.Prefetch=   NULL;
+  Prefetch->Shadow.ArrowStream= NULL;
+  Prefetch->Shadow.FetchPlan=  ShadowPlan;
+  Prefetch->Shadow.result=     Prefetch->Bind;
+  Prefetch->Shadow.CharOffset= Prefetch->CharOffset;
+  Prefetch->Shadow.Lengths=    Prefetch->Lengths;
+  Prefetch->Shadow.ColumnLengths= NULL;
+  memset(&Prefetch->Shadow.Scratch, 0, sizeof(MADB_Arena));
+  memset(&Prefetch->Shadow.RowIndex, 0, sizeof(MADB_RowIndex));
+  Prefetch->Shadow.Ard=        Prefetch->Ard;
+  Prefetch->Shadow.Ird=        &Prefetch->Ird;
+  Prefetch->Shadow.Cursor.Position+= Stmt->LastRowFetched;
+  MADB_CLEAR_ERROR(&Prefetch->Shadow.Error);
+
+  /* The worker does not bind the handle, it shares with this thread */
+  if (!SQL_SUCCEEDED(MADB_StmtBindRowset(&Prefetch->Shadow)))
+  {
+    MDBUG_C_PRINT(Stmt->Connection, "Could not bind columns to prefetch rowset of %0x", Stmt);
+    MADB_PrefetchFreeBuffers(Prefetch);
+    return;
+  }
+
+  Prefetch->Pending=  TRUE;
+  Prefetch->Finished= FALSE;
+  if (MADB_ThreadCreate(Prefetch->Worker, MADB_PrefetchWorker, Prefetch))
+  {
+    MDBUG_C_PRINT(Stmt->Connection, "Could not start thread to prefetch rowset of %0x", Stmt);
+    Prefetch->Pending=  FALSE;
+    Prefetch->Disabled= TRUE;
+    return;
+  }
+  Prefetch->Running= TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchStart - called once the rowset has been fetched */
+void MADB_PrefetchStart(MADB_Stmt *Stmt, SQLRETURN FetchResult)
+{
+  MADB_PrefetchNext(Stmt, FetchResult, FALSE);
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchWait - waits for the worker. Prefetched rowset stays pending. If the worker has read the result to its
+       end, the statement does not stream from the connection anymore */
+void MADB_PrefetchWait(MADB_Stmt *Stmt)
+{
+  if (Stmt->Prefetch != NULL && Stmt->Prefetch->Running)
+  {
+    MADB_ThreadJoin(Stmt->Prefetch->Worker);
+    Stmt->Prefetch->Running= FALSE;
+
+    if (Stmt->Prefetch->Finished)
+    {
+      LOCK_MARIADB(Stmt->Connection);
+      if (Stmt->Connection->Streamer == Stmt)
+      {
+        Stmt->Connection->Streamer= NULL;
+      }
+      UNLOCK_MARIADB(Stmt->Connection);
+    }
+  }
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchTake - copies prefetched rowset to the application's buffers, and starts prefetch of the next one */
+SQLRETURN MADB_PrefetchTake(MADB_Stmt *Stmt)
+{
+  MADB_Prefetch   *Prefetch= Stmt->Prefetch;
+  MADB_DescRecord *ArdRec, *ShadowRec;
+  SQLULEN          Row, Rows;
+  SQLSMALLINT      i;
+  SQLRETURN        Result;
+  BOOL             RowRestored= Prefetch->RowRestored;
+
+  MADB_PrefetchWait(Stmt);
+  Prefetch->Pending=     FALSE;
+  Prefetch->RowRestored= FALSE;
+  Prefetch->Current=     !Prefetch->Current;
+
+  /* Converted values do not fit the new binding, and rows the worker has read are converted again */
+  if (MADB_PrefetchBindingChanged(Stmt, Prefetch))
+  {
+    Result= MADB_PrefetchReplay(Stmt, Prefetch->Rows[Prefetch->Current].First, Stmt->Methods->Fetch);
+    MADB_PrefetchNext(Stmt, Result, TRUE);
+
+    return Result;
+  }
+
+  /* SQLGetData has pointed C/C back to the previous rowset. Now it has to read the last row of this one */
+  if (RowRestored && Prefetch->Rows[Prefetch->Current].Last != NULL)
+  {
+    MADB_PrefetchReplay(Stmt, Prefetch->Rows[Prefetch->Current].Last, NULL);
+  }
+
+  Rows= (SQLULEN)Prefetch->Shadow.LastRowFetched;
+
+  for (i= 0; i < Prefetch->ColumnCount; ++i)
+  {
+    ArdRec=    MADB_DescGetInternalRecord(Stmt->Ard, i, MADB_DESC_READ);
+    ShadowRec= MADB_DescGetInternalRecord(Prefetch->Ard, i, MADB_DESC_READ);
+
+    if (ArdRec == NULL || !ArdRec->inUse)
+    {
+      continue;
+    }
+
+    for (Row= 0; Row < Rows; ++Row)
+    {
+      SQLLEN *Length=       (SQLLEN *)GetBindOffset(Prefetch->Ard, ShadowRec, ShadowRec->OctetLengthPtr, Row, sizeof(SQLLEN)),
+             *Indicator=    (SQLLEN *)GetBindOffset(Prefetch->Ard, ShadowRec, ShadowRec->IndicatorPtr, Row, sizeof(SQLLEN)),
+             *AppLength=    (SQLLEN *)GetBindOffset(Stmt->Ard, ArdRec, ArdRec->OctetLengthPtr, Row, sizeof(SQLLEN)),
+             *AppIndicator= (SQLLEN *)GetBindOffset(Stmt->Ard, ArdRec, ArdRec->IndicatorPtr, Row, sizeof(SQLLEN));
+      void   *Data=         GetBindOffset(Prefetch->Ard, ShadowRec, ShadowRec->DataPtr, Row, ShadowRec->OctetLength),
+             *AppData=      GetBindOffset(Stmt->Ard, ArdRec, ArdRec->DataPtr, Row, ArdRec->OctetLength);
+
+      if (AppIndicator != NULL)
+      {
+        *AppIndicator= *Indicator;
+      }
+      if (AppLength != NULL)
+      {
+        *AppLength= *Length;
+      }
+      if (AppData != NULL && (Indicator == NULL || *Indicator != SQL_NULL_DATA))
+      {
+        memcpy(AppData, Data, MADB_PrefetchCopyLength(ArdRec, Length));
+      }
+    }
+  }
+
+  if (Stmt->Ird->Header.ArrayStatusPtr != NULL)
+  {
+    memcpy(Stmt->Ird->Header.ArrayStatusPtr, Prefetch->RowStatus, sizeof(SQLUSMALLINT) * Prefetch->ArraySize);
+  }
+  if (Stmt->Ird->Header.RowsProcessedPtr != NULL)
+  {
+    *Stmt->Ird->Header.RowsProcessedPtr= Prefetch->RowsProcessed;
+  }
+
+  Stmt->LastRowFetched=    Prefetch->Shadow.LastRowFetched;
+  Stmt->PositionedCursor=  Prefetch->Shadow.PositionedCursor;
+  Stmt->Cursor.RowsetSize= Prefetch->ArraySize;
+  if (Stmt->Cursor.Position < 0)
+  {
+    Stmt->Cursor.Position= 0;
+  }
+  memcpy(&Stmt->Error, &Prefetch->Shadow.Error, sizeof(MADB_Error));
+
+  MADB_PrefetchNext(Stmt, Prefetch->Result, TRUE);
+
+  return Prefetch->Result;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchDiscard - current result is about to be closed. Prefetched rowset, if any, is thrown away */
+void MADB_PrefetchDiscard(MADB_Stmt *Stmt)
+{
+  if (Stmt->Prefetch != NULL)
+  {
+    MADB_PrefetchWait(Stmt);
+    Stmt->Prefetch->Pending=     FALSE;
+    Stmt->Prefetch->Finished=    FALSE;
+    Stmt->Prefetch->Disabled=    FALSE;
+    Stmt->Prefetch->RowRestored= FALSE;
+    Stmt->Prefetch->Rowsets=     0;
+  }
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchDisable - rows are going to be read by other means, than SQLFetch. Returns TRUE if the next rowset is
+       already prefetched, and those rows can't be read by other means anymore */
+BOOL MADB_PrefetchDisable(MADB_Stmt *Stmt)
+{
+  if (Stmt->Prefetch == NULL)
+  {
+    return FALSE;
+  }
+  Stmt->Prefetch->Disabled= TRUE;
+  MADB_PrefetchWait(Stmt);
+
+  return Stmt->Prefetch->Pending;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchRestoreRow - application reads data with SQLGetData. Next rowsets are not prefetched anymore, and if the
+       worker has read past the current row, C/C is pointed back to its copy. Returns FALSE if that was not possible */
+BOOL MADB_PrefetchRestoreRow(MADB_Stmt *Stmt)
+{
+  MADB_Prefetch *Prefetch= Stmt->Prefetch;
+  MYSQL_ROWS    *Row;
+
+  if (!MADB_PrefetchDisable(Stmt) || Prefetch->RowRestored)
+  {
+    return TRUE;
+  }
+
+  Row= Prefetch->Rows[Prefetch->Current].Last;
+  if (Row == NULL || !SQL_SUCCEEDED(MADB_PrefetchReplay(Stmt, Row, NULL)))
+  {
+    return FALSE;
+  }
+  Prefetch->RowRestored= TRUE;
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_PrefetchFree */
+void MADB_PrefetchFree(MADB_Stmt *Stmt)
+{
+  if (Stmt->Prefetch != NULL)
+  {
+    MADB_PrefetchWait(Stmt);
+    MADB_FetchPlanFree(&Stmt->Prefetch->Shadow);
+    MADB_PrefetchFreeBuffers(Stmt->Prefetch);
+    if (Stmt->Prefetch->IrdRecords != NULL)
+    {
+      ResetDescIntBuffers(&Stmt->Prefetch->Ird);
+      MADB_FREE(Stmt->Prefetch->IrdRecords);
+    }
+    MADB_FREE(Stmt->Prefetch->Bind);
+    MADB_FREE(Stmt->Prefetch->CharOffset);
+    MADB_FREE(Stmt->Prefetch->Lengths);
+    MADB_FREE(Stmt->Prefetch->SavedFlag);
+    MADB_ArenaFree(&Stmt->Prefetch->Rows[0].Arena);
+    MADB_ArenaFree(&Stmt->Prefetch->Rows[1].Arena);
+    if (Stmt->Prefetch->Ard != NULL)
+    {
+      MADB_DescFree(Stmt->Prefetch->Ard, FALSE);
+    }
+    MADB_FREE(Stmt->Prefetch);
+  }
+}
+/* }}} */
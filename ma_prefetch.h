@@ -0,0 +1,80 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+/* Background prefetch of the next rowset of forward-only block cursor. While the application processes rowset N,
+ * worker thread reads rowset N+1 from the connection and converts it into driver's buffers. Next SQLFetch copies
+ * converted values into application's buffers */
+
+#ifndef _ma_prefetch_h_
+#define _ma_prefetch_h_
+
+/* Copies of raw rows, read from the connection. If reading has ended before the rowset was complete, the list ends with
+   the entry without data, which length is what C/C has returned */
+typedef struct st_ma_prefetch_rows
+{
+  MADB_Arena  Arena;
+  MYSQL_ROWS  *First;
+  MYSQL_ROWS  *Last;            /* Last row with data */
+} MADB_PrefetchRows;
+
+typedef struct st_ma_prefetch
+{
+  MADB_Stmt     Shadow;         /* Copy of the statement the worker fetches the rowset with */
+  MADB_Desc     *Ard;           /* Copy of the application's ARD with columns bound to the buffers below */
+  MADB_Desc     Ird;            /* Copy of IRD, receiving rows status and number of processed rows */
+  MADB_DescRecord *IrdRecords;  /* Shadow's own copy of IRD records */
+  MYSQL_BIND    *Bind;          /* Shadow's own per column arrays, the fetch writes to */
+  unsigned long *CharOffset;
+  unsigned long *Lengths;
+  char          *SavedFlag;     /* Flags of C/C binding, saved while C/C is only pointed to the kept row */
+  unsigned int  FieldCount;
+  char          **Data;
+  SQLLEN        **Length;
+  SQLLEN        **Indicator;
+  SQLUSMALLINT  *RowStatus;
+  SQLULEN       RowsProcessed;
+  SQLULEN       ArraySize;
+  SQLSMALLINT   ColumnCount;
+  SQLRETURN     Result;
+  MADB_PrefetchRows Rows[2];    /* Rows of the current rowset, and of the one being prefetched */
+  unsigned int  Current;        /* Index of the current rowset's rows. Only its last row is kept, if it has been fetched directly */
+  MADB_THREAD   Worker;
+  unsigned int  Rowsets;        /* Number of rowsets application fetched from current result */
+  my_bool       Running;        /* Worker thread is not joined yet */
+  my_bool       Pending;        /* Prefetched rowset has not been taken by SQLFetch yet */
+  my_bool       Finished;       /* Worker has read the result to its end */
+  my_bool       Disabled;       /* Application uses SQLGetData - prefetch is not needed */
+  my_bool       RowRestored;    /* C/C has been pointed back to the current row for SQLGetData */
+} MADB_Prefetch;
+
+/* Prefetch is only possible while statement's result is read unbuffered, and thus the statement owns the connection */
+#define MADB_PREFETCH_POSSIBLE(aStmt) ((aStmt)->Connection->Dsn->PrefetchRowset && (aStmt)->Connection->Streamer == (aStmt) &&\
+                                       (aStmt)->Ard->Header.ArraySize > 1 && (aStmt)->Options.UseBookmarks == SQL_UB_OFF)
+#define MADB_PREFETCH_PENDING(aStmt)  ((aStmt)->Prefetch != NULL && (aStmt)->Prefetch->Pending)
+#define MADB_PREFETCH_FINISHED(aStmt) ((aStmt)->Prefetch != NULL && (aStmt)->Prefetch->Finished)
+
+void      MADB_PrefetchStart  (MADB_Stmt *Stmt, SQLRETURN FetchResult);
+SQLRETURN MADB_PrefetchTake   (MADB_Stmt *Stmt);
+void      MADB_PrefetchWait   (MADB_Stmt *Stmt);
+void      MADB_PrefetchDiscard(MADB_Stmt *Stmt);
+BOOL      MADB_PrefetchDisable(MADB_Stmt *Stmt);
+BOOL      MADB_PrefetchRestoreRow(MADB_Stmt *Stmt);
+void      MADB_PrefetchFree   (MADB_Stmt *Stmt);
+
+#endif
@@ -0,0 +1,196 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include <ma_odbc.h>
+
+
+/* {{{ MADB_PsCacheGet - returns connection's cache, creating it if needed. NULL if caching is off */
+static MADB_PsCache* MADB_PsCacheGet(MADB_Dbc *Dbc)
+{
+  if (Dbc->Dsn == NULL || Dbc->Dsn->PsCacheSize == 0)
+  {
+    return NULL;
+  }
+  if (Dbc->PsCache == NULL)
+  {
+    Dbc->PsCache= (MADB_PsCache *)MADB_CALLOC(sizeof(MADB_PsCache));
+  }
+  return Dbc->PsCache;
+}
+/* }}} */
+
+/* {{{ MADB_PsCacheUnlink */
+static void MADB_PsCacheUnlink(MADB_PsCache *Cache, MADB_PsCacheEntry *Entry)
+{
+  if (Entry->Prev != NULL)
+  {
+    Entry->Prev->Next= Entry->Next;
+  }
+  else
+  {
+    Cache->First= Entry->Next;
+  }
+  if (Entry->Next != NULL)
+  {
+    Entry->Next->Prev= Entry->Prev;
+  }
+  else
+  {
+    Cache->Last= Entry->Prev;
+  }
+  --Cache->Count;
+}
+/* }}} */
+
+/* {{{ MADB_PsCacheEntryFree - closes entry's handle and frees the entry */
+static void MADB_PsCacheEntryFree(MADB_PsCacheEntry *Entry)
+{
+  mysql_stmt_close(Entry->Handle);
+  MADB_FREE(Entry->Sql);
+  MADB_FREE(Entry);
+}
+/* }}} */
+
+/* {{{ MADB_PsCacheCheckIn - puts statement's prepared handle into the connection's cache, and detaches it from the statement.
+       Returns FALSE if the handle can't be cached, and the caller has to close it as before */
+BOOL MADB_PsCacheCheckIn(MADB_Stmt *Stmt)
+{
+  MADB_PsCache      *Cache;
+  MADB_PsCacheEntry *Entry;
+  BOOL               Cacheable= Stmt->PsCacheable;
+
+  Stmt->PsCacheable= FALSE;
+
+  /* Handles, invalidated by reconnect, have no connection */
+  if (!Cacheable || Stmt->stmt == NULL || Stmt->stmt->mysql == NULL || !(Cache= MADB_PsCacheGet(Stmt->Connection)))
+  {
+    return FALSE;
+  }
+
+  if (!(Entry= (MADB_PsCacheEntry *)MADB_CALLOC(sizeof(MADB_PsCacheEntry))) ||
+      !(Entry->Sql= _strdup(STMT_STRING(Stmt))))
+  {
+    MADB_FREE(Entry);
+    return FALSE;
+  }
+
+  MADB_ArrowDetach(Stmt);
+  mysql_stmt_free_result(Stmt->stmt);
+  /* Closing the cursor, that may be still open on the server */
+  if (MADB_STMT_USE_SERVER_CURSOR(Stmt))
+  {
+    mysql_stmt_reset(Stmt->stmt);
+  }
+  /* Result is bound to this statement's buffers, which do not live as long as the handle. Next owner binds its own */
+  Stmt->stmt->bind_result_done= 0;
+
+  MDBUG_C_PRINT(Stmt->Connection, "-->caching %0x", Stmt->stmt);
+  Entry->Handle= Stmt->stmt;
+  Stmt->stmt=    NULL;
+
+  Entry->Next= Cache->First;
+  if (Cache->First != NULL)
+  {
+    Cache->First->Prev= Entry;
+  }
+  else
+  {
+    Cache->Last= Entry;
+  }
+  Cache->First= Entry;
+
+  if (++Cache->Count > Stmt->Connection->Dsn->PsCacheSize)
+  {
+    Entry= Cache->Last;
+    MADB_PsCacheUnlink(Cache, Entry);
+    MDBUG_C_PRINT(Stmt->Connection, "-->evicting %0x", Entry->Handle);
+    MADB_PsCacheEntryFree(Entry);
+  }
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_PsCacheCheckOut - takes out of the cache handle prepared with the query text. The cache is small, and the list is
+       just walked from the most recently used end. Returns NULL if there is no such handle */
+MYSQL_STMT* MADB_PsCacheCheckOut(MADB_Dbc *Dbc, const char *Sql)
+{
+  MADB_PsCache      *Cache= MADB_PsCacheGet(Dbc);
+  MADB_PsCacheEntry *Entry;
+  MYSQL_STMT        *Handle;
+
+  if (Cache == NULL)
+  {
+    return NULL;
+  }
+
+  for (Entry= Cache->First; Entry != NULL; Entry= Entry->Next)
+  {
+    if (strcmp(Entry->Sql, Sql) == 0)
+    {
+      break;
+    }
+  }
+
+  if (Entry == NULL || Entry->Handle->mysql == NULL)
+  {
+    if (Entry != NULL)
+    {
+      MADB_PsCacheUnlink(Cache, Entry);
+      MADB_PsCacheEntryFree(Entry);
+    }
+    ++Cache->Misses;
+    return NULL;
+  }
+
+  MADB_PsCacheUnlink(Cache, Entry);
+  Handle= Entry->Handle;
+  MADB_FREE(Entry->Sql);
+  MADB_FREE(Entry);
+  ++Cache->Hits;
+
+  return Handle;
+}
+/* }}} */
+
+/* {{{ MADB_PsCacheClear - closes all cached handles, e.g. since they may be prepared in the schema, that is not current anymore.
+       Counters are preserved */
+void MADB_PsCacheClear(MADB_Dbc *Dbc)
+{
+  MADB_PsCacheEntry *Entry;
+
+  if (Dbc->PsCache == NULL)
+  {
+    return;
+  }
+
+  while ((Entry= Dbc->PsCache->First) != NULL)
+  {
+    MADB_PsCacheUnlink(Dbc->PsCache, Entry);
+    MADB_PsCacheEntryFree(Entry);
+  }
+}
+/* }}} */
+
+/* {{{ MADB_PsCacheFree */
+void MADB_PsCacheFree(MADB_Dbc *Dbc)
+{
+  MADB_PsCacheClear(Dbc);
+  MADB_FREE(Dbc->PsCache);
+}
+/* }}} */
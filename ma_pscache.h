@@ -0,0 +1,55 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+/* Per-connection cache of server side prepared statements. When statement is re-prepared or dropped, its C/C handle is
+ * not closed, but kept in the connection's LRU list under the query text it has been prepared with. Next prepare of the
+ * same text takes the handle from the list, and skips the round trip to the server. Parameters and result metadata are
+ * already in the handle. Size of the cache is set by PS_CACHE_SIZE DSN option, 0 disables it */
+
+#ifndef _ma_pscache_h_
+#define _ma_pscache_h_
+
+/* Read-only connection attributes - numbers of prepares served from the cache, and of those, that had to go to the server */
+#define MADB_ATTR_PS_CACHE_HITS   (SQL_DRIVER_CONN_ATTR_BASE + 1)
+#define MADB_ATTR_PS_CACHE_MISSES (SQL_DRIVER_CONN_ATTR_BASE + 2)
+
+typedef struct st_ma_ps_cache_entry
+{
+  struct st_ma_ps_cache_entry *Prev;
+  struct st_ma_ps_cache_entry *Next;
+  char                        *Sql;
+  MYSQL_STMT                  *Handle;
+} MADB_PsCacheEntry;
+
+typedef struct st_ma_ps_cache
+{
+  MADB_PsCacheEntry *First;     /* Most recently used */
+  MADB_PsCacheEntry *Last;      /* Evicted first */
+  unsigned int       Count;
+  SQLULEN            Hits;
+  SQLULEN            Misses;
+} MADB_PsCache;
+
+/* All functions have to be called inside the connection's lock */
+BOOL        MADB_PsCacheCheckIn (MADB_Stmt *Stmt);
+MYSQL_STMT* MADB_PsCacheCheckOut(MADB_Dbc *Dbc, const char *Sql);
+void        MADB_PsCacheClear   (MADB_Dbc *Dbc);
+void        MADB_PsCacheFree    (MADB_Dbc *Dbc);
+
+#endif
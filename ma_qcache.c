@@ -0,0 +1,263 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include <ma_odbc.h>
+
+
+/* {{{ MADB_QCacheHash - FNV-1a hash of the query text */
+static unsigned long MADB_QCacheHash(const char *Text, size_t Length)
+{
+  unsigned long Hash= 2166136261UL;
+  size_t        i;
+
+  for (i= 0; i < Length; ++i)
+  {
+    Hash= ((Hash ^ (unsigned char)Text[i]) * 16777619UL) & 0xffffffffUL;
+  }
+  return Hash;
+}
+/* }}} */
+
+/* {{{ MADB_QCacheCopyQuery - copies result of parsing. Dst->allocated has to be allocated with Size bytes already, other
+       members of Dst are overwritten. Returns non-zero if memory could not be allocated */
+static int MADB_QCacheCopyQuery(MADB_QUERY *Dst, MADB_QUERY *Src, size_t Size)
+{
+  SINGLE_QUERY SubQuery;
+  unsigned int i;
+
+  memcpy(Dst->allocated, Src->allocated, Size);
+  Dst->RefinedText=       Dst->allocated + (Src->RefinedText - Src->allocated);
+  Dst->RefinedLength=     Src->RefinedLength;
+  Dst->HasParameters=     Src->HasParameters;
+  Dst->ReturnsResult=     Src->ReturnsResult;
+  Dst->QueryType=         Src->QueryType;
+  Dst->PoorManParsing=    Src->PoorManParsing;
+  Dst->BatchAllowed=      Src->BatchAllowed;
+  Dst->AnsiQuotes=        Src->AnsiQuotes;
+  Dst->NoBackslashEscape= Src->NoBackslashEscape;
+
+  if (!(Dst->Original= _strdup(Src->Original)) ||
+      MADB_InitDynamicArray(&Dst->Tokens, sizeof(unsigned int), MAX(Src->Tokens.elements, 1), 40) ||
+      MADB_InitDynamicArray(&Dst->SubQuery, sizeof(SINGLE_QUERY), MAX(Src->SubQuery.elements, 1), 40))
+  {
+    return 1;
+  }
+
+  memcpy(Dst->Tokens.buffer, Src->Tokens.buffer, Src->Tokens.elements * sizeof(unsigned int));
+  Dst->Tokens.elements= Src->Tokens.elements;
+
+  /* Subqueries point into the query's own copy of the text */
+  for (i= 0; i < Src->SubQuery.elements; ++i)
+  {
+    MADB_GetDynamic(&Src->SubQuery, (char *)&SubQuery, i);
+    MADB_AddSubQuery(Dst, Dst->allocated + (SubQuery.QueryText - Src->allocated), SubQuery.QueryType);
+  }
+
+  return 0;
+}
+/* }}} */
+
+/* {{{ MADB_QCacheEntryFree */
+static void MADB_QCacheEntryFree(MADB_QCacheEntry *Entry)
+{
+  MADB_DeleteQuery(&Entry->Query);
+  MADB_FREE(Entry->Text);
+  MADB_FREE(Entry);
+}
+/* }}} */
+
+/* {{{ MADB_QCacheUnlink */
+static void MADB_QCacheUnlink(MADB_QCache *Cache, MADB_QCacheEntry *Entry)
+{
+  if (Entry->Prev != NULL)
+  {
+    Entry->Prev->Next= Entry->Next;
+  }
+  else
+  {
+    Cache->First= Entry->Next;
+  }
+  if (Entry->Next != NULL)
+  {
+    Entry->Next->Prev= Entry->Prev;
+  }
+  else
+  {
+    Cache->Last= Entry->Prev;
+  }
+  Entry->Prev= Entry->Next= NULL;
+  --Cache->Count;
+  Cache->Memory-= Entry->Memory;
+}
+/* }}} */
+
+/* {{{ MADB_QCacheLink - puts entry to the most recently used end */
+static void MADB_QCacheLink(MADB_QCache *Cache, MADB_QCacheEntry *Entry)
+{
+  Entry->Prev= NULL;
+  Entry->Next= Cache->First;
+  if (Cache->First != NULL)
+  {
+    Cache->First->Prev= Entry;
+  }
+  else
+  {
+    Cache->Last= Entry;
+  }
+  Cache->First= Entry;
+  ++Cache->Count;
+  Cache->Memory+= Entry->Memory;
+}
+/* }}} */
+
+/* {{{ MADB_QCacheFind - has to be called inside the environment's lock */
+static MADB_QCacheEntry* MADB_QCacheFind(MADB_QCache *Cache, MADB_QUERY *Query, unsigned long Hash, char *Text, size_t Length)
+{
+  MADB_QCacheEntry *Entry;
+
+  for (Entry= Cache->First; Entry != NULL; Entry= Entry->Next)
+  {
+    /* Parser options are part of the key, as they change the result of parsing */
+    if (Entry->Hash == Hash && Entry->Length == Length &&
+        Entry->Query.BatchAllowed == Query->BatchAllowed && Entry->Query.AnsiQuotes == Query->AnsiQuotes &&
+        Entry->Query.NoBackslashEscape == Query->NoBackslashEscape &&
+        memcmp(Entry->Text, Text, Length) == 0)
+    {
+      return Entry;
+    }
+  }
+  return NULL;
+}
+/* }}} */
+
+/* {{{ MADB_QCacheGet - fills statement's query with the cached result of parsing of the text. Returns FALSE if the text is
+       not in the cache, and has to be parsed */
+BOOL MADB_QCacheGet(MADB_Stmt *Stmt, char *Text, SQLINTEGER Length)
+{
+  MADB_Env         *Env= Stmt->Connection->Environment;
+  MADB_QCacheEntry *Entry;
+  unsigned long     Hash;
+  BOOL              Found= FALSE, Failed= FALSE;
+
+  if (Length < MADB_QCACHE_MIN_LENGTH || Stmt->Query.allocated == NULL)
+  {
+    return FALSE;
+  }
+  Hash= MADB_QCacheHash(Text, (size_t)Length);
+
+  EnterCriticalSection(&Env->cs);
+  if (Env->QueryCache != NULL &&
+     (Entry= MADB_QCacheFind(Env->QueryCache, &Stmt->Query, Hash, Text, (size_t)Length)) != NULL)
+  {
+    MADB_QCacheUnlink(Env->QueryCache, Entry);
+    MADB_QCacheLink(Env->QueryCache, Entry);
+    Failed= MADB_QCacheCopyQuery(&Stmt->Query, &Entry->Query, Entry->Size) != 0;
+    Found=  !Failed;
+  }
+  LeaveCriticalSection(&Env->cs);
+
+  /* Partial copy is thrown away, and the text is parsed as usual */
+  if (Failed)
+  {
+    MADB_ResetParser(Stmt, Text, Length);
+  }
+  return Found;
+}
+/* }}} */
+
+/* {{{ MADB_QCachePut - puts the result of parsing of the text into the cache. Has to be called right after MADB_ParseQuery,
+       before the statement changes its query */
+void MADB_QCachePut(MADB_Stmt *Stmt, char *Text, SQLINTEGER Length)
+{
+  MADB_Env         *Env= Stmt->Connection->Environment;
+  MADB_QCacheEntry *Entry;
+  char             *End;
+
+  if (Length < MADB_QCACHE_MIN_LENGTH || Stmt->Query.allocated == NULL || Stmt->Query.Original == NULL)
+  {
+    return;
+  }
+
+  if (!(Entry= (MADB_QCacheEntry *)MADB_CALLOC(sizeof(MADB_QCacheEntry))))
+  {
+    return;
+  }
+  /* Parser has got the text up to the 1st NUL, if there is any */
+  End=           (char *)memchr(Text, '\0', (size_t)Length);
+  Entry->Size=   (End != NULL ? (size_t)(End - Text) : (size_t)Length) + 1;
+  Entry->Length= (size_t)Length;
+  Entry->Hash=   MADB_QCacheHash(Text, (size_t)Length);
+
+  if (!(Entry->Text= (char *)MADB_ALLOC(Entry->Length)) ||
+      !(Entry->Query.allocated= (char *)MADB_ALLOC(Entry->Size)) ||
+      MADB_QCacheCopyQuery(&Entry->Query, &Stmt->Query, Entry->Size))
+  {
+    MADB_QCacheEntryFree(Entry);
+    return;
+  }
+  memcpy(Entry->Text, Text, Entry->Length);
+  Entry->Memory= sizeof(MADB_QCacheEntry) + Entry->Length + Entry->Size + strlen(Entry->Query.Original) + 1 +
+                 Entry->Query.Tokens.elements * sizeof(unsigned int) + Entry->Query.SubQuery.elements * sizeof(SINGLE_QUERY);
+
+  if (Entry->Memory > MADB_QCACHE_MEMORY)
+  {
+    MADB_QCacheEntryFree(Entry);
+    return;
+  }
+
+  EnterCriticalSection(&Env->cs);
+  if (Env->QueryCache == NULL)
+  {
+    Env->QueryCache= (MADB_QCache *)MADB_CALLOC(sizeof(MADB_QCache));
+  }
+  /* Other connection may have put the same text meanwhile */
+  if (Env->QueryCache == NULL || MADB_QCacheFind(Env->QueryCache, &Entry->Query, Entry->Hash, Text, Entry->Length) != NULL)
+  {
+    LeaveCriticalSection(&Env->cs);
+    MADB_QCacheEntryFree(Entry);
+    return;
+  }
+
+  MADB_QCacheLink(Env->QueryCache, Entry);
+  while (Env->QueryCache->Count > MADB_QCACHE_SIZE || Env->QueryCache->Memory > MADB_QCACHE_MEMORY)
+  {
+    Entry= Env->QueryCache->Last;
+    MADB_QCacheUnlink(Env->QueryCache, Entry);
+    MADB_QCacheEntryFree(Entry);
+  }
+  LeaveCriticalSection(&Env->cs);
+}
+/* }}} */
+
+/* {{{ MADB_QCacheFree */
+void MADB_QCacheFree(MADB_Env *Env)
+{
+  MADB_QCacheEntry *Entry;
+
+  if (Env->QueryCache == NULL)
+  {
+    return;
+  }
+  while ((Entry= Env->QueryCache->First) != NULL)
+  {
+    MADB_QCacheUnlink(Env->QueryCache, Entry);
+    MADB_QCacheEntryFree(Entry);
+  }
+  MADB_FREE(Env->QueryCache);
+}
+/* }}} */
@@ -0,0 +1,57 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+/* Environment-wide cache of parsed queries. Long query text, that has been parsed once, is kept together with the result
+ * of parsing - refined text, tokens, subqueries and query flags. Preparing the same text again copies them instead of
+ * scanning the text. Entries are looked up by hash of the text and parser options, least recently used ones are evicted */
+
+#ifndef _ma_qcache_h_
+#define _ma_qcache_h_
+
+/* Shorter queries are parsed faster, than they would be copied */
+#define MADB_QCACHE_MIN_LENGTH 1024
+#define MADB_QCACHE_SIZE       32
+#define MADB_QCACHE_MEMORY     (16 * 1024 * 1024)
+
+typedef struct st_ma_qcache_entry
+{
+  struct st_ma_qcache_entry *Prev;
+  struct st_ma_qcache_entry *Next;
+  unsigned long              Hash;
+  char                      *Text;      /* Query text as application passed it */
+  size_t                     Length;
+  size_t                     Size;      /* Size of Query.allocated */
+  size_t                     Memory;
+  MADB_QUERY                 Query;     /* Parsed query. Subqueries point into Query.allocated */
+} MADB_QCacheEntry;
+
+typedef struct st_ma_qcache
+{
+  MADB_QCacheEntry *First;      /* Most recently used */
+  MADB_QCacheEntry *Last;
+  unsigned int      Count;
+  size_t            Memory;
+} MADB_QCache;
+
+/* Both are called after MADB_ResetParser, and take the environment's lock themselves */
+BOOL MADB_QCacheGet (MADB_Stmt *Stmt, char *Text, SQLINTEGER Length);
+void MADB_QCachePut (MADB_Stmt *Stmt, char *Text, SQLINTEGER Length);
+void MADB_QCacheFree(MADB_Env *Env);
+
+#endif
@@ -28,69 +28,176 @@ void MADB_StmtResetResultStructures(MADB_Stmt *Stmt)
   Stmt->Lengths= (unsigned long *)MADB_REALLOC((char *)Stmt->Lengths,
     sizeof(long) * mysql_stmt_field_count(Stmt->stmt));
   memset(Stmt->Lengths, 0, sizeof(long) * mysql_stmt_field_count(Stmt->stmt));
+  Stmt->ColumnLengths= (unsigned long *)MADB_REALLOC((char *)Stmt->ColumnLengths,
+    sizeof(long) * mysql_stmt_field_count(Stmt->stmt));
+  MADB_COLUMN_LENGTHS_RESET(Stmt);
+
+  /* Stored rows are cut with the limit, the result is produced with. Changing the attribute later does not affect them */
+  Stmt->ResultMaxLength= (unsigned long)Stmt->Options.MaxLength;
 
   Stmt->LastRowFetched= 0;
+  MADB_ROWINDEX_RESET(Stmt);
   MADB_STMT_RESET_CURSOR(Stmt);
+  MADB_ArrowDetach(Stmt);
 }
 /* }}} */
 
-/* {{{ MoveNext - moves C/C cursor forward for Offset positions */
+/* {{{ MoveNext - moves C/C cursor forward for Offset positions. Rows before the last one are skipped without conversion
+       into the bound buffers: rows of stored result are just walked over in the list, and the others are only read.
+       The last row is fetched by C/C with binds flagged as dummy - values are not converted either, but C/C points the
+       binds to the row, and mysql_stmt_fetch_column reads from it. MADB_RefreshRowPtrs depends on that */
 SQLRETURN MoveNext(MADB_Stmt *Stmt, unsigned long long Offset)
 {
-  SQLRETURN  result= SQL_SUCCESS;
+  MYSQL_STMT    *stmt= Stmt->stmt;
+  unsigned char *Row;
+  char          *SavedFlag;
+  unsigned int   i;
+  int            rc;
 
-  if (Stmt->result != NULL)
+  if (Stmt->result == NULL || Offset == 0)
   {
-    unsigned int i;
-    char        *SavedFlag;
+    return SQL_SUCCESS;
+  }
+  MADB_COLUMN_LENGTHS_RESET(Stmt);
 
-    SavedFlag= (char*)MADB_CALLOC(mysql_stmt_field_count(Stmt->stmt));
+  /* Nothing to skip yet - mysql_stmt_fetch will set the error */
+  if (stmt->state < MYSQL_STMT_WAITING_USE_OR_STORE || stmt->field_count == 0)
+  {
+    return mysql_stmt_fetch(stmt) == 1 ? SQL_ERROR : SQL_SUCCESS;
+  }
+  if (stmt->state == MYSQL_STMT_WAITING_USE_OR_STORE)
+  {
+    stmt->default_rset_handler(stmt);
+  }
 
-    if (SavedFlag == NULL)
+  while (Offset > 1 && stmt->state != MYSQL_STMT_FETCH_DONE)
+  {
+    /* For server side cursor the list contains only the current batch, and the next one is requested by fetch_row_func.
+       The same way spilled result's fetch_row_func puts next rows into the window, when the list ends with the sentinel */
+    if (stmt->result_cursor != NULL && stmt->result_cursor->data != NULL)
     {
-      return SQL_ERROR;
+      stmt->result_cursor= stmt->result_cursor->next;
+      stmt->state=         MYSQL_STMT_USER_FETCHING;
     }
-
-    for (i=0; i < mysql_stmt_field_count(Stmt->stmt); i++)
+    /* Same as mysql_stmt_fetch does, except the conversion of the row */
+    else if ((rc= stmt->fetch_row_func(stmt, &Row)) != 0)
     {
-      SavedFlag[i]= Stmt->stmt->bind[i].flags & MADB_BIND_DUMMY;
+      stmt->state=          MYSQL_STMT_FETCH_DONE;
+      stmt->mysql->status=  MYSQL_STATUS_READY;
 
-      Stmt->stmt->bind[i].flags|= MADB_BIND_DUMMY;
+      return rc == 1 ? SQL_ERROR : SQL_SUCCESS;
     }
-
-    while (Offset--)
+    else
     {
-      if (mysql_stmt_fetch(Stmt->stmt) == 1)
-      {
-        result= SQL_ERROR;
-        break;
-      }
+      stmt->state= MYSQL_STMT_USER_FETCHING;
     }
+    --Offset;
+  }
+
+  if (stmt->state == MYSQL_STMT_FETCH_DONE)
+  {
+    return SQL_SUCCESS;
+  }
 
-    for (i=0; i < mysql_stmt_field_count(Stmt->stmt); i++)
+  if ((SavedFlag= (char*)MADB_CALLOC(stmt->field_count)) == NULL)
+  {
+    return SQL_ERROR;
+  }
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    SavedFlag[i]= stmt->bind[i].flags & MADB_BIND_DUMMY;
+    stmt->bind[i].flags|= MADB_BIND_DUMMY;
+  }
+
+  rc= mysql_stmt_fetch(stmt);
+
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    stmt->bind[i].flags&= (~MADB_BIND_DUMMY | SavedFlag[i]);
+  }
+  MADB_FREE(SavedFlag);
+
+  return rc == 1 ? SQL_ERROR : SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_RowIndexBuild - fills the index with pointers to the rows of the stored result. The array is kept between
+       results, and only grows */
+static BOOL MADB_RowIndexBuild(MADB_Stmt *Stmt)
+{
+  MADB_RowIndex      *Index= &Stmt->RowIndex;
+  MYSQL_ROWS         *Row;
+  unsigned long long  Count= MADB_SPILL_IN_MEMORY(Stmt), i= 0;
+
+  if (Count > Index->Allocated)
+  {
+    MYSQL_ROWS **Rows;
+
+    if (Count > (size_t)-1 / sizeof(MYSQL_ROWS *) ||
+        (Rows= (MYSQL_ROWS **)MADB_REALLOC(Index->Rows, (size_t)Count * sizeof(MYSQL_ROWS *))) == NULL)
     {
-      Stmt->stmt->bind[i].flags &= (~MADB_BIND_DUMMY | SavedFlag[i]);
+      return FALSE;
     }
+    Index->Rows=      Rows;
+    Index->Allocated= Count;
+  }
 
-    MADB_FREE(SavedFlag);
+  for (Row= Stmt->stmt->result.data; Row != NULL && i < Count; Row= Row->next)
+  {
+    Index->Rows[i++]= Row;
   }
-  return result;
+
+  Index->Handle= Stmt->stmt;
+  Index->Data=   Stmt->stmt->result.data;
+  Index->Count=  i;
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_RowIndexFree */
+void MADB_RowIndexFree(MADB_Stmt *Stmt)
+{
+  MADB_FREE(Stmt->RowIndex.Rows);
+  memset(&Stmt->RowIndex, 0, sizeof(MADB_RowIndex));
 }
 /* }}} */
 
-/* {{{ MADB_StmtDataSeek */
+/* {{{ MADB_StmtDataSeek - positions C/C cursor on the row FetchOffset of the stored result. Seeking to the 1st row is
+       cheap as is, for any other the index of rows is used, which is built on first such seek */
 SQLRETURN MADB_StmtDataSeek(MADB_Stmt *Stmt, my_ulonglong FetchOffset)
 {
-  MYSQL_ROWS *tmp= NULL;
+  MADB_RowIndex *Index= &Stmt->RowIndex;
+  MYSQL_STMT    *stmt=  Stmt->stmt;
 
-  if (!Stmt->stmt->result.data)
+  if (!stmt->result.data)
   {
    return SQL_NO_DATA_FOUND;
   }
+  MADB_COLUMN_LENGTHS_RESET(Stmt);
 
-  mysql_stmt_data_seek(Stmt->stmt, FetchOffset);
+  /* Rows in the temporary file are not in the list, and do not get to the index */
+  if (MADB_SPILL_WINDOWED(Stmt, FetchOffset))
+  {
+    return MADB_SpillSeek(Stmt, FetchOffset, 1);
+  }
 
-  return SQL_SUCCESS;  
+  if (FetchOffset > 0 && (Index->Handle != stmt || Index->Data != stmt->result.data || Index->Count != MADB_SPILL_IN_MEMORY(Stmt)))
+  {
+    /* If there is no memory for the index, we can still walk the list */
+    if (!MADB_RowIndexBuild(Stmt))
+    {
+      mysql_stmt_data_seek(stmt, FetchOffset);
+      return SQL_SUCCESS;
+    }
+  }
+
+  /* Same as mysql_stmt_data_seek does, but without walking the list */
+  stmt->result_cursor= FetchOffset == 0 ? stmt->result.data :
+                         (FetchOffset < Index->Count ? Index->Rows[FetchOffset] : NULL);
+  stmt->state=         MYSQL_STMT_USER_FETCHING;
+
+  return SQL_SUCCESS;
 }
 /* }}} */
 
@@ -125,6 +232,9 @@ SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt)
     return MADB_SetError(&Stmt->Error, MADB_ERR_08S01, NULL, 0);
   }
 
+  MADB_PrefetchDiscard(Stmt);
+  MADB_SpillFree(Stmt);
+
   /* We can't have it in MADB_StmtResetResultStructures, as it breaks dyn_cursor functionality.
      Thus we free-ing bind structs on move to new result only */
   MADB_FREE(Stmt->result);
@@ -136,6 +246,14 @@ SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt)
       return SQL_NO_DATA;
     }
 
+    /* Rows of lazily read result, that the application has not fetched, stay on the server till the cursor is closed */
+    if (MADB_STMT_USE_SERVER_CURSOR(Stmt) && mysql_stmt_field_count(Stmt->stmt) > 0)
+    {
+      LOCK_MARIADB(Stmt->Connection);
+      MADB_StoreStreamer(Stmt->Connection, Stmt);
+      mysql_stmt_reset(Stmt->stmt);
+      UNLOCK_MARIADB(Stmt->Connection);
+    }
     ++Stmt->MultiStmtNr;
 
     MADB_InstallStmt(Stmt, Stmt->MultiStmts[Stmt->MultiStmtNr]);
@@ -153,6 +271,7 @@ SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt)
       int Next;
 
       LOCK_MARIADB(Stmt->Connection);
+      MADB_StoreStreamer(Stmt->Connection, Stmt);
       Next= mysql_next_result(Stmt->Connection->mariadb);
 
       if (Next > 0)
@@ -187,6 +306,7 @@ SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt)
   }
   
   LOCK_MARIADB(Stmt->Connection);
+  MADB_StoreStreamer(Stmt->Connection, Stmt);
   if (mysql_stmt_next_result(Stmt->stmt) > 0)
   {
     UNLOCK_MARIADB(Stmt->Connection);
@@ -218,9 +338,13 @@ SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt)
     {
       if (Stmt->Options.CursorType != SQL_CURSOR_FORWARD_ONLY)
       {
-        mysql_stmt_store_result(Stmt->stmt);
+        MADB_StoreResult(Stmt);
         mysql_stmt_data_seek(Stmt->stmt, 0);
       }
+      else
+      {
+        Stmt->Connection->Streamer= Stmt;
+      }
     }
     UNLOCK_MARIADB(Stmt->Connection);
   }
@@ -253,3 +377,40 @@ SQLULEN MADB_RowsToFetch(MADB_Cursor *Cursor, SQLULEN ArraySize, unsigned long l
 }
 /* }}} */
 
+/* {{{ MADB_StoreStreamer - forward-only statements read their results unbuffered, and while one of them does, nothing else can
+       be sent over the connection. Thus before any other communication with the server we read rest of such result into
+       client's memory. If the statement is going to be re-used itself, the rest of its result is simply discarded */
+void MADB_StoreStreamer(MADB_Dbc *Dbc, MADB_Stmt *Requester)
+{
+  MADB_Stmt *Streamer;
+
+  LOCK_MARIADB(Dbc);
+  /* Requester's result is going to be closed, and the rowset it might be prefetching is not needed anymore */
+  if (Requester != NULL)
+  {
+    MADB_PrefetchDiscard(Requester);
+  }
+  Streamer= Dbc->Streamer;
+  Dbc->Streamer= NULL;
+
+  if (Streamer != NULL)
+  {
+    if (Streamer == Requester)
+    {
+      MDBUG_C_PRINT(Dbc, "mysql_stmt_free_result(%0x)", Streamer->stmt);
+      mysql_stmt_free_result(Streamer->stmt);
+    }
+    else
+    {
+      /* Rowset, that is being prefetched, stays for the next SQLFetch, the rest of the result is stored, unless the worker
+         has read it to the end */
+      MADB_PrefetchWait(Streamer);
+      if (!MADB_PREFETCH_FINISHED(Streamer))
+      {
+        MADB_StoreResult(Streamer);
+      }
+    }
+  }
+  UNLOCK_MARIADB(Dbc);
+}
+/* }}} */
@@ -19,10 +19,15 @@
  #ifndef _ma_result_h_
  #define _ma_result_h_
 
+/* Rows list of the result is about to change - the index has to be rebuilt on the next seek */
+#define MADB_ROWINDEX_RESET(aStmt) (aStmt)->RowIndex.Data= NULL
+
 void MADB_StmtResetResultStructures(MADB_Stmt *Stmt);
 SQLRETURN MoveNext(MADB_Stmt *Stmt, unsigned long long Offset);
 SQLRETURN MADB_StmtDataSeek   (MADB_Stmt *Stmt, my_ulonglong FetchOffset);
+void      MADB_RowIndexFree   (MADB_Stmt *Stmt);
 SQLRETURN MADB_StmtMoreResults(MADB_Stmt *Stmt);
 SQLULEN   MADB_RowsToFetch(MADB_Cursor *Cursor, SQLULEN ArraySize, unsigned long long RowsInResultst);
+void      MADB_StoreStreamer(MADB_Dbc *Dbc, MADB_Stmt *Requester);
 
  #endif /* _ma_result_h_ */
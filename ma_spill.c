@@ -0,0 +1,568 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include <ma_odbc.h>
+
+
+/* {{{ MADB_SpillRowLength - returns length of the binary protocol row packet, starting with its header byte.
+       Along the way updates max_length of string columns, as mysql_stmt_store_result does */
+static unsigned long MADB_SpillRowLength(MYSQL_STMT *stmt, unsigned char *Row)
+{
+  unsigned char *NullPtr=   Row + 1,
+                *Ptr=       Row + 1 + (stmt->field_count + 9) / 8;
+  unsigned char  BitOffset= 4;
+  unsigned int   i;
+
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    if (!(*NullPtr & BitOffset))
+    {
+      switch (stmt->fields[i].type)
+      {
+      case MYSQL_TYPE_NULL:
+        break;
+      case MYSQL_TYPE_TINY:
+        Ptr+= 1;
+        break;
+      case MYSQL_TYPE_SHORT:
+      case MYSQL_TYPE_YEAR:
+        Ptr+= 2;
+        break;
+      case MYSQL_TYPE_LONG:
+      case MYSQL_TYPE_INT24:
+      case MYSQL_TYPE_FLOAT:
+        Ptr+= 4;
+        break;
+      case MYSQL_TYPE_LONGLONG:
+      case MYSQL_TYPE_DOUBLE:
+        Ptr+= 8;
+        break;
+      case MYSQL_TYPE_DATE:
+      case MYSQL_TYPE_TIME:
+      case MYSQL_TYPE_DATETIME:
+      case MYSQL_TYPE_TIMESTAMP:
+      {
+        unsigned long long Length= MADB_NetFieldLength(&Ptr);
+
+        Ptr+= Length;
+        break;
+      }
+      default:
+      {
+        unsigned long long Length= MADB_NetFieldLength(&Ptr);
+
+        if (Length > stmt->fields[i].max_length)
+        {
+          stmt->fields[i].max_length= (unsigned long)Length;
+        }
+        Ptr+= Length;
+      }
+      }
+    }
+    if (!((BitOffset<<= 1) & 255))
+    {
+      BitOffset= 1;
+      ++NullPtr;
+    }
+  }
+
+  return (unsigned long)(Ptr - Row);
+}
+/* }}} */
+
+/* {{{ MADB_SpillCutRow - cuts values of character and binary columns of the binary protocol row to Limit bytes, moving the
+       rest of the row to close the gaps. Thus dropped bytes are neither stored, nor counted in the row length */
+static void MADB_SpillCutRow(MYSQL_STMT *stmt, unsigned char *Row, unsigned long Limit, BOOL Utf8)
+{
+  unsigned char *NullPtr=   Row + 1,
+                *Src=       Row + 1 + (stmt->field_count + 9) / 8,
+                *Dst=       Src;
+  unsigned char  BitOffset= 4;
+  unsigned int   i;
+
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    if (!(*NullPtr & BitOffset))
+    {
+      unsigned char *Value= Src;
+
+      if (MADB_MaxLengthField(&stmt->fields[i]))
+      {
+        unsigned long long Length= MADB_NetFieldLength(&Src);
+        unsigned long      Cut=    MADB_CutLength(Src, Length, Limit, Utf8 && stmt->fields[i].charsetnr != BINARY_CHARSETNR);
+
+        /* The length of the cut value is not wider, than the original one */
+        Dst= MADB_NetStoreLength(Dst, Cut);
+        memmove(Dst, Src, Cut);
+        Dst+= Cut;
+        Src+= Length;
+      }
+      else
+      {
+        Src+= MADB_NetValueSize(&stmt->fields[i], Src);
+        memmove(Dst, Value, Src - Value);
+        Dst+= Src - Value;
+      }
+    }
+    if (!((BitOffset<<= 1) & 255))
+    {
+      BitOffset= 1;
+      ++NullPtr;
+    }
+  }
+}
+/* }}} */
+
+/* {{{ MADB_SpillAccount - accounts Size bytes, allocated for the result, in connection's CursorMemory */
+static void MADB_SpillAccount(MADB_Spill *Spill, size_t Size)
+{
+  LOCK_MARIADB(Spill->Stmt->Connection);
+  Spill->Memory+=                        Size;
+  Spill->Stmt->Connection->CursorMemory+= Size;
+  UNLOCK_MARIADB(Spill->Stmt->Connection);
+}
+/* }}} */
+
+/* {{{ MADB_SpillAlloc - allocates Size bytes from spill's memory chunks, and accounts them in connection's CursorMemory.
+       Has to be called inside the lock */
+static char* MADB_SpillAlloc(MADB_Spill *Spill, size_t Size)
+{
+  char *Ptr;
+
+  /* Keeping MYSQL_ROWS structures aligned */
+  Size= (Size + 7) & ~(size_t)7;
+
+  if (Spill->Chunks == NULL || Spill->Chunks->Used + Size > Spill->Chunks->Size)
+  {
+    size_t           ChunkSize= MAX(Size, MADB_SPILL_CHUNK_SIZE);
+    MADB_SpillChunk *Chunk=     (MADB_SpillChunk *)MADB_ALLOC(sizeof(MADB_SpillChunk) + ChunkSize);
+
+    if (Chunk == NULL)
+    {
+      return NULL;
+    }
+    Chunk->Prev=   Spill->Chunks;
+    Chunk->Size=   ChunkSize;
+    Chunk->Used=   0;
+    Spill->Chunks= Chunk;
+  }
+
+  Ptr= (char *)(Spill->Chunks + 1) + Spill->Chunks->Used;
+  Spill->Chunks->Used+=                  Size;
+  Spill->Memory+=                        Size;
+  Spill->Stmt->Connection->CursorMemory+= Size;
+
+  return Ptr;
+}
+/* }}} */
+
+/* {{{ MADB_SpillIndexAdd - remembers Offset of the row in the file. Index memory is accounted in connection's CursorMemory.
+       Has to be called inside the lock */
+static BOOL MADB_SpillIndexAdd(MADB_Spill *Spill, size_t Offset)
+{
+  if (Spill->IndexCount == Spill->IndexAllocated)
+  {
+    size_t  Allocated= Spill->IndexAllocated > 0 ? Spill->IndexAllocated * 2 : MADB_SPILL_INDEX_STEP;
+    size_t *Index=     (size_t *)MADB_REALLOC(Spill->Index, Allocated * sizeof(size_t));
+
+    if (Index == NULL)
+    {
+      return FALSE;
+    }
+    Spill->Memory+=                        (Allocated - Spill->IndexAllocated) * sizeof(size_t);
+    Spill->Stmt->Connection->CursorMemory+= (Allocated - Spill->IndexAllocated) * sizeof(size_t);
+    Spill->Index=          Index;
+    Spill->IndexAllocated= Allocated;
+  }
+  Spill->Index[Spill->IndexCount++]= Offset;
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_SpillFileLoad - MADB_SpillLoad for rows in the temporary file. Rows are found from the nearest indexed one */
+static BOOL MADB_SpillFileLoad(MADB_Spill *Spill, unsigned long long First, unsigned long Count)
+{
+  unsigned long long Nr=   First - Spill->InMemory;
+  unsigned char     *Data= (unsigned char *)Spill->Map + Spill->Index[Nr / MADB_SPILL_INDEX_STEP];
+  unsigned long      i;
+
+  for (i= 0; i < Nr % MADB_SPILL_INDEX_STEP; ++i)
+  {
+    Data+= MADB_SpillRowLength(Spill->Handle, Data);
+  }
+  for (i= 0; i < Count; ++i)
+  {
+    Spill->Window[i].data=   (MYSQL_ROW)Data;
+    Spill->Window[i].length= MADB_SpillRowLength(Spill->Handle, Data);
+    Data+= Spill->Window[i].length;
+  }
+
+  return TRUE;
+}
+/* }}} */
+
+/* {{{ MADB_SpillWindow - puts nodes of at least Count rows, starting from First, into the window, and returns the node
+       of the 1st of them. Nodes memory is accounted in connection's CursorMemory */
+static MYSQL_ROWS* MADB_SpillWindow(MADB_Spill *Spill, unsigned long long First, unsigned long long Count)
+{
+  unsigned long i;
+
+  Count= MIN(MAX(Count, MADB_SPILL_WINDOW), Spill->Rows - First);
+
+  if (Count > Spill->WindowAllocated)
+  {
+    MYSQL_ROWS *Window;
+
+    if (Count > (size_t)-1 / sizeof(MYSQL_ROWS) ||
+        (Window= (MYSQL_ROWS *)MADB_REALLOC(Spill->Window, (size_t)Count * sizeof(MYSQL_ROWS))) == NULL)
+    {
+      return NULL;
+    }
+    MADB_SpillAccount(Spill, (size_t)(Count - Spill->WindowAllocated) * sizeof(MYSQL_ROWS));
+    Spill->Window=          Window;
+    Spill->WindowAllocated= (unsigned long)Count;
+  }
+
+  /* Nodes are not valid, if rows could not be loaded */
+  Spill->WindowRows= 0;
+  if (!Spill->Load(Spill, First, (unsigned long)Count))
+  {
+    return NULL;
+  }
+  for (i= 0; i < Count; ++i)
+  {
+    Spill->Window[i].next= i + 1 < Count ? &Spill->Window[i + 1] : &Spill->End[1];
+  }
+  Spill->WindowStart= First;
+  Spill->WindowRows=  (unsigned long)Count;
+
+  return Spill->Window;
+}
+/* }}} */
+
+/* {{{ MADB_SpillFetchRow - C/C's fetch_row_func for the result, installed by MADB_StoreResult. Does the same as the one
+       for the result stored by mysql_stmt_store_result, and puts next rows in the window, when reaches the end of the list */
+static int MADB_SpillFetchRow(MYSQL_STMT *stmt, unsigned char **Row)
+{
+  MYSQL_ROWS *Current= stmt->result_cursor;
+
+  if (Current != NULL && Current->data == NULL)
+  {
+    MADB_Spill        *Spill= (MADB_Spill *)(Current - Current->length);
+    unsigned long long Next=  Current->length == 0 ? Spill->InMemory : Spill->WindowStart + Spill->WindowRows;
+
+    if (Next >= Spill->Rows)
+    {
+      Current= NULL;
+    }
+    else if ((Current= MADB_SpillWindow(Spill, Next, MADB_SPILL_WINDOW)) == NULL)
+    {
+      return 1;
+    }
+  }
+
+  if (Current == NULL)
+  {
+    stmt->state= MYSQL_STMT_FETCH_DONE;
+    return MYSQL_NO_DATA;
+  }
+
+  stmt->state= MYSQL_STMT_USER_FETCHING;
+  *Row= (unsigned char *)Current->data;
+  stmt->result_cursor= Current->next;
+
+  return 0;
+}
+/* }}} */
+
+/* {{{ MADB_StoreResult - stores statement's result for scrollable cursor. If connection's CURSOR_MEMORY_LIMIT is set,
+       rows are read one by one, and data of rows, that exceed it, go to the temporary file. The same way rows are read if
+       SQL_ATTR_MAX_LENGTH is set, to store only cut values. Has to be called inside the lock */
+SQLRETURN MADB_StoreResult(MADB_Stmt *Stmt)
+{
+  MYSQL_STMT   *stmt=     Stmt->stmt;
+  MADB_Dbc     *Dbc=      Stmt->Connection;
+  size_t        Budget=   (size_t)Dbc->Dsn->CursorMemoryLimit * 1024 * 1024;
+  unsigned long Limit=    Stmt->ResultMaxLength;
+  BOOL          Utf8=     MADB_IS_UTF8(Dbc->Charset.cs_info);
+  MADB_Spill   *Spill;
+  MYSQL_ROWS  **Next, *Row;
+  char         *SavedFlag= NULL;
+  unsigned int  ServerStatus, i;
+  my_bool       Spilling= FALSE;
+  int           rc;
+  SQLRETURN     ret=      SQL_SUCCESS;
+
+  MADB_SpillFree(Stmt);
+  MADB_ROWINDEX_RESET(Stmt);
+
+  mariadb_get_infov(Dbc->mariadb, MARIADB_CONNECTION_SERVER_STATUS, (void*)&ServerStatus);
+
+  /* Unless the result is going to be read row by row, C/C stores it */
+  if ((Budget == 0 && Limit == 0) || stmt->state != MYSQL_STMT_WAITING_USE_OR_STORE || (ServerStatus & SERVER_STATUS_CURSOR_EXISTS))
+  {
+    MDBUG_C_PRINT(Dbc, "mysql_stmt_store_result(%0x)", stmt);
+    if (mysql_stmt_store_result(stmt))
+    {
+      return MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, stmt);
+    }
+    return SQL_SUCCESS;
+  }
+
+  if ((Spill= (MADB_Spill *)MADB_CALLOC(sizeof(MADB_Spill))) == NULL ||
+      (stmt->bind != NULL && (SavedFlag= (char *)MADB_CALLOC(stmt->field_count)) == NULL))
+  {
+    MADB_FREE(Spill);
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+  }
+  Stmt->Spill=          Spill;
+  Spill->Stmt=          Stmt;
+  Spill->Handle=        stmt;
+  Spill->End[1].length= 1;
+  Spill->Load=          MADB_SpillFileLoad;
+  Next=                 &Spill->First;
+
+  /* We need raw rows - C/C does not need to convert them into application's buffers */
+  if (stmt->bind != NULL)
+  {
+    for (i= 0; i < stmt->field_count; ++i)
+    {
+      SavedFlag[i]= stmt->bind[i].flags & MADB_BIND_DUMMY;
+      stmt->bind[i].flags|= MADB_BIND_DUMMY;
+    }
+  }
+
+  MDBUG_C_PRINT(Dbc, "MADB_StoreResult(%0x) budget %lu", stmt, (unsigned long)Budget);
+  while ((rc= mysql_stmt_fetch(stmt)) == 0 || rc == MYSQL_DATA_TRUNCATED)
+  {
+    /* Unbuffered fetch leaves the row packet in the connection's buffer */
+    unsigned char *Packet= stmt->mysql->net.read_pos;
+    unsigned long  Length;
+
+    if (Limit > 0)
+    {
+      MADB_SpillCutRow(stmt, Packet, Limit, Utf8);
+    }
+    Length= MADB_SpillRowLength(stmt, Packet);
+
+    if (!Spilling && Budget > 0 && Dbc->CursorMemory + sizeof(MYSQL_ROWS) + Length > Budget)
+    {
+      if ((Spill->File= MADB_OpenTmpFile()) == NULL)
+      {
+        ret= MADB_SetError(&Stmt->Error, MADB_ERR_HY000, "Could not create temporary file for cursor rows exceeding CURSOR_MEMORY_LIMIT", 0);
+        break;
+      }
+      MDBUG_C_PRINT(Dbc, "Spilling rows of %0x starting from %llu", stmt, Spill->Rows);
+      Spilling= TRUE;
+    }
+    if (Spilling)
+    {
+      /* Rows in the file do not get nodes, only offset of every MADB_SPILL_INDEX_STEP'th of them is kept */
+      if ((Spill->Rows - Spill->InMemory) % MADB_SPILL_INDEX_STEP == 0 && !MADB_SpillIndexAdd(Spill, Spill->FileSize))
+      {
+        ret= MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+        break;
+      }
+      if (fwrite(Packet, 1, Length, Spill->File) != Length)
+      {
+        ret= MADB_SetError(&Stmt->Error, MADB_ERR_HY000, "Could not write cursor rows to temporary file", 0);
+        break;
+      }
+      Spill->FileSize+= Length;
+    }
+    else
+    {
+      if ((Row= (MYSQL_ROWS *)MADB_SpillAlloc(Spill, sizeof(MYSQL_ROWS) + Length)) == NULL)
+      {
+        ret= MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+        break;
+      }
+      Row->data=   (MYSQL_ROW)(Row + 1);
+      memcpy(Row->data, Packet, Length);
+      Row->length= Length;
+      Row->next=   NULL;
+      *Next=       Row;
+      Next=        &Row->next;
+      ++Spill->InMemory;
+    }
+    ++Spill->Rows;
+  }
+
+  if (rc == 1)
+  {
+    ret= MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, stmt);
+  }
+  else if (ret == SQL_ERROR)
+  {
+    /* Rest of the result still has to be read from the connection */
+    while ((rc= mysql_stmt_fetch(stmt)) == 0 || rc == MYSQL_DATA_TRUNCATED);
+  }
+
+  if (stmt->bind != NULL)
+  {
+    for (i= 0; i < stmt->field_count; ++i)
+    {
+      stmt->bind[i].flags&= (~MADB_BIND_DUMMY | SavedFlag[i]);
+    }
+  }
+  MADB_FREE(SavedFlag);
+
+  if (ret != SQL_ERROR && Spill->FileSize > 0)
+  {
+    if ((Spill->Map= MADB_MapTmpFile(Spill->File, Spill->FileSize)) == NULL)
+    {
+      ret= MADB_SetError(&Stmt->Error, MADB_ERR_HY000, "Could not map temporary file with cursor rows", 0);
+    }
+    else
+    {
+      /* Rows in memory are followed by the sentinel, which brings rows from the file into the window */
+      *Next= &Spill->End[0];
+    }
+  }
+
+  if (ret == SQL_ERROR)
+  {
+    MADB_SpillFree(Stmt);
+    return ret;
+  }
+
+  /* Installing rows the way mysql_stmt_store_result does */
+  stmt->result.data=    Spill->First;
+  stmt->result.rows=    Spill->Rows;
+  stmt->result_cursor=  Spill->First;
+  stmt->fetch_row_func= MADB_SpillFetchRow;
+  stmt->state=          MYSQL_STMT_USE_OR_STORE_CALLED;
+
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_SpillOnDemand - installs the result of Rows rows, none of which is in memory. Rows are put into the window by
+       Load, when they are fetched. Source is freed with the result */
+SQLRETURN MADB_SpillOnDemand(MADB_Stmt *Stmt, unsigned long long Rows, MADB_SpillLoad Load, void *Source,
+                             void (*FreeSource)(void *Source))
+{
+  MYSQL_STMT *stmt= Stmt->stmt;
+  MADB_Spill *Spill;
+
+  MADB_SpillFree(Stmt);
+  MADB_ROWINDEX_RESET(Stmt);
+
+  if ((Spill= (MADB_Spill *)MADB_CALLOC(sizeof(MADB_Spill))) == NULL)
+  {
+    FreeSource(Source);
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+  }
+  Stmt->Spill=          Spill;
+  Spill->Stmt=          Stmt;
+  Spill->Handle=        stmt;
+  Spill->End[1].length= 1;
+  Spill->Rows=          Rows;
+  Spill->Load=          Load;
+  Spill->Source=        Source;
+  Spill->FreeSource=    FreeSource;
+  Spill->First=         Rows > 0 ? &Spill->End[0] : NULL;
+
+  stmt->result.data=    Spill->First;
+  stmt->result.rows=    Rows;
+  stmt->result_cursor=  Spill->First;
+  stmt->fetch_row_func= MADB_SpillFetchRow;
+  stmt->state=          MYSQL_STMT_USE_OR_STORE_CALLED;
+
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_SpillSeek - positions C/C cursor on the row Position, that is not in memory. Rows from Position to Position + Count
+       are put into the window, unless they are there already */
+SQLRETURN MADB_SpillSeek(MADB_Stmt *Stmt, unsigned long long Position, unsigned long long Count)
+{
+  MADB_Spill *Spill= Stmt->Spill;
+  MYSQL_ROWS *Row=   NULL;
+
+  if (Position < Spill->Rows)
+  {
+    Count= MIN(MAX(Count, 1), Spill->Rows - Position);
+
+    if (Spill->WindowRows > 0 && Position >= Spill->WindowStart &&
+        Position + Count <= Spill->WindowStart + Spill->WindowRows)
+    {
+      Row= &Spill->Window[Position - Spill->WindowStart];
+    }
+    else if ((Row= MADB_SpillWindow(Spill, Position, Count)) == NULL)
+    {
+      return Stmt->Error.ReturnValue == SQL_ERROR ? SQL_ERROR : MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+    }
+  }
+
+  Stmt->stmt->result_cursor= Row;
+  Stmt->stmt->state=         MYSQL_STMT_USER_FETCHING;
+
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_SpillFree - releases memory and temporary file of the stored result, and returns the memory to connection's budget */
+void MADB_SpillFree(MADB_Stmt *Stmt)
+{
+  MADB_Spill *Spill= Stmt->Spill;
+
+  if (Spill == NULL)
+  {
+    return;
+  }
+  Stmt->Spill= NULL;
+
+  /* Statement handle may be closed, or its result freed by C/C already */
+  if (Stmt->stmt != NULL && Stmt->stmt == Spill->Handle && Stmt->stmt->result.data == Spill->First)
+  {
+    Stmt->stmt->result.data=   NULL;
+    Stmt->stmt->result.rows=   0;
+    Stmt->stmt->result_cursor= NULL;
+  }
+
+  if (Spill->Map != NULL)
+  {
+    MADB_UnmapTmpFile(Spill->Map, Spill->FileSize);
+  }
+  if (Spill->File != NULL)
+  {
+    fclose(Spill->File);
+  }
+  if (Spill->FreeSource != NULL)
+  {
+    Spill->FreeSource(Spill->Source);
+  }
+  MADB_FREE(Spill->Index);
+  MADB_FREE(Spill->Window);
+  while (Spill->Chunks != NULL)
+  {
+    MADB_SpillChunk *Prev= Spill->Chunks->Prev;
+
+    MADB_FREE(Spill->Chunks);
+    Spill->Chunks= Prev;
+  }
+
+  LOCK_MARIADB(Stmt->Connection);
+  Stmt->Connection->CursorMemory-= Spill->Memory;
+  UNLOCK_MARIADB(Stmt->Connection);
+
+  MADB_FREE(Spill);
+}
+/* }}} */
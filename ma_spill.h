@@ -0,0 +1,91 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+/* Buffering of static cursor results under per-connection memory budget. Rows, that do not fit into the budget, are
+ * written into temporary file, which is memory-mapped once the result is read. Rows in memory are installed into C/C
+ * statement handle as the list, the same way mysql_stmt_store_result does. Rows in the file do not get list nodes - the
+ * list ends with the sentinel, reaching which C/C's fetch_row_func puts the nodes of the next window of rows in place. Thus
+ * the cursor is still scrolled with mysql_stmt_data_seek/mysql_stmt_fetch regardless of where rows data are.
+ * Rows of a result may also be loaded on demand only, by the loader other than the temporary file(see ma_keyset.c).
+ * The budget is a soft limit - the index of rows in the file, and nodes of the window are counted against it, but they are
+ * allocated even if the budget is exhausted */
+
+#ifndef _ma_spill_h_
+#define _ma_spill_h_
+
+typedef struct st_ma_spill_chunk
+{
+  struct st_ma_spill_chunk *Prev;
+  size_t                    Size;
+  size_t                    Used;
+} MADB_SpillChunk;
+
+struct st_ma_spill;
+/* Fills data and length of Count nodes of the window with rows starting from First */
+typedef BOOL (*MADB_SpillLoad)(struct st_ma_spill *Spill, unsigned long long First, unsigned long Count);
+
+typedef struct st_ma_spill
+{
+  MYSQL_ROWS         End[2];      /* Has to be 1st member. Sentinels ending rows in memory, and the window. length is the index */
+  MADB_Stmt         *Stmt;
+  MYSQL_STMT        *Handle;      /* C/C statement handle rows list is installed into */
+  MYSQL_ROWS        *First;       /* Head of the list installed as result.data */
+  unsigned long long Rows;
+  unsigned long long InMemory;    /* Number of rows in the list, they go first */
+  MADB_SpillChunk   *Chunks;      /* Rows list and data of rows, that fit into the budget */
+  size_t             Memory;      /* Bytes accounted in connection's CursorMemory */
+  FILE              *File;
+  char              *Map;
+  size_t             FileSize;
+  size_t            *Index;       /* Offset in the file of every MADB_SPILL_INDEX_STEP'th row there */
+  size_t             IndexCount;
+  size_t             IndexAllocated;
+  MYSQL_ROWS        *Window;      /* Nodes of the rows, that are not in memory */
+  unsigned long      WindowAllocated;
+  unsigned long      WindowRows;
+  unsigned long long WindowStart;
+  MADB_SpillLoad     Load;
+  void              *Source;      /* Whatever Load needs, freed with FreeSource */
+  void             (*FreeSource)(void *Source);
+} MADB_Spill;
+
+#define MADB_SPILL_CHUNK_SIZE 65536
+#define MADB_SPILL_INDEX_STEP 64
+/* Minimal number of rows put in the window at once */
+#define MADB_SPILL_WINDOW     64
+
+/* If the row Position of aStmt's result is not in memory, and has to be in the window */
+#define MADB_SPILL_WINDOWED(aStmt, aPosition) ((aStmt)->Spill != NULL && (aStmt)->Spill->Handle == (aStmt)->stmt &&\
+  (aStmt)->stmt->result.data == (aStmt)->Spill->First && (unsigned long long)(aPosition) >= (aStmt)->Spill->InMemory)
+/* Number of rows of aStmt's stored result, that are in the list */
+#define MADB_SPILL_IN_MEMORY(aStmt) ((aStmt)->Spill != NULL && (aStmt)->Spill->Handle == (aStmt)->stmt &&\
+  (aStmt)->stmt->result.data == (aStmt)->Spill->First ? (aStmt)->Spill->InMemory : (aStmt)->stmt->result.rows)
+
+SQLRETURN MADB_StoreResult  (MADB_Stmt *Stmt);
+SQLRETURN MADB_SpillOnDemand(MADB_Stmt *Stmt, unsigned long long Rows, MADB_SpillLoad Load, void *Source,
+                             void (*FreeSource)(void *Source));
+SQLRETURN MADB_SpillSeek    (MADB_Stmt *Stmt, unsigned long long Position, unsigned long long Count);
+void      MADB_SpillFree    (MADB_Stmt *Stmt);
+
+/* Platform specific, implemented in ma_platform_*.c */
+FILE* MADB_OpenTmpFile (void);
+char* MADB_MapTmpFile  (FILE *File, size_t Size);
+void  MADB_UnmapTmpFile(char *Map, size_t Size);
+
+#endif
@@ -85,12 +85,24 @@ error:
 }
 /* }}} */
 
+/* {{{ MADB_SchemaChanged - cached statements have been prepared in the schema, that has just been changed by successfully
+       executed USE. Has to be called inside the connection's lock */
+static void MADB_SchemaChanged(MADB_Stmt *Stmt)
+{
+  if (MADB_CompareToken(&Stmt->Query, 0, "USE", 3, NULL))
+  {
+    MADB_PsCacheClear(Stmt->Connection);
+  }
+}
+/* }}} */
+
 /* {{{ MADB_ExecuteQuery */
 SQLRETURN MADB_ExecuteQuery(MADB_Stmt * Stmt, char *StatementText, SQLINTEGER TextLength)
 {
   SQLRETURN ret= SQL_ERROR;
   
   LOCK_MARIADB(Stmt->Connection);
+  MADB_StoreStreamer(Stmt->Connection, Stmt);
   if (StatementText)
   {
     MDBUG_C_PRINT(Stmt->Connection, "mysql_real_query(%0x,%s,%lu)", Stmt->Connection->mariadb, StatementText, TextLength);
@@ -100,6 +112,8 @@ SQLRETURN MADB_ExecuteQuery(MADB_Stmt * Stmt, char *StatementText, SQLINTEGER Te
       MADB_CLEAR_ERROR(&Stmt->Error);
 
       Stmt->AffectedRows= mysql_affected_rows(Stmt->Connection->mariadb);
+      /* The connection is locked above */
+      MADB_SchemaChanged(Stmt);
     }
     else
     {
@@ -176,6 +190,9 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
   case SQL_CLOSE:
     if (Stmt->stmt)
     {
+      MADB_StoreStreamer(Stmt->Connection, Stmt);
+      MADB_SpillFree(Stmt);
+      MADB_ArrowDetach(Stmt);
       if (Stmt->Ird)
         MADB_DescFree(Stmt->Ird, TRUE);
       if (Stmt->State > MADB_SS_PREPARED && !QUERY_IS_MULTISTMT(Stmt->Query))
@@ -207,12 +224,16 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
       MADB_FREE(Stmt->result);
       MADB_FREE(Stmt->CharOffset);
       MADB_FREE(Stmt->Lengths);
+      MADB_FREE(Stmt->ColumnLengths);
+      MADB_ArenaReset(&Stmt->Scratch);
+      MADB_ROWINDEX_RESET(Stmt);
 
       RESET_STMT_STATE(Stmt);
       RESET_DAE_STATUS(Stmt);
     }
     break;
   case SQL_UNBIND:
+    MADB_PrefetchWait(Stmt);
     MADB_FREE(Stmt->result);
     MADB_DescFree(Stmt->Ard, TRUE);
     break;
@@ -222,6 +243,12 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
     RESET_DAE_STATUS(Stmt);
     break;
   case SQL_DROP:
+    MADB_ArrowDetach(Stmt);
+    MADB_PrefetchFree(Stmt);
+    MADB_SpillFree(Stmt);
+    MADB_FetchPlanFree(Stmt);
+    MADB_ArenaFree(&Stmt->Scratch);
+    MADB_RowIndexFree(Stmt);
     MADB_FREE(Stmt->params);
     MADB_FREE(Stmt->result);
     MADB_FREE(Stmt->Cursor.Name);
@@ -257,6 +284,7 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
 
     MADB_FREE(Stmt->CharOffset);
     MADB_FREE(Stmt->Lengths);
+    MADB_FREE(Stmt->ColumnLengths);
     ResetMetadata(&Stmt->DefaultsResult, NULL);
 
     if (Stmt->DaeStmt != NULL)
@@ -265,6 +293,7 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
       Stmt->DaeStmt= NULL;
     }
     EnterCriticalSection(&Stmt->Connection->cs);
+    MADB_StoreStreamer(Stmt->Connection, Stmt);
     /* TODO: if multistatement was prepared, but not executed, we would get here Stmt->stmt leaked. Unlikely that is very probable scenario,
              thus leaving this for new version */
     if (QUERY_IS_MULTISTMT(Stmt->Query) && Stmt->MultiStmts)
@@ -284,7 +313,7 @@ SQLRETURN MADB_StmtFree(MADB_Stmt *Stmt, SQLUSMALLINT Option)
       MADB_FREE(Stmt->MultiStmts);
       Stmt->MultiStmtNr= 0;
     }
-    else if (Stmt->stmt != NULL)
+    else if (Stmt->stmt != NULL && !MADB_PsCacheCheckIn(Stmt))
     {
       MDBUG_C_PRINT(Stmt->Connection, "-->closing %0x", Stmt->stmt);
       MADB_STMT_CLOSE_STMT(Stmt);
@@ -308,6 +337,8 @@ BOOL MADB_CheckIfExecDirectPossible(MADB_Stmt *Stmt)
 {
   return MADB_ServerSupports(Stmt->Connection, MADB_CAPABLE_EXEC_DIRECT)
       && !(Stmt->Apd->Header.ArraySize > 1)                              /* With array of parameters exec_direct will be not optimal */
+      && !MADB_STMT_USE_SERVER_CURSOR(Stmt)                              /* Cursor is opened for regularly prepared statement */
+      && Stmt->Options.CursorType != SQL_CURSOR_KEYSET_DRIVEN            /* Keys are looked up in metadata of prepared statement */
       && MADB_FindNextDaeParam(Stmt->Apd, -1, 1) == MADB_NOPARAM;
 }
 /* }}} */
@@ -390,6 +421,9 @@ MYSQL_RES* FetchMetadata(MADB_Stmt *Stmt)
 /* {{{ MADB_StmtReset - reseting Stmt handler for new use. Has to be called inside a lock */
 void MADB_StmtReset(MADB_Stmt *Stmt)
 {
+  MADB_SpillFree(Stmt);
+  MADB_ROWINDEX_RESET(Stmt);
+
   if (!QUERY_IS_MULTISTMT(Stmt->Query) || Stmt->MultiStmts == NULL)
   {
     if (Stmt->State > MADB_SS_PREPARED)
@@ -400,8 +434,11 @@ void MADB_StmtReset(MADB_Stmt *Stmt)
 
     if (Stmt->State >= MADB_SS_PREPARED)
     {
-      MDBUG_C_PRINT(Stmt->Connection, "-->closing %0x", Stmt->stmt);
-      MADB_STMT_CLOSE_STMT(Stmt);
+      if (!MADB_PsCacheCheckIn(Stmt))
+      {
+        MDBUG_C_PRINT(Stmt->Connection, "-->closing %0x", Stmt->stmt);
+        MADB_STMT_CLOSE_STMT(Stmt);
+      }
       Stmt->stmt= MADB_NewStmtHandle(Stmt);
 
       MDBUG_C_PRINT(Stmt->Connection, "-->inited %0x", Stmt->stmt);
@@ -423,6 +460,7 @@ void MADB_StmtReset(MADB_Stmt *Stmt)
     MADB_FREE(Stmt->result);
     MADB_FREE(Stmt->CharOffset);
     MADB_FREE(Stmt->Lengths);
+    MADB_FREE(Stmt->ColumnLengths);
     RESET_DAE_STATUS(Stmt);
 
   case MADB_SS_PREPARED:
@@ -445,6 +483,7 @@ void MADB_StmtReset(MADB_Stmt *Stmt)
     }
   default:
     Stmt->PositionedCommand= 0;
+    Stmt->PsCacheable= FALSE;
     Stmt->State= MADB_SS_INITED;
     MADB_CLEAR_ERROR(&Stmt->Error);
   }
@@ -473,27 +512,42 @@ SQLRETURN MADB_EDPrepare(MADB_Stmt *Stmt)
 (i.e. we aren't going to do mariadb_stmt_exec_direct) */
 SQLRETURN MADB_RegularPrepare(MADB_Stmt *Stmt)
 {
+  /* Positioned command's text depends on the cursor, and is not worth caching */
+  BOOL        Cacheable= !Stmt->PositionedCommand && !QUERY_IS_MULTISTMT(Stmt->Query);
+  MYSQL_STMT *Cached=    NULL;
+
   LOCK_MARIADB(Stmt->Connection);
 
-  MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_prepare(%0x,%s)", Stmt->stmt, STMT_STRING(Stmt));
-  if (mysql_stmt_prepare(Stmt->stmt, STMT_STRING(Stmt), (unsigned long)strlen(STMT_STRING(Stmt))))
+  if (Cacheable && (Cached= MADB_PsCacheCheckOut(Stmt->Connection, STMT_STRING(Stmt))) != NULL)
   {
-    /* Need to save error first */
-    MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
-    /* We need to close the stmt here, or it becomes unusable like in ODBC-21 */
-    MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_close(%0x)", Stmt->stmt);
-    MADB_STMT_CLOSE_STMT(Stmt);
-    Stmt->stmt= MADB_NewStmtHandle(Stmt);
+    /* Parameters and result metadata are in the cached handle already */
+    MDBUG_C_PRINT(Stmt->Connection, "-->taking %0x from cache", Cached);
+    mysql_stmt_close(Stmt->stmt);
+    Stmt->stmt= Cached;
+  }
+  else
+  {
+    MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_prepare(%0x,%s)", Stmt->stmt, STMT_STRING(Stmt));
+    if (mysql_stmt_prepare(Stmt->stmt, STMT_STRING(Stmt), (unsigned long)strlen(STMT_STRING(Stmt))))
+    {
+      /* Need to save error first */
+      MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
+      /* We need to close the stmt here, or it becomes unusable like in ODBC-21 */
+      MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_close(%0x)", Stmt->stmt);
+      MADB_STMT_CLOSE_STMT(Stmt);
+      Stmt->stmt= MADB_NewStmtHandle(Stmt);
 
-    UNLOCK_MARIADB(Stmt->Connection);
+      UNLOCK_MARIADB(Stmt->Connection);
 
-    MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_init(%0x)->%0x", Stmt->Connection->mariadb, Stmt->stmt);
+      MDBUG_C_PRINT(Stmt->Connection, "mysql_stmt_init(%0x)->%0x", Stmt->Connection->mariadb, Stmt->stmt);
 
-    return Stmt->Error.ReturnValue;
+      return Stmt->Error.ReturnValue;
+    }
   }
   UNLOCK_MARIADB(Stmt->Connection);
 
-  Stmt->State= MADB_SS_PREPARED;
+  Stmt->State=       MADB_SS_PREPARED;
+  Stmt->PsCacheable= (my_bool)Cacheable;
 
   /* If we have result returning query - fill descriptor records with metadata */
   if (mysql_stmt_field_count(Stmt->stmt) > 0)
@@ -525,6 +579,7 @@ SQLRETURN MADB_StmtPrepare(MADB_Stmt *Stmt, char *StatementText, SQLINTEGER Text
 
   LOCK_MARIADB(Stmt->Connection);
 
+  MADB_StoreStreamer(Stmt->Connection, Stmt);
   MADB_StmtReset(Stmt);
 
   /* After this point we can't have SQL_NTS*/
@@ -536,7 +591,12 @@ SQLRETURN MADB_StmtPrepare(MADB_Stmt *Stmt, char *StatementText, SQLINTEGER Text
     return MADB_SetError(&Stmt->Error, MADB_ERR_42000, NULL, 0);
   }
   MADB_ResetParser(Stmt, StatementText, TextLength);
-  MADB_ParseQuery(&Stmt->Query);
+  /* Long query, that has been prepared before, does not need to be parsed again */
+  if (!MADB_QCacheGet(Stmt, StatementText, TextLength))
+  {
+    MADB_ParseQuery(&Stmt->Query);
+    MADB_QCachePut(Stmt, StatementText, TextLength);
+  }
 
   if ((Stmt->Query.QueryType == MADB_QUERY_INSERT || Stmt->Query.QueryType == MADB_QUERY_UPDATE || Stmt->Query.QueryType == MADB_QUERY_DELETE)
     && MADB_FindToken(&Stmt->Query, "RETURNING"))
@@ -797,6 +857,9 @@ SQLRETURN MADB_StmtPutData(MADB_Stmt *Stmt, SQLPOINTER DataPtr, SQLLEN StrLen_or
   /* To make sure that we will not consume the doble amount of memory, we need to send
      data via mysql_send_long_data directly to the server instead of allocating a separate
      buffer. This means we need to process Update and Insert statements row by row. */
+  LOCK_MARIADB(Stmt->Connection);
+  /* Other statement's result may still be streamed, or prefetched in the background */
+  MADB_StoreStreamer(Stmt->Connection, MyStmt);
   if (mysql_stmt_send_long_data(MyStmt->stmt, Stmt->PutParam, (ConvertedDataPtr ? (char *)ConvertedDataPtr : DataPtr), (unsigned long)Length))
   {
     MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, MyStmt->stmt);
@@ -805,6 +868,7 @@ SQLRETURN MADB_StmtPutData(MADB_Stmt *Stmt, SQLPOINTER DataPtr, SQLLEN StrLen_or
   {
     Record->InternalLength+= (unsigned long)Length;
   }
+  UNLOCK_MARIADB(Stmt->Connection);
 
   MADB_FREE(ConvertedDataPtr);
   return Stmt->Error.ReturnValue;
@@ -827,8 +891,12 @@ SQLRETURN MADB_ExecutePositionedUpdate(MADB_Stmt *Stmt, BOOL ExecDirect)
     MADB_SetError(&Stmt->Error, MADB_ERR_34000, "Cursor has no result set or is not open", 0);
     return Stmt->Error.ReturnValue;
   }
-  MADB_StmtDataSeek(Stmt->PositionedCursor, Stmt->PositionedCursor->Cursor.Position);
-  Stmt->Methods->RefreshRowPtrs(Stmt->PositionedCursor);
+  /* Forward-only cursor can't go back, but it stays on the last fetched row anyway */
+  if (Stmt->PositionedCursor->Options.CursorType != SQL_CURSOR_FORWARD_ONLY)
+  {
+    MADB_StmtDataSeek(Stmt->PositionedCursor, Stmt->PositionedCursor->Cursor.Position);
+    Stmt->Methods->RefreshRowPtrs(Stmt->PositionedCursor);
+  }
 
   memcpy(&Stmt->Apd->Header, &Stmt->Ard->Header, sizeof(MADB_Header));
   
@@ -955,6 +1023,34 @@ static void ResetInternalLength(MADB_Stmt *Stmt, unsigned int ParamOffset)
 }
 /* }}} */
 
+/* {{{ MADB_SetServerCursor - sets cursor type the statement is going to be executed with. For read-only server side cursor
+       rows are read with COM_STMT_FETCH in batches, and only the current batch is kept in client's memory */
+void MADB_SetServerCursor(MADB_Stmt *Stmt)
+{
+  unsigned long CursorType=   CURSOR_TYPE_NO_CURSOR,
+                PrefetchRows= 1;
+
+  if (MADB_STMT_USE_SERVER_CURSOR(Stmt))
+  {
+    CursorType=   CURSOR_TYPE_READ_ONLY;
+    PrefetchRows= MADB_STMT_PREFETCH_ROWS(Stmt);
+  }
+  mysql_stmt_attr_set(Stmt->stmt, STMT_ATTR_CURSOR_TYPE, (void*)&CursorType);
+  mysql_stmt_attr_set(Stmt->stmt, STMT_ATTR_PREFETCH_ROWS, (void*)&PrefetchRows);
+}
+/* }}} */
+
+/* {{{ MADB_ServerCursorExists - whether server has opened the cursor for the result of last execution. Then rows are
+       requested from it in batches, and the connection is free in between */
+BOOL MADB_ServerCursorExists(MADB_Stmt *Stmt)
+{
+  unsigned int ServerStatus= 0;
+
+  mariadb_get_infov(Stmt->Connection->mariadb, MARIADB_CONNECTION_SERVER_STATUS, (void*)&ServerStatus);
+  return test(ServerStatus & SERVER_STATUS_CURSOR_EXISTS);
+}
+/* }}} */
+
 /* {{{ MADB_DoExecute */
 /* Actually executing on the server, doing required actions with C API, and processing execution result */
 SQLRETURN MADB_DoExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
@@ -991,6 +1087,8 @@ SQLRETURN MADB_DoExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
     unsigned int ServerStatus;
 
     Stmt->State= MADB_SS_EXECUTED;
+    /* Callers execute inside the connection's lock */
+    MADB_SchemaChanged(Stmt);
 
     mariadb_get_infov(Stmt->Connection->mariadb, MARIADB_CONNECTION_SERVER_STATUS, (void*)&ServerStatus);
     if (ServerStatus & SERVER_PS_OUT_PARAMS)
@@ -1035,11 +1133,18 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
   SQLULEN      j, Start=      0;
   /* For multistatement direct execution */
   char        *CurQuery= Stmt->Query.RefinedText, *QueriesEnd= Stmt->Query.RefinedText + Stmt->Query.RefinedLength;
+  MADB_Keyset *Keyset=   NULL;
 
   MDBUG_C_PRINT(Stmt->Connection, "%sMADB_StmtExecute", "\t->");
 
   MADB_CLEAR_ERROR(&Stmt->Error);
 
+  /* Dynamic cursors of the connection should see the changes */
+  if (QUERY_DOESNT_RETURN_RESULT(Stmt->Query.QueryType) || QUERY_IS_MULTISTMT(Stmt->Query))
+  {
+    ++Stmt->Connection->Changes;
+  }
+
   if (Stmt->State == MADB_SS_EMULATED)
   {
     return MADB_ExecuteQuery(Stmt, STMT_STRING(Stmt), (SQLINTEGER)strlen(STMT_STRING(Stmt)));
@@ -1067,9 +1172,21 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
   }
 
   LOCK_MARIADB(Stmt->Connection);
+  MADB_StoreStreamer(Stmt->Connection, Stmt);
+  MADB_SpillFree(Stmt);
   Stmt->AffectedRows= 0;
   Start+= Stmt->ArrayOffset;
 
+  if (!QUERY_IS_MULTISTMT(Stmt->Query))
+  {
+    MADB_SetServerCursor(Stmt);
+    /* Keys of the result are looked up before execution - nothing can be sent to the server while the result is read */
+    if (Stmt->Options.CursorType == SQL_CURSOR_KEYSET_DRIVEN)
+    {
+      Keyset= MADB_KeysetInit(Stmt);
+    }
+  }
+
   if (Stmt->Ipd->Header.RowsProcessedPtr)
   {
     *Stmt->Ipd->Header.RowsProcessedPtr= 0;
@@ -1122,6 +1239,7 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
       }
       
       Stmt->RebindParams= TRUE;
+      MADB_SetServerCursor(Stmt);
 
       if (Stmt->ParamCount != mysql_stmt_param_count(Stmt->stmt))
       {
@@ -1247,7 +1365,7 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
       /* MADB_CleanBulkOperData(Stmt, ParamOffset); */
       ParamOffset+= MADB_STMT_PARAM_COUNT(Stmt);
 
-      if (mysql_stmt_field_count(Stmt->stmt))
+      if (mysql_stmt_field_count(Stmt->stmt) && !MADB_STMT_LAZY_RESULT(Stmt))
       {
         mysql_stmt_store_result(Stmt->stmt);
       }
@@ -1266,18 +1384,38 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
   {
     MADB_StmtResetResultStructures(Stmt);
 
-    /* Todo: for SQL_CURSOR_FORWARD_ONLY we should use cursor and prefetch rows */
     /*************************** mysql_stmt_store_result ******************************/
-    /*If we did OUT params already, we should not store */
-    if (Stmt->State == MADB_SS_EXECUTED && mysql_stmt_store_result(Stmt->stmt) != 0)
+    /*If we did OUT params already, we should not store. Forward-only cursor reads rows from the connection as they are fetched */
+    if (MADB_STMT_IS_STREAMED(Stmt))
     {
-      UNLOCK_MARIADB(Stmt->Connection);
-      if (DefaultResult)
+      if (!MADB_ServerCursorExists(Stmt))
       {
-        mysql_free_result(DefaultResult);
+        Stmt->Connection->Streamer= Stmt;
       }
+    }
+    else if (Stmt->State == MADB_SS_EXECUTED)
+    {
+      /* Keyset-driven cursor falls back to static one, if the result has no complete key */
+      SQLRETURN StoreRc= Stmt->Options.CursorType == SQL_CURSOR_KEYSET_DRIVEN ? MADB_KeysetBuild(Stmt, &Keyset) :
+                                                                               MADB_StoreResult(Stmt);
+      if (!SQL_SUCCEEDED(StoreRc))
+      {
+        UNLOCK_MARIADB(Stmt->Connection);
+        if (DefaultResult)
+        {
+          mysql_free_result(DefaultResult);
+        }
 
-      return MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
+        return Stmt->Error.ReturnValue;
+      }
+      if (StoreRc == SQL_SUCCESS_WITH_INFO && ret == SQL_SUCCESS)
+      {
+        ret= SQL_SUCCESS_WITH_INFO;
+      }
+    }
+    if (Stmt->Options.CursorType == SQL_CURSOR_DYNAMIC)
+    {
+      MADB_DYNCURSOR_SET_REFRESHED(Stmt);
     }
     
     /* I don't think we can reliably establish the fact that we do not need to re-fetch the metadata, thus we are re-fetching always
@@ -1287,6 +1425,7 @@ SQLRETURN MADB_StmtExecute(MADB_Stmt *Stmt, BOOL ExecDirect)
     Stmt->AffectedRows= -1;
   }
 end:
+  MADB_KeysetFree(Keyset);
   UNLOCK_MARIADB(Stmt->Connection);
   Stmt->LastRowFetched= 0;
 
@@ -1499,152 +1638,38 @@ BOOL MADB_BinaryFieldType(SQLSMALLINT FieldType)
 }
 /* }}} */
 
-/* {{{ MADB_PrepareBind
-       Filling bind structures in */
-SQLRETURN MADB_PrepareBind(MADB_Stmt *Stmt, int RowNumber)
+/* {{{ MADB_FetchPlanFree */
+void MADB_FetchPlanFree(MADB_Stmt *Stmt)
 {
-  MADB_DescRecord *IrdRec, *ArdRec;
-  int             i;
-  void            *DataPtr= NULL;
+  MADB_FetchPlan *Plan= Stmt->FetchPlan;
+  SQLSMALLINT     i;
 
-  for (i= 0; i < MADB_STMT_COLUMN_COUNT(Stmt); ++i)
+  if (Plan == NULL)
   {
-    ArdRec= MADB_DescGetInternalRecord(Stmt->Ard, i, MADB_DESC_READ);
-    if (ArdRec == NULL || !ArdRec->inUse)
-    {      
-      Stmt->result[i].flags|= MADB_BIND_DUMMY;
-      continue;
-    }
-
-    DataPtr= (SQLLEN *)GetBindOffset(Stmt->Ard, ArdRec, ArdRec->DataPtr, RowNumber, ArdRec->OctetLength);
-
-    MADB_FREE(ArdRec->InternalBuffer);
-    if (!DataPtr)
-    {
-      Stmt->result[i].flags|= MADB_BIND_DUMMY;
-      continue;
-    }
-    else
-    {
-      Stmt->result[i].flags&= ~MADB_BIND_DUMMY;
-    }
-
-    IrdRec= MADB_DescGetInternalRecord(Stmt->Ird, i, MADB_DESC_READ);
-    /* assert(IrdRec != NULL) */
-
-    /* We can't use application's buffer directly, as it has/can have different size, than C/C needs */
-    Stmt->result[i].length= &Stmt->result[i].length_value;
+    return;
+  }
+  for (i= 0; i < Plan->ColumnCount; ++i)
+  {
+    MADB_FREE(Plan->Column[i].Buffer);
+  }
+  MADB_FREE(Plan->Column);
+  MADB_FREE(Plan->Bound);
+  MADB_FREE(Plan->Values);
+  MADB_ArenaFree(&Plan->Copies);
+  MADB_FREE(Stmt->FetchPlan);
+}
+/* }}} */
 
-    switch(ArdRec->ConciseType) {
-    case SQL_C_WCHAR:
-      /* In worst case for 2 bytes of UTF16 in result, we need 3 bytes of utf8.
-          For ASCII  we need 2 times less(for 2 bytes of UTF16 - 1 byte UTF8,
-          in other cases we need same 2 of 4 bytes. */
-      ArdRec->InternalBuffer=        (char *)MADB_CALLOC((size_t)((ArdRec->OctetLength)*1.5));
-      Stmt->result[i].buffer=        ArdRec->InternalBuffer;
-      Stmt->result[i].buffer_length= (unsigned long)(ArdRec->OctetLength*1.5);
-      Stmt->result[i].buffer_type=   MYSQL_TYPE_STRING;
-      break;
-    case SQL_C_CHAR:
-      Stmt->result[i].buffer=        DataPtr;
-      Stmt->result[i].buffer_length= (unsigned long)ArdRec->OctetLength;
-      Stmt->result[i].buffer_type=   MYSQL_TYPE_STRING;
-      break;
-    case SQL_C_NUMERIC:
-      MADB_FREE(ArdRec->InternalBuffer);
-      Stmt->result[i].buffer_length= MADB_DEFAULT_PRECISION + 1/*-*/ + 1/*.*/;
-      ArdRec->InternalBuffer=       (char *)MADB_CALLOC(Stmt->result[i].buffer_length);
-      Stmt->result[i].buffer=        ArdRec->InternalBuffer;
-      
-      Stmt->result[i].buffer_type=   MYSQL_TYPE_STRING;
-      break;
-    case SQL_TYPE_TIMESTAMP:
-    case SQL_TYPE_DATE:
-    case SQL_TYPE_TIME:
-    case SQL_C_TIMESTAMP:
-    case SQL_C_TIME:
-    case SQL_C_DATE:
-      MADB_FREE(ArdRec->InternalBuffer);
-      if (IrdRec->ConciseType == SQL_CHAR || IrdRec->ConciseType == SQL_VARCHAR)
-      {
-        ArdRec->InternalBuffer= (char *)MADB_CALLOC(Stmt->stmt->fields[i].max_length + 1);
-        if (ArdRec->InternalBuffer == NULL)
-        {
-          return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
-        }
-        Stmt->result[i].buffer=        ArdRec->InternalBuffer;
-        Stmt->result[i].buffer_type=   MYSQL_TYPE_STRING;
-        Stmt->result[i].buffer_length= Stmt->stmt->fields[i].max_length + 1;
-      }
-      else
-      {
-        ArdRec->InternalBuffer=       (char *)MADB_CALLOC(sizeof(MYSQL_TIME));
-        Stmt->result[i].buffer=        ArdRec->InternalBuffer;
-        Stmt->result[i].buffer_length= sizeof(MYSQL_TIME);
-        Stmt->result[i].buffer_type=   MYSQL_TYPE_TIMESTAMP;
-      }
-      break;
-    case SQL_C_INTERVAL_HOUR_TO_MINUTE:
-    case SQL_C_INTERVAL_HOUR_TO_SECOND:
-      {
-        MYSQL_FIELD *Field= mysql_fetch_field_direct(Stmt->metadata, i);
-        MADB_FREE(ArdRec->InternalBuffer);
-        if (IrdRec->ConciseType == SQL_CHAR || IrdRec->ConciseType == SQL_VARCHAR)
-        {
-          ArdRec->InternalBuffer= (char *)MADB_CALLOC(Stmt->stmt->fields[i].max_length + 1);
-          if (ArdRec->InternalBuffer == NULL)
-          {
-            return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
-          }
-          Stmt->result[i].buffer=        ArdRec->InternalBuffer;
-          Stmt->result[i].buffer_type=   MYSQL_TYPE_STRING;
-          Stmt->result[i].buffer_length= Stmt->stmt->fields[i].max_length + 1;
-        }
-        else
-        {
-          ArdRec->InternalBuffer=       (char *)MADB_CALLOC(sizeof(MYSQL_TIME));
-          Stmt->result[i].buffer=        ArdRec->InternalBuffer;
-          Stmt->result[i].buffer_length= sizeof(MYSQL_TIME);
-          Stmt->result[i].buffer_type=   Field && Field->type == MYSQL_TYPE_TIME ? MYSQL_TYPE_TIME : MYSQL_TYPE_TIMESTAMP;
-        }
-      }
-      break;
-    case SQL_C_TINYINT:
-    case SQL_C_UTINYINT:
-    case SQL_C_STINYINT:
-    case SQL_C_SHORT:
-    case SQL_C_SSHORT:
-    case SQL_C_USHORT:
-    case SQL_C_FLOAT:
-    case SQL_C_LONG:
-    case SQL_C_ULONG:
-    case SQL_C_SLONG:
-    case SQL_C_DOUBLE:
-      if (MADB_BinaryFieldType(IrdRec->ConciseType))
-      {
-        /* To keep things simple - we will use internal buffer of the column size, and later(in the MADB_FixFetchedValues) will copy (correct part of)
-           it to the application's buffer taking care of endianness. Perhaps it'd be better just not to support this type of conversion */
-        MADB_FREE(ArdRec->InternalBuffer);
-        ArdRec->InternalBuffer=        (char *)MADB_CALLOC(IrdRec->OctetLength);
-        Stmt->result[i].buffer=        ArdRec->InternalBuffer;
-        Stmt->result[i].buffer_length= (unsigned long)IrdRec->OctetLength;
-        Stmt->result[i].buffer_type=   MYSQL_TYPE_BLOB;
-        break;
-      }
-      /* else {we are falling through below} */
-    default:
-      if (!MADB_CheckODBCType(ArdRec->ConciseType))
-      {
-        return MADB_SetError(&Stmt->Error, MADB_ERR_07006, NULL, 0);
-      }
-      Stmt->result[i].buffer_length= (unsigned long)ArdRec->OctetLength;
-      Stmt->result[i].buffer=        DataPtr;
-      Stmt->result[i].buffer_type=   MADB_GetMaDBTypeAndLength(ArdRec->ConciseType,
-                                                            &Stmt->result[i].is_unsigned,
-                                                            &Stmt->result[i].buffer_length);
-      break;
-    }
+/* {{{ MADB_PlanBuffer - allocates conversion buffer of the plan's column, and binds it */
+static SQLRETURN MADB_PlanBuffer(MADB_Stmt *Stmt, MADB_FetchColumn *Column, size_t Size, enum enum_field_types Type)
+{
+  if (!(Column->Buffer= (char *)MADB_CALLOC(Size)))
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
   }
+  Column->Bind.buffer=        Column->Buffer;
+  Column->Bind.buffer_length= (unsigned long)Size;
+  Column->Bind.buffer_type=   Type;
 
   return SQL_SUCCESS;
 }
@@ -1671,263 +1696,870 @@ void SwitchEndianness(char *Src, SQLLEN SrcBytes, char *Dst, SQLLEN DstBytes)
 }
 /* }}} */
 
-#define CALC_ALL_FLDS_RC(_agg_rc, _field_rc) if (_field_rc != SQL_SUCCESS && _agg_rc != SQL_ERROR) _agg_rc= _field_rc 
+/* Converters of fetched values to application's buffers. Column's converter is chosen once in MADB_PrepareFetchPlan by the pair
+   of its IRD and ARD types. It's only called for not NULL values of columns, that have data buffer bound */
 
-/* {{{ MADB_FixFetchedValues 
-       Converting and/or fixing fetched values if needed */
-SQLRETURN MADB_FixFetchedValues(MADB_Stmt *Stmt, int RowNumber, MYSQL_ROW_OFFSET SaveCursor)
+/* {{{ MADB_FixLength - the value is already in the application's buffer */
+static SQLRETURN MADB_FixLength(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned int i, int RowNumber,
+                                void *DataPtr, SQLLEN *LengthPtr, SQLLEN *IndicatorPtr)
 {
-  MADB_DescRecord *IrdRec, *ArdRec;
-  int             i;
-  SQLLEN          *IndicatorPtr= NULL, *LengthPtr= NULL, Dummy= 0;
-  void            *DataPtr=      NULL;
-  SQLRETURN       rc= SQL_SUCCESS, FieldRc;
+  *LengthPtr= *Stmt->stmt->bind[i].length;
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_FixBit */
+static SQLRETURN MADB_FixBit(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned int i, int RowNumber,
+                             void *DataPtr, SQLLEN *LengthPtr, SQLLEN *IndicatorPtr)
+{
+  char *p= (char *)DataPtr;
+
+  *p= test(*p != '\0');
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_FixTimestamp - MYSQL_TIME to date/time C types */
+static SQLRETURN MADB_FixTimestamp(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned int i, int RowNumber,
+                                   void *DataPtr, SQLLEN *LengthPtr, SQLLEN *IndicatorPtr)
+{
+  return MADB_CopyMadbTimestamp(Stmt, (MYSQL_TIME *)Column->Buffer, DataPtr, LengthPtr, IndicatorPtr, Column->CType,
+                                Column->SqlType);
+}
+/* }}} */
+
+/* {{{ MADB_FixStrTimestamp - string to date/time C types */
+static SQLRETURN MADB_FixStrTimestamp(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned int i, int RowNumber,
+                                      void *DataPtr, SQLLEN *LengthPtr, SQLLEN *IndicatorPtr)
+{
+  MYSQL_TIME tm;
+  BOOL       isTime;
+  SQLRETURN  rc= MADB_Str2Ts(Column->Buffer, *Stmt->stmt->bind[i].length, &tm, FALSE, &Stmt->Error, &isTime);
 
-  for (i= 0; i < MADB_STMT_COLUMN_COUNT(Stmt); ++i)
+  if (!SQL_SUCCEEDED(rc))
   {
-    if ((ArdRec= MADB_DescGetInternalRecord(Stmt->Ard, i, MADB_DESC_READ)) && ArdRec->inUse)
-    {
-      /* set indicator and dataptr */
-      LengthPtr=    (SQLLEN *)GetBindOffset(Stmt->Ard, ArdRec, ArdRec->OctetLengthPtr, RowNumber, sizeof(SQLLEN));
-      IndicatorPtr= (SQLLEN *)GetBindOffset(Stmt->Ard, ArdRec, ArdRec->IndicatorPtr,   RowNumber, sizeof(SQLLEN));
-      DataPtr=      (SQLLEN *)GetBindOffset(Stmt->Ard, ArdRec, ArdRec->DataPtr,        RowNumber, ArdRec->OctetLength);
+    return rc;
+  }
+  return MADB_CopyMadbTimestamp(Stmt, &tm, DataPtr, LengthPtr, IndicatorPtr, Column->CType, Column->SqlType);
+}
+/* }}} */
 
-      if (LengthPtr == NULL)
-      {
-        LengthPtr= &Dummy;
-      }
-      /* clear IndicatorPtr */
-      if (IndicatorPtr != NULL && IndicatorPtr != LengthPtr && *IndicatorPtr < 0)
-      {
-        *IndicatorPtr= 0;
-      }
+/* {{{ MADB_TimeToInterval */
+static SQLRETURN MADB_TimeToInterval(MADB_Stmt *Stmt, MADB_FetchColumn *Column, MYSQL_TIME *tm, void *DataPtr,
+                                     SQLLEN *LengthPtr)
+{
+  SQL_INTERVAL_STRUCT *ts= (SQL_INTERVAL_STRUCT *)DataPtr;
 
-      IrdRec= MADB_DescGetInternalRecord(Stmt->Ird, i, MADB_DESC_READ);
-      /* assert(IrdRec != NULL) */
+  if (tm->hour > 99999)
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_22015, NULL, 0);
+  }
 
-      if (*Stmt->stmt->bind[i].is_null)
-      {
-        if (IndicatorPtr)
-        {
-          *IndicatorPtr= SQL_NULL_DATA;
-        }
-        else
-        {
-          if (SaveCursor)
-          {
-            mysql_stmt_row_seek(Stmt->stmt, SaveCursor);
-          }
-          rc= MADB_SetError(&Stmt->Error, MADB_ERR_22002, NULL, 0);
-          continue;
-        }
-      }
-      else
-      {
-        switch (ArdRec->ConciseType)
-        {
-        case SQL_C_BIT:
-        {
-          char *p= (char *)Stmt->result[i].buffer;
-          if (p)
-          {
-            *p= test(*p != '\0');
-          }
-        }
-        break;
-        case SQL_C_TYPE_TIMESTAMP:
-        case SQL_C_TYPE_DATE:
-        case SQL_C_TYPE_TIME:
-        case SQL_C_TIMESTAMP:
-        case SQL_C_TIME:
-        case SQL_C_DATE:
-          {
-            MYSQL_TIME tm, *Intermidiate;
+  ts->intval.day_second.hour=   tm->hour;
+  ts->intval.day_second.minute= tm->minute;
+  ts->interval_sign= tm->neg ? SQL_TRUE : SQL_FALSE;
 
-            if (IrdRec->ConciseType == SQL_CHAR || IrdRec->ConciseType == SQL_VARCHAR)
-            {
-              BOOL isTime;
+  if (Column->CType == SQL_C_INTERVAL_HOUR_TO_MINUTE)
+  {
+    ts->intval.day_second.second= 0;
+    ts->interval_type= SQL_INTERVAL_HOUR_TO_MINUTE;
+    if (tm->second)
+    {
+      return MADB_SetError(&Stmt->Error, MADB_ERR_01S07, NULL, 0);
+    }
+  }
+  else
+  {
+    ts->interval_type= SQL_INTERVAL_HOUR_TO_SECOND;
+    ts->intval.day_second.second= tm->second;
+  }
 
-              FieldRc= MADB_Str2Ts(ArdRec->InternalBuffer, *Stmt->stmt->bind[i].length, &tm, FALSE, &Stmt->Error, &isTime);
-              if (SQL_SUCCEEDED(FieldRc))
-              {
-                Intermidiate= &tm;
-              }
-              else
-              {
-                CALC_ALL_FLDS_RC(rc, FieldRc);
-                break;
-              }
-            }
-            else
-            {
-              Intermidiate= (MYSQL_TIME *)ArdRec->InternalBuffer;
-            }
+  *LengthPtr= sizeof(SQL_INTERVAL_STRUCT);
+  return SQL_SUCCESS;
+}
+/* }}} */
 
-            FieldRc= MADB_CopyMadbTimestamp(Stmt, Intermidiate, DataPtr, LengthPtr, IndicatorPtr, ArdRec->Type, IrdRec->ConciseType);
-            CALC_ALL_FLDS_RC(rc, FieldRc);
-          }
-          break;
-        case SQL_C_INTERVAL_HOUR_TO_MINUTE:
-        case SQL_C_INTERVAL_HOUR_TO_SECOND:
-        {
-          MYSQL_TIME          *tm= (MYSQL_TIME*)ArdRec->InternalBuffer, ForConversion;
-          SQL_INTERVAL_STRUCT *ts= (SQL_INTERVAL_STRUCT *)DataPtr;
+/* {{{ MADB_FixInterval - MYSQL_TIME to hour-to-minute/second intervals */
+static SQLRETURN MADB_FixInterval(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned int i, int RowNumber,
+                                  void *DataPtr, SQLLEN *LengthPtr, SQLLEN *IndicatorPtr)
+{
+  return MADB_TimeToInterval(Stmt, Column, (MYSQL_TIME *)Column->Buffer, DataPtr, LengthPtr);
+}
+/* }}} */
 
-          if (IrdRec->ConciseType == SQL_CHAR || IrdRec->ConciseType == SQL_VARCHAR)
-          {
-            BOOL isTime;
+/* {{{ MADB_FixStrInterval - string to hour-to-minute/second intervals */
+static SQLRETURN MADB_FixStrInterval(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned int i, int RowNumber,
+                                     void *DataPtr, SQLLEN *LengthPtr, SQLLEN *IndicatorPtr)
+{
+  MYSQL_TIME tm;
+  BOOL       isTime;
+  SQLRETURN  rc= MADB_Str2Ts(Column->Buffer, *Stmt->stmt->bind[i].length, &tm, FALSE, &Stmt->Error, &isTime);
 
-            FieldRc= MADB_Str2Ts(ArdRec->InternalBuffer, *Stmt->stmt->bind[i].length, &ForConversion, FALSE, &Stmt->Error, &isTime);
-            if (SQL_SUCCEEDED(FieldRc))
-            {
-              tm= &ForConversion;
-            }
-            else
-            {
-              CALC_ALL_FLDS_RC(rc, FieldRc);
-              break;
-            }
-          }
+  if (!SQL_SUCCEEDED(rc))
+  {
+    return rc;
+  }
+  return MADB_TimeToInterval(Stmt, Column, &tm, DataPtr, LengthPtr);
+}
+/* }}} */
 
-          /* If we have ts == NULL we (may) have tm also NULL, since we didn't really bind this column */
-          if (ts != NULL)
-          {
-            if (tm->hour > 99999)
-            {
-              FieldRc= MADB_SetError(&Stmt->Error, MADB_ERR_22015, NULL, 0);
-              CALC_ALL_FLDS_RC(rc, FieldRc);
-              break;
-            }
+/* {{{ MADB_FixNumeric */
+static SQLRETURN MADB_FixNumeric(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned int i, int RowNumber,
+                                 void *DataPtr, SQLLEN *LengthPtr, SQLLEN *IndicatorPtr)
+{
+  int rc= 0;
 
-            ts->intval.day_second.hour= tm->hour;
-            ts->intval.day_second.minute= tm->minute;
-            ts->interval_sign= tm->neg ? SQL_TRUE : SQL_FALSE;
+  MADB_CLEAR_ERROR(&Stmt->Error);
+  if (Stmt->result[i].buffer_length < MAX(Stmt->stmt->fields[i].max_length, *Stmt->stmt->bind[i].length))
+  {
+    Column->Buffer[Stmt->result[i].buffer_length - 1]= 0;
+    return MADB_SetError(&Stmt->Error, MADB_ERR_22003, NULL, 0);
+  }
 
-            if (ArdRec->Type == SQL_C_INTERVAL_HOUR_TO_MINUTE)
-            {
-              ts->intval.day_second.second= 0;
-              ts->interval_type= SQL_INTERVAL_HOUR_TO_MINUTE;
-              if (tm->second)
-              {
-                FieldRc= MADB_SetError(&Stmt->Error, MADB_ERR_01S07, NULL, 0);
-                CALC_ALL_FLDS_RC(rc, FieldRc);
-                break;
-              }
-            }
-            else
-            {
-              ts->interval_type= SQL_INTERVAL_HOUR_TO_SECOND;
-              ts->intval.day_second.second= tm->second;
-            }
-          }
-          
-          *LengthPtr= sizeof(SQL_INTERVAL_STRUCT);
-        }
+  if ((rc= MADB_CharToSQLNumeric(Column->Buffer, Stmt->Ard, MADB_DescGetInternalRecord(Stmt->Ard, i, MADB_DESC_READ),
+                                 NULL, RowNumber)))
+  {
+    MADB_SetError(&Stmt->Error, rc, NULL, 0);
+  }
+  *LengthPtr= sizeof(SQL_NUMERIC_STRUCT);
+
+  /* Row status is set from the returned code, like for any other column */
+  return Stmt->Error.ReturnValue;
+}
+/* }}} */
+
+/* {{{ MADB_FixWchar */
+static SQLRETURN MADB_FixWchar(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned int i, int RowNumber,
+                               void *DataPtr, SQLLEN *LengthPtr, SQLLEN *IndicatorPtr)
+{
+  SQLULEN CharCapacity= Column->OctetLength / sizeof(SQLWCHAR);
+  SQLLEN  CharLen= MADB_SetString(&Stmt->Connection->Charset, DataPtr, CharCapacity, (char *)Stmt->result[i].buffer,
+                                  *Stmt->stmt->bind[i].length, &Stmt->Error);
+  /* Not quite right */
+  *LengthPtr= CharLen * sizeof(SQLWCHAR);
+
+  if (CharLen > 0 && (SQLULEN)CharLen >= CharCapacity)
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_01004, NULL, 0);
+  }
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_FixUtf8Wchar - transcodes utf8 string from the row straight to the application's buffer */
+static SQLRETURN MADB_FixUtf8Wchar(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned int i, int RowNumber,
+                                   void *DataPtr, SQLLEN *LengthPtr, SQLLEN *IndicatorPtr)
+{
+  unsigned char *Value= Stmt->stmt->bind[i].u.row_ptr;
+  size_t         ValueLength= (size_t)MADB_NetFieldLength(&Value);
+  BOOL           Truncated;
+
+  *LengthPtr= MADB_Utf8ToWchar((char *)Value, ValueLength, (SQLWCHAR *)DataPtr, Column->OctetLength / sizeof(SQLWCHAR),
+                               TRUE, &Truncated) * sizeof(SQLWCHAR);
+  if (Truncated)
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_01004, NULL, 0);
+  }
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_FixBinaryNumber - big-endian binary string to numeric C types */
+static SQLRETURN MADB_FixBinaryNumber(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned int i, int RowNumber,
+                                      void *DataPtr, SQLLEN *LengthPtr, SQLLEN *IndicatorPtr)
+{
+  char          *Buffer= (char *)Stmt->result[i].buffer;
+  unsigned long  BufferLength= Stmt->result[i].buffer_length;
+  SQLLEN         OctetLength= Column->OctetLength;
+
+  if (BufferLength >= (unsigned long)OctetLength)
+  {
+    if (LittleEndian())
+    {
+      /* We currently got the bigendian number. If we or littleendian machine, we need to switch bytes */
+      SwitchEndianness(Buffer + BufferLength - OctetLength, OctetLength, (char*)DataPtr, OctetLength);
+    }
+    else
+    {
+      memcpy(DataPtr, Buffer + BufferLength - OctetLength, OctetLength);
+    }
+  }
+  else
+  {
+    /* We won't write to the whole memory pointed by DataPtr, thus to need to zerofill prior to that */
+    memset(DataPtr, 0, OctetLength);
+    if (LittleEndian())
+    {
+      SwitchEndianness(Buffer, BufferLength, (char*)DataPtr, OctetLength);
+    }
+    else
+    {
+      memcpy((char*)DataPtr + OctetLength - BufferLength, Buffer, BufferLength);
+    }
+  }
+  *LengthPtr= *Stmt->stmt->bind[i].length;
+
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_LenencTextField - whether field's value comes in binary protocol row as length encoded string, that
+       MADB_FixUtf8Wchar can take as is */
+static BOOL MADB_LenencTextField(MYSQL_FIELD *Field)
+{
+  if (Field->charsetnr == BINARY_CHARSETNR)
+  {
+    return FALSE;
+  }
+  switch (Field->type)
+  {
+  case MYSQL_TYPE_VARCHAR:
+  case MYSQL_TYPE_VAR_STRING:
+  case MYSQL_TYPE_STRING:
+  case MYSQL_TYPE_TINY_BLOB:
+  case MYSQL_TYPE_MEDIUM_BLOB:
+  case MYSQL_TYPE_LONG_BLOB:
+  case MYSQL_TYPE_BLOB:
+  case MYSQL_TYPE_DECIMAL:
+  case MYSQL_TYPE_NEWDECIMAL:
+  case MYSQL_TYPE_JSON:
+  case MYSQL_TYPE_ENUM:
+  case MYSQL_TYPE_SET:
+    return TRUE;
+  default:
+    return FALSE;
+  }
+}
+/* }}} */
+
+/* Converters of the column's values of the whole rowset, used by column-major fetch. They only cover pairs of field and
+   ARD types, where the value is copied to the application's buffer as is, and do the same C/C does for them in the row loop */
+
+/* {{{ MADB_BatchRowPtrs - sets pointer to the length of the row, and takes care of the indicator. Returns TRUE, if the value is
+       NULL, and nothing else is to be done for the row */
+static BOOL MADB_BatchRowPtrs(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned char *Value, SQLULEN Row,
+                              SQLLEN **LengthPtr, SQLRETURN *RowResult, MADB_Error *Error)
+{
+  MADB_FetchPlan *Plan= Stmt->FetchPlan;
+  SQLLEN         *IndicatorPtr= (SQLLEN *)MADB_PLAN_PTR(Plan, Column->IndicatorPtr, Column->LengthStride, Row);
+
+  *LengthPtr= (SQLLEN *)MADB_PLAN_PTR(Plan, Column->LengthPtr, Column->LengthStride, Row);
+
+  if (Value == NULL)
+  {
+    if (IndicatorPtr != NULL)
+    {
+      *IndicatorPtr= SQL_NULL_DATA;
+    }
+    else
+    {
+      RowResult[Row]= MADB_SetError(Error, MADB_ERR_22002, NULL, 0);
+    }
+    return TRUE;
+  }
+  if (IndicatorPtr != NULL && IndicatorPtr != *LengthPtr && *IndicatorPtr < 0)
+  {
+    *IndicatorPtr= 0;
+  }
+  return FALSE;
+}
+/* }}} */
+
+/* {{{ MADB_BatchFixed - number of the same width, as of the application's buffer. Rows have it in little-endian order */
+static void MADB_BatchFixed(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned char **Value, SQLULEN First, SQLULEN Count,
+                            SQLRETURN *RowResult, MADB_Error *Error)
+{
+  MADB_FetchPlan *Plan= Stmt->FetchPlan;
+  SQLULEN         Row;
+  SQLLEN         *LengthPtr;
+  char           *DataPtr;
+  unsigned int    k;
+
+  for (Row= First; Row < First + Count; ++Row)
+  {
+    unsigned long long Number= 0;
+
+    if (MADB_BatchRowPtrs(Stmt, Column, Value[Row], Row, &LengthPtr, RowResult, Error))
+    {
+      continue;
+    }
+    for (k= Column->Width; k > 0; --k)
+    {
+      Number= (Number << 8) | Value[Row][k - 1];
+    }
+    DataPtr= (char *)MADB_PLAN_PTR(Plan, Column->DataPtr, Column->DataStride, Row);
+
+    switch (Column->Width)
+    {
+    case 1:
+      *DataPtr= (char)Number;
+      break;
+    case 2:
+    {
+      unsigned short Short= (unsigned short)Number;
+      memcpy(DataPtr, &Short, 2);
+      break;
+    }
+    case 4:
+    {
+      /* FLOAT as well - its bits are taken as they are */
+      SQLUINTEGER Long= (SQLUINTEGER)Number;
+      memcpy(DataPtr, &Long, 4);
+      break;
+    }
+    default:
+      memcpy(DataPtr, &Number, 8);
+    }
+    if (LengthPtr != NULL)
+    {
+      *LengthPtr= Column->Width;
+    }
+  }
+}
+/* }}} */
+
+/* {{{ MADB_BatchString - length encoded string to SQL_C_CHAR or SQL_C_BINARY buffer */
+static void MADB_BatchString(MADB_Stmt *Stmt, MADB_FetchColumn *Column, unsigned char **Value, SQLULEN First, SQLULEN Count,
+                             SQLRETURN *RowResult, MADB_Error *Error)
+{
+  MADB_FetchPlan *Plan=   Stmt->FetchPlan;
+  size_t          Buffer= Column->OctetLength > 0 ? (size_t)Column->OctetLength : 0;
+  SQLULEN         Row;
+  SQLLEN         *LengthPtr;
+  char           *DataPtr;
+
+  for (Row= First; Row < First + Count; ++Row)
+  {
+    unsigned char *Ptr;
+    size_t         Length;
+
+    if (MADB_BatchRowPtrs(Stmt, Column, Value[Row], Row, &LengthPtr, RowResult, Error))
+    {
+      continue;
+    }
+    Ptr=     Value[Row];
+    Length=  (size_t)MADB_NetFieldLength(&Ptr);
+    DataPtr= (char *)MADB_PLAN_PTR(Plan, Column->DataPtr, Column->DataStride, Row);
+
+    /* As C/C does it - terminating null is written only if there is room for it */
+    memcpy(DataPtr, Ptr, MIN(Length, Buffer));
+    if (Length < Buffer)
+    {
+      DataPtr[Length]= '\0';
+    }
+    if (LengthPtr != NULL)
+    {
+      *LengthPtr= (SQLLEN)Length;
+    }
+    if (Length > Buffer)
+    {
+      MADB_SetError(Error, MADB_ERR_01004, NULL, 0);
+      if (RowResult[Row] != SQL_ERROR)
+      {
+        RowResult[Row]= SQL_SUCCESS_WITH_INFO;
+      }
+    }
+  }
+}
+/* }}} */
+
+/* {{{ MADB_BatchFix - chooses column-major converter of the field to the ARD type, if there is one */
+static MADB_FixBatch MADB_BatchFix(MYSQL_FIELD *Field, SQLSMALLINT CType, unsigned int *Width)
+{
+  switch (CType)
+  {
+  case SQL_C_CHAR:
+  case SQL_C_BINARY:
+    if (MADB_LenencTextField(Field) || MADB_MaxLengthField(Field))
+    {
+      return MADB_BatchString;
+    }
+    return NULL;
+  case SQL_C_TINYINT:
+  case SQL_C_STINYINT:
+  case SQL_C_UTINYINT:
+    *Width= Field->type == MYSQL_TYPE_TINY ? 1 : 0;
+    break;
+  case SQL_C_SHORT:
+  case SQL_C_SSHORT:
+  case SQL_C_USHORT:
+    *Width= Field->type == MYSQL_TYPE_SHORT || Field->type == MYSQL_TYPE_YEAR ? 2 : 0;
+    break;
+  case SQL_C_LONG:
+  case SQL_C_SLONG:
+  case SQL_C_ULONG:
+    *Width= Field->type == MYSQL_TYPE_LONG || Field->type == MYSQL_TYPE_INT24 ? 4 : 0;
+    break;
+  case SQL_C_SBIGINT:
+  case SQL_C_UBIGINT:
+    *Width= Field->type == MYSQL_TYPE_LONGLONG ? 8 : 0;
+    break;
+  case SQL_C_FLOAT:
+    *Width= Field->type == MYSQL_TYPE_FLOAT ? 4 : 0;
+    break;
+  case SQL_C_DOUBLE:
+    *Width= Field->type == MYSQL_TYPE_DOUBLE ? 8 : 0;
+    break;
+  default:
+    return NULL;
+  }
+  return *Width > 0 ? MADB_BatchFixed : NULL;
+}
+/* }}} */
+
+/* {{{ MADB_PrepareFetchPlan
+       Builds the fetch plan, unless the one built for current result metadata and columns binding exists */
+SQLRETURN MADB_PrepareFetchPlan(MADB_Stmt *Stmt)
+{
+  MADB_FetchPlan   *Plan= Stmt->FetchPlan;
+  MADB_FetchColumn *Column;
+  MADB_DescRecord  *IrdRec, *ArdRec;
+  SQLSMALLINT       i, ColumnCount= MADB_STMT_COLUMN_COUNT(Stmt);
+  SQLRETURN         rc= SQL_SUCCESS;
+
+  if (Plan != NULL && Plan->Ard == Stmt->Ard && Plan->ArdVersion == Stmt->Ard->Version &&
+      Plan->IrdVersion == Stmt->Ird->Version && Plan->ColumnCount == ColumnCount)
+  {
+    return SQL_SUCCESS;
+  }
+  MADB_FetchPlanFree(Stmt);
+
+  if (!(Plan= (MADB_FetchPlan *)MADB_CALLOC(sizeof(MADB_FetchPlan))) ||
+      !(Plan->Column= (MADB_FetchColumn *)MADB_CALLOC(sizeof(MADB_FetchColumn) * MAX(ColumnCount, 1))) ||
+      !(Plan->Bound= (SQLSMALLINT *)MADB_CALLOC(sizeof(SQLSMALLINT) * MAX(ColumnCount, 1))))
+  {
+    if (Plan != NULL)
+    {
+      MADB_FREE(Plan->Column);
+    }
+    MADB_FREE(Plan);
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+  }
+  Stmt->FetchPlan= Plan;
+  Plan->Ard=         Stmt->Ard;
+  Plan->ArdVersion=  Stmt->Ard->Version;
+  Plan->IrdVersion=  Stmt->Ird->Version;
+  Plan->ColumnCount= ColumnCount;
+
+  for (i= 0; i < ColumnCount && SQL_SUCCEEDED(rc); ++i)
+  {
+    Column= &Plan->Column[i];
+    Column->Bind.flags|= MADB_BIND_DUMMY;
+
+    ArdRec= MADB_DescGetInternalRecord(Stmt->Ard, i, MADB_DESC_READ);
+    if (ArdRec == NULL || !ArdRec->inUse)
+    {
+      continue;
+    }
+
+    Column->InUse=        TRUE;
+    Plan->Bound[Plan->BoundCount++]= i;
+    Column->DataPtr=      ArdRec->DataPtr;
+    Column->LengthPtr=    ArdRec->OctetLengthPtr;
+    Column->IndicatorPtr= ArdRec->IndicatorPtr;
+    Column->OctetLength=  ArdRec->OctetLength;
+    Column->CType=        ArdRec->Type;
+
+    /* Same as GetBindOffset does */
+    if (Stmt->Ard->Header.BindType == SQL_BIND_BY_COLUMN)
+    {
+      Column->DataStride=   (size_t)ArdRec->OctetLength;
+      Column->LengthStride= sizeof(SQLLEN);
+    }
+    else
+    {
+      Column->DataStride=   (size_t)Stmt->Ard->Header.BindType;
+      Column->LengthStride= (size_t)Stmt->Ard->Header.BindType;
+    }
+
+    if (ArdRec->DataPtr == NULL)
+    {
+      continue;
+    }
+    Column->Bind.flags&= ~MADB_BIND_DUMMY;
+
+    IrdRec= MADB_DescGetInternalRecord(Stmt->Ird, i, MADB_DESC_READ);
+    /* assert(IrdRec != NULL) */
+    Column->SqlType= IrdRec->ConciseType;
+    Column->Fix=     MADB_FixLength;
+    Column->Batch=   MADB_BatchFix(&Stmt->stmt->fields[i], ArdRec->ConciseType, &Column->Width);
+
+    switch(ArdRec->ConciseType) {
+    case SQL_C_WCHAR:
+      /* Text in utf8 is transcoded from the row data, without fetching it to an intermediate buffer */
+      if (MADB_IS_UTF8(Stmt->Connection->Charset.cs_info) && MADB_LenencTextField(&Stmt->stmt->fields[i]))
+      {
+        Column->Raw=  TRUE;
+        Column->Fix=  MADB_FixUtf8Wchar;
+        Column->Bind.flags|= MADB_BIND_DUMMY;
         break;
-        case SQL_C_NUMERIC:
+      }
+      /* In worst case for 2 bytes of UTF16 in result, we need 3 bytes of utf8.
+          For ASCII  we need 2 times less(for 2 bytes of UTF16 - 1 byte UTF8,
+          in other cases we need same 2 of 4 bytes. */
+      Column->Fix= MADB_FixWchar;
+      rc= MADB_PlanBuffer(Stmt, Column, (size_t)(ArdRec->OctetLength*1.5), MYSQL_TYPE_STRING);
+      break;
+    case SQL_C_CHAR:
+      Column->Direct=             TRUE;
+      Column->Bind.buffer_length= (unsigned long)ArdRec->OctetLength;
+      Column->Bind.buffer_type=   MYSQL_TYPE_STRING;
+      break;
+    case SQL_C_NUMERIC:
+      Column->Fix= MADB_FixNumeric;
+      rc= MADB_PlanBuffer(Stmt, Column, MADB_DEFAULT_PRECISION + 1/*-*/ + 1/*.*/, MYSQL_TYPE_STRING);
+      break;
+    case SQL_TYPE_TIMESTAMP:
+    case SQL_TYPE_DATE:
+    case SQL_TYPE_TIME:
+    case SQL_C_TIMESTAMP:
+    case SQL_C_TIME:
+    case SQL_C_DATE:
+      if (IrdRec->ConciseType == SQL_CHAR || IrdRec->ConciseType == SQL_VARCHAR)
+      {
+        unsigned long MaxLength= Stmt->stmt->fields[i].max_length > 0 ? Stmt->stmt->fields[i].max_length :
+                                   MIN(Stmt->stmt->fields[i].length, MADB_MAX_DATETIME_STRLEN);
+
+        Column->Fix= MADB_FixStrTimestamp;
+        rc= MADB_PlanBuffer(Stmt, Column, MaxLength + 1, MYSQL_TYPE_STRING);
+      }
+      else
+      {
+        Column->Fix= MADB_FixTimestamp;
+        rc= MADB_PlanBuffer(Stmt, Column, sizeof(MYSQL_TIME), MYSQL_TYPE_TIMESTAMP);
+      }
+      break;
+    case SQL_C_INTERVAL_HOUR_TO_MINUTE:
+    case SQL_C_INTERVAL_HOUR_TO_SECOND:
+      {
+        MYSQL_FIELD *Field= mysql_fetch_field_direct(Stmt->metadata, i);
+
+        if (IrdRec->ConciseType == SQL_CHAR || IrdRec->ConciseType == SQL_VARCHAR)
         {
-          int rc= 0;
-          MADB_CLEAR_ERROR(&Stmt->Error);
-          if (DataPtr != NULL && Stmt->result[i].buffer_length < Stmt->stmt->fields[i].max_length)
-          {
-            MADB_SetError(&Stmt->Error, MADB_ERR_22003, NULL, 0);
-            ArdRec->InternalBuffer[Stmt->result[i].buffer_length - 1]= 0;
-            return Stmt->Error.ReturnValue;
-          }
+          unsigned long MaxLength= Stmt->stmt->fields[i].max_length > 0 ? Stmt->stmt->fields[i].max_length :
+                                     MIN(Stmt->stmt->fields[i].length, MADB_MAX_DATETIME_STRLEN);
 
-          if ((rc= MADB_CharToSQLNumeric(ArdRec->InternalBuffer, Stmt->Ard, ArdRec, NULL, RowNumber)))
-          {
-            MADB_SetError(&Stmt->Error, rc, NULL, 0);
-          }
-          /* TODO: why is it here individually for Numeric type?! */
-          if (Stmt->Ard->Header.ArrayStatusPtr)
-          {
-            Stmt->Ard->Header.ArrayStatusPtr[RowNumber]= Stmt->Error.ReturnValue;
-          }
-          *LengthPtr= sizeof(SQL_NUMERIC_STRUCT);
+          Column->Fix= MADB_FixStrInterval;
+          rc= MADB_PlanBuffer(Stmt, Column, MaxLength + 1, MYSQL_TYPE_STRING);
         }
-        break;
-        case SQL_C_WCHAR:
+        else
         {
-          SQLLEN CharLen= MADB_SetString(&Stmt->Connection->Charset, DataPtr, ArdRec->OctetLength, (char *)Stmt->result[i].buffer,
-            *Stmt->stmt->bind[i].length, &Stmt->Error);
-          /* Not quite right */
-          *LengthPtr= CharLen * sizeof(SQLWCHAR);
+          Column->Fix= MADB_FixInterval;
+          rc= MADB_PlanBuffer(Stmt, Column, sizeof(MYSQL_TIME),
+                              Field && Field->type == MYSQL_TYPE_TIME ? MYSQL_TYPE_TIME : MYSQL_TYPE_TIMESTAMP);
         }
+      }
+      break;
+    case SQL_C_TINYINT:
+    case SQL_C_UTINYINT:
+    case SQL_C_STINYINT:
+    case SQL_C_SHORT:
+    case SQL_C_SSHORT:
+    case SQL_C_USHORT:
+    case SQL_C_FLOAT:
+    case SQL_C_LONG:
+    case SQL_C_ULONG:
+    case SQL_C_SLONG:
+    case SQL_C_DOUBLE:
+      if (MADB_BinaryFieldType(IrdRec->ConciseType))
+      {
+        /* To keep things simple - we will use internal buffer of the column size, and later(in the MADB_FixFetchedValues) will copy (correct part of)
+           it to the application's buffer taking care of endianness. Perhaps it'd be better just not to support this type of conversion */
+        Column->Fix= MADB_FixBinaryNumber;
+        rc= MADB_PlanBuffer(Stmt, Column, (size_t)IrdRec->OctetLength, MYSQL_TYPE_BLOB);
+        break;
+      }
+      /* else {we are falling through below} */
+    default:
+      if (!MADB_CheckODBCType(ArdRec->ConciseType))
+      {
+        rc= MADB_SetError(&Stmt->Error, MADB_ERR_07006, NULL, 0);
         break;
+      }
+      if (ArdRec->ConciseType == SQL_C_BIT)
+      {
+        Column->Fix= MADB_FixBit;
+      }
+      Column->Direct=             TRUE;
+      Column->Bind.buffer_length= (unsigned long)ArdRec->OctetLength;
+      Column->Bind.buffer_type=   MADB_GetMaDBTypeAndLength(ArdRec->ConciseType,
+                                                            &Column->Bind.is_unsigned,
+                                                            &Column->Bind.buffer_length);
+      break;
+    }
+  }
 
-        case SQL_C_TINYINT:
-        case SQL_C_UTINYINT:
-        case SQL_C_STINYINT:
-        case SQL_C_SHORT:
-        case SQL_C_SSHORT:
-        case SQL_C_USHORT:
-        case SQL_C_FLOAT:
-        case SQL_C_LONG:
-        case SQL_C_ULONG:
-        case SQL_C_SLONG:
-        case SQL_C_DOUBLE:
-          if (MADB_BinaryFieldType(IrdRec->ConciseType))
-          {
-            if (DataPtr != NULL)
-            {
-              if (Stmt->result[i].buffer_length >= (unsigned long)ArdRec->OctetLength)
-              {
-                if (LittleEndian())
-                {
-                  /* We currently got the bigendian number. If we or littleendian machine, we need to switch bytes */
-                  SwitchEndianness((char*)Stmt->result[i].buffer + Stmt->result[i].buffer_length - ArdRec->OctetLength,
-                    ArdRec->OctetLength,
-                    (char*)DataPtr,
-                    ArdRec->OctetLength);
-                }
-                else
-                {
-                  memcpy(DataPtr, (void*)((char*)Stmt->result[i].buffer + Stmt->result[i].buffer_length - ArdRec->OctetLength), ArdRec->OctetLength);
-                }
-              }
-              else
-              {
-                /* We won't write to the whole memory pointed by DataPtr, thus to need to zerofill prior to that */
-                memset(DataPtr, 0, ArdRec->OctetLength);
-                if (LittleEndian())
-                {
-                  SwitchEndianness((char*)Stmt->result[i].buffer,
-                    Stmt->result[i].buffer_length,
-                    (char*)DataPtr,
-                    ArdRec->OctetLength);
-                }
-                else
-                {
-                  memcpy((void*)((char*)DataPtr + ArdRec->OctetLength - Stmt->result[i].buffer_length),
-                    Stmt->result[i].buffer, Stmt->result[i].buffer_length);
-                }
-              }
-              *LengthPtr= *Stmt->stmt->bind[i].length;
-            }
-            break;
-          }
-          /* else {we are falling through below} */
-        default:
-          if (DataPtr != NULL)
-          {
-            if (Stmt->Ard->Header.ArraySize > 1)
-            {
-              if (Stmt->Ard->Header.BindType)
-              {
-                Stmt->result[i].buffer= (char *)Stmt->result[i].buffer + Stmt->Ard->Header.BindType;
-              }
-              else
-              {
-                Stmt->result[i].buffer = (char *)ArdRec->DataPtr + (RowNumber + 1) * ArdRec->OctetLength;
-              }
-            }
-            *LengthPtr= *Stmt->stmt->bind[i].length;
-          }
-          break;
+  if (!SQL_SUCCEEDED(rc))
+  {
+    MADB_FetchPlanFree(Stmt);
+    return rc;
+  }
+
+  Plan->Batchable= Plan->BoundCount > 0;
+  for (i= 0; i < Plan->BoundCount; ++i)
+  {
+    if (Plan->Column[Plan->Bound[i]].Batch == NULL)
+    {
+      Plan->Batchable= FALSE;
+      break;
+    }
+  }
+
+  return SQL_SUCCESS;
+}
+/* }}} */
+
+/* {{{ MADB_BindFetchPlan
+       Fills C/C bind structures in according to the plan, and binds them. Done once per rowset */
+static void MADB_BindFetchPlan(MADB_Stmt *Stmt)
+{
+  MADB_FetchPlan *Plan= Stmt->FetchPlan;
+  SQLSMALLINT     i;
+
+  Plan->BindOffset= Stmt->Ard->Header.BindOffsetPtr != NULL ? (size_t)*Stmt->Ard->Header.BindOffsetPtr : 0;
+
+  for (i= 0; i < Plan->ColumnCount; ++i)
+  {
+    memcpy(&Stmt->result[i], &Plan->Column[i].Bind, sizeof(MYSQL_BIND));
+    /* We can't use application's buffer directly, as it has/can have different size, than C/C needs */
+    Stmt->result[i].length= &Stmt->result[i].length_value;
+    if (Plan->Column[i].Direct)
+    {
+      Stmt->result[i].buffer= MADB_PLAN_PTR(Plan, Plan->Column[i].DataPtr, Plan->Column[i].DataStride, 0);
+    }
+  }
+
+  mysql_stmt_bind_result(Stmt->stmt, Stmt->result);
+}
+/* }}} */
+
+/* {{{ MADB_FetchPlanRow
+       Points C/C to the application's buffers of the row for columns, that are fetched directly */
+static void MADB_FetchPlanRow(MADB_Stmt *Stmt, SQLULEN RowNumber)
+{
+  MADB_FetchPlan *Plan= Stmt->FetchPlan;
+  SQLSMALLINT     i, j;
+
+  for (j= 0; j < Plan->BoundCount; ++j)
+  {
+    i= Plan->Bound[j];
+    if (Plan->Column[i].Direct)
+    {
+      Stmt->stmt->bind[i].buffer= MADB_PLAN_PTR(Plan, Plan->Column[i].DataPtr, Plan->Column[i].DataStride, RowNumber);
+    }
+    else if (Plan->Column[i].Raw)
+    {
+      /* C/C sets NULL flag of dummy-bound columns, but doesn't reset it */
+      *Stmt->stmt->bind[i].is_null= 0;
+    }
+  }
+}
+/* }}} */
+
+/* {{{ MADB_CutFetchedRow
+       Points C/C to copies of character and binary values of the fetched row, that are longer, than SQL_ATTR_MAX_LENGTH the
+       result has been produced with. The row itself is never changed - it may be C/C's stored row, or be in read-only map
+       of spilled rows. Returns 1 if values could not be copied */
+int MADB_CutFetchedRow(MADB_Stmt *Stmt, MADB_Arena *Arena)
+{
+  MYSQL_STMT    *stmt= Stmt->stmt;
+  BOOL           Utf8= MADB_IS_UTF8(Stmt->Connection->Charset.cs_info);
+  unsigned char *Value;
+  unsigned int   i;
+
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    if (stmt->bind[i].u.row_ptr == NULL || !MADB_MaxLengthField(&stmt->fields[i]))
+    {
+      continue;
+    }
+    if (!(Value= MADB_CutNetField(Arena, stmt->bind[i].u.row_ptr, Stmt->ResultMaxLength,
+                                  Utf8 && stmt->fields[i].charsetnr != BINARY_CHARSETNR)))
+    {
+      MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+      return 1;
+    }
+    if (Value != stmt->bind[i].u.row_ptr)
+    {
+      stmt->bind[i].u.row_ptr= Value;
+      *stmt->bind[i].length=   (unsigned long)MADB_NetFieldLength(&Value);
+    }
+  }
+
+  return 0;
+}
+/* }}} */
+
+/* {{{ MADB_FetchRowRaw
+       Reads next row without conversion of values - C/C only points to them in the row. If SQL_ATTR_MAX_LENGTH is set,
+       C/C is pointed to cut copies of character and binary values */
+static int MADB_FetchRowRaw(MADB_Stmt *Stmt)
+{
+  MADB_FetchPlan *Plan=  Stmt->FetchPlan;
+  MYSQL_STMT     *stmt=  Stmt->stmt;
+  unsigned int    i;
+  int             rc;
+
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    stmt->bind[i].flags|= MADB_BIND_DUMMY;
+  }
+  rc= mysql_stmt_fetch(stmt);
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    stmt->bind[i].flags&= (~MADB_BIND_DUMMY | Plan->Column[i].Bind.flags);
+  }
+  if (rc == 1 || rc == MYSQL_NO_DATA)
+  {
+    return rc;
+  }
+
+  for (i= 0; i < stmt->field_count; ++i)
+  {
+    /* C/C points only values, that are not NULL */
+    if (stmt->bind[i].u.row_ptr != NULL)
+    {
+      *stmt->bind[i].is_null= 0;
+    }
+  }
+  /* Copies live till the next rowset */
+  if (Stmt->ResultMaxLength > 0 && MADB_CutFetchedRow(Stmt, &Plan->Copies))
+  {
+    return 1;
+  }
+
+  return rc;
+}
+/* }}} */
+
+/* {{{ MADB_FetchRow
+       Fetches next row. If SQL_ATTR_MAX_LENGTH is set, C/C reads the row without conversion first, and is pointed to cut
+       values of character and binary columns, and only then bound columns are converted. Thus bytes beyond the limit are
+       never copied to the buffers, and SQLGetData reads cut values as well */
+static int MADB_FetchRow(MADB_Stmt *Stmt)
+{
+  MADB_FetchPlan *Plan=  Stmt->FetchPlan;
+  MYSQL_STMT     *stmt=  Stmt->stmt;
+  unsigned int    i;
+  SQLSMALLINT     j;
+  int             rc;
+
+  if (Stmt->ResultMaxLength == 0 || stmt->bind == NULL)
+  {
+    return mysql_stmt_fetch(stmt);
+  }
+
+  if ((rc= MADB_FetchRowRaw(Stmt)) == 1 || rc == MYSQL_NO_DATA)
+  {
+    return rc;
+  }
+  for (j= 0; j < Plan->BoundCount; ++j)
+  {
+    i= Plan->Bound[j];
+    if (stmt->bind[i].u.row_ptr != NULL && !(stmt->bind[i].flags & MADB_BIND_DUMMY))
+    {
+      mysql_stmt_fetch_column(stmt, &stmt->bind[i], i, 0);
+      if (*stmt->bind[i].error)
+      {
+        rc= MYSQL_DATA_TRUNCATED;
+      }
+    }
+  }
+
+  return rc;
+}
+/* }}} */
+
+/* {{{ MADB_FetchRowValues
+       Column-major fetch: reads next row, and only remembers where values of bound columns are. Rows of forward-only
+       cursor do not stay in memory after the next one is read, and their values are copied */
+static int MADB_FetchRowValues(MADB_Stmt *Stmt, SQLULEN RowNumber)
+{
+  MADB_FetchPlan *Plan= Stmt->FetchPlan;
+  MYSQL_STMT     *stmt= Stmt->stmt;
+  unsigned char  *Value;
+  unsigned long   Size;
+  SQLSMALLINT     i, j;
+  int             rc;
+
+  if ((rc= MADB_FetchRowRaw(Stmt)) == 1 || rc == MYSQL_NO_DATA)
+  {
+    return rc;
+  }
+  for (j= 0; j < Plan->BoundCount; ++j)
+  {
+    i=     Plan->Bound[j];
+    Value= stmt->bind[i].u.row_ptr;
+
+    if (Value != NULL && Stmt->Options.CursorType == SQL_CURSOR_FORWARD_ONLY)
+    {
+      Size= MADB_NetValueSize(&stmt->fields[i], Value);
+      if (!(Value= (unsigned char *)MADB_ArenaAlloc(&Plan->Copies, Size)))
+      {
+        MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+        return 1;
+      }
+      memcpy(Value, stmt->bind[i].u.row_ptr, Size);
+    }
+    Plan->Values[j * Plan->ValuesRows + RowNumber]= Value;
+  }
+
+  return rc;
+}
+/* }}} */
+
+#define CALC_ALL_FLDS_RC(_agg_rc, _field_rc) if (_field_rc != SQL_SUCCESS && _agg_rc != SQL_ERROR) _agg_rc= _field_rc 
+
+/* {{{ MADB_FixFetchedValues 
+       Converting and/or fixing fetched values if needed */
+SQLRETURN MADB_FixFetchedValues(MADB_Stmt *Stmt, int RowNumber, MYSQL_ROW_OFFSET SaveCursor)
+{
+  MADB_FetchPlan  *Plan= Stmt->FetchPlan;
+  MADB_FetchColumn *Column;
+  int             i, j;
+  SQLLEN          *IndicatorPtr= NULL, *LengthPtr= NULL, Dummy= 0;
+  void            *DataPtr=      NULL;
+  SQLRETURN       rc= SQL_SUCCESS, FieldRc;
+
+  for (j= 0; j < Plan->BoundCount; ++j)
+  {
+    i=      Plan->Bound[j];
+    Column= &Plan->Column[i];
+    /* set indicator and dataptr */
+    LengthPtr=    (SQLLEN *)MADB_PLAN_PTR(Plan, Column->LengthPtr,    Column->LengthStride, RowNumber);
+    IndicatorPtr= (SQLLEN *)MADB_PLAN_PTR(Plan, Column->IndicatorPtr, Column->LengthStride, RowNumber);
+
+    if (LengthPtr == NULL)
+    {
+      LengthPtr= &Dummy;
+    }
+    /* clear IndicatorPtr */
+    if (IndicatorPtr != NULL && IndicatorPtr != LengthPtr && *IndicatorPtr < 0)
+    {
+      *IndicatorPtr= 0;
+    }
+
+    if (*Stmt->stmt->bind[i].is_null)
+    {
+      if (IndicatorPtr)
+      {
+        *IndicatorPtr= SQL_NULL_DATA;
+      }
+      else
+      {
+        if (SaveCursor)
+        {
+          mysql_stmt_row_seek(Stmt->stmt, SaveCursor);
         }
+        rc= MADB_SetError(&Stmt->Error, MADB_ERR_22002, NULL, 0);
       }
     }
+    else if (Column->Fix != NULL)
+    {
+      DataPtr= MADB_PLAN_PTR(Plan, Column->DataPtr, Column->DataStride, RowNumber);
+      FieldRc= Column->Fix(Stmt, Column, i, RowNumber, DataPtr, LengthPtr, IndicatorPtr);
+      CALC_ALL_FLDS_RC(rc, FieldRc);
+    }
   }
 
   return rc;
@@ -1972,63 +2604,291 @@ void ResetDescIntBuffers(MADB_Desc *Desc)
 if      (_row_num == 0)                  _accumulated_rc= _cur_row_rc;\
 else if (_cur_row_rc != _accumulated_rc) _accumulated_rc= SQL_SUCCESS_WITH_INFO
 
-/* {{{ MADB_StmtFetch */
-SQLRETURN MADB_StmtFetch(MADB_Stmt *Stmt)
+/* {{{ MADB_FixRows - converts rows of the part column by column */
+static void MADB_FixRows(MADB_FixPart *Part)
 {
-  unsigned int     RowNum, j, rc;
-  SQLULEN          Rows2Fetch=  Stmt->Ard->Header.ArraySize, Processed, *ProcessedPtr= &Processed;
-  MYSQL_ROW_OFFSET SaveCursor= NULL;
-  SQLRETURN        Result= SQL_SUCCESS, RowResult;
+  MADB_FetchPlan   *Plan= Part->Stmt->FetchPlan;
+  MADB_FetchColumn *Column;
+  SQLSMALLINT       j;
 
-  MADB_CLEAR_ERROR(&Stmt->Error);
+  for (j= 0; j < Plan->BoundCount; ++j)
+  {
+    Column= &Plan->Column[Plan->Bound[j]];
+    Column->Batch(Part->Stmt, Column, Plan->Values + j * Plan->ValuesRows, Part->First, Part->Count, Part->RowResult,
+                  &Part->Error);
+  }
+}
+/* }}} */
 
-  if (!(MADB_STMT_COLUMN_COUNT(Stmt) > 0))
+/* {{{ MADB_FixPoolConvert - converts the 1st queued part. Has to be called with the pool's mutex locked */
+static void MADB_FixPoolConvert(MADB_FixPool *Pool)
+{
+  MADB_FixPart *Part= Pool->Queue;
+
+  if ((Pool->Queue= Part->Next) == NULL)
+  {
+    Pool->QueueLast= NULL;
+  }
+  LeaveCriticalSection(&Pool->cs);
+  MADB_FixRows(Part);
+  EnterCriticalSection(&Pool->cs);
+
+  Part->Done= TRUE;
+  MADB_CondBroadcast(&Pool->Converted);
+}
+/* }}} */
+
+/* {{{ MADB_FixPoolWorker */
+static MADB_THREAD_FUNC(MADB_FixPoolWorker, Arg)
+{
+  MADB_FixPool *Pool= (MADB_FixPool *)Arg;
+
+  EnterCriticalSection(&Pool->cs);
+  while (!Pool->Closing)
+  {
+    if (Pool->Queue != NULL)
+    {
+      MADB_FixPoolConvert(Pool);
+    }
+    else
+    {
+      MADB_CondWait(&Pool->Queued, &Pool->cs);
+    }
+  }
+  LeaveCriticalSection(&Pool->cs);
+
+  MADB_THREAD_RETURN;
+}
+/* }}} */
+
+/* {{{ MADB_FixPoolGet - returns the connection's pool, starting its threads on first use. NULL, if no thread could be started */
+static MADB_FixPool* MADB_FixPoolGet(MADB_Dbc *Dbc)
+{
+  MADB_FixPool *Pool;
+  unsigned int  i;
+
+  /* Rowsets are also converted by prefetch workers, which do not take the connection's lock */
+  EnterCriticalSection(&Dbc->ListsCs);
+  if ((Pool= Dbc->FixPool) == NULL && (Pool= (MADB_FixPool *)MADB_CALLOC(sizeof(MADB_FixPool))) != NULL)
+  {
+    if (!(Pool->Thread= (MADB_THREAD *)MADB_CALLOC(sizeof(MADB_THREAD) * (Dbc->Dsn->ConversionThreads - 1))))
+    {
+      MADB_FREE(Pool);
+      LeaveCriticalSection(&Dbc->ListsCs);
+      return NULL;
+    }
+    InitializeCriticalSection(&Pool->cs);
+    MADB_CondInit(&Pool->Queued);
+    MADB_CondInit(&Pool->Converted);
+
+    for (i= 0; i < Dbc->Dsn->ConversionThreads - 1; ++i)
+    {
+      if (MADB_ThreadCreate(Pool->Thread[Pool->ThreadCount], MADB_FixPoolWorker, Pool))
+      {
+        MDBUG_C_PRINT(Dbc, "Could not start thread to convert rows of %0x", Dbc);
+        break;
+      }
+      ++Pool->ThreadCount;
+    }
+    Dbc->FixPool= Pool;
+  }
+  LeaveCriticalSection(&Dbc->ListsCs);
+
+  return Pool != NULL && Pool->ThreadCount > 0 ? Pool : NULL;
+}
+/* }}} */
+
+/* {{{ MADB_FixPoolFree - joins threads of the connection's pool */
+void MADB_FixPoolFree(MADB_Dbc *Dbc)
+{
+  MADB_FixPool *Pool= Dbc->FixPool;
+  unsigned int  i;
+
+  if (Pool == NULL)
+  {
+    return;
+  }
+  EnterCriticalSection(&Pool->cs);
+  Pool->Closing= TRUE;
+  MADB_CondBroadcast(&Pool->Queued);
+  LeaveCriticalSection(&Pool->cs);
+
+  for (i= 0; i < Pool->ThreadCount; ++i)
+  {
+    MADB_ThreadJoin(Pool->Thread[i]);
+  }
+  MADB_CondDestroy(&Pool->Queued);
+  MADB_CondDestroy(&Pool->Converted);
+  DeleteCriticalSection(&Pool->cs);
+  MADB_FREE(Pool->Thread);
+  MADB_FREE(Pool);
+  Dbc->FixPool= NULL;
+}
+/* }}} */
+
+/* {{{ MADB_FixColumnMajor
+       Converts values of rows First..First+Count-1 of the rowset, read by MADB_FetchRowValues, column by column. Large rowset
+       is split into parts of adjacent rows, converted by threads of the connection's pool. Rows results are merged in rows order, and the
+       statement gets diagnostics of the first part with the most severe one - regardless of which thread finished first */
+static SQLRETURN MADB_FixColumnMajor(MADB_Stmt *Stmt, SQLULEN First, SQLULEN Count)
+{
+  MADB_FetchPlan *Plan= Stmt->FetchPlan;
+  MADB_FixPart   *Part, *Reported= NULL;
+  MADB_FixPool   *Pool= NULL;
+  SQLRETURN      *RowResult, Result= SQL_SUCCESS;
+  SQLULEN         Row, PartRows;
+  unsigned int    k, Parts= 1;
+
+  if (Count == 0)
+  {
+    return SQL_SUCCESS;
+  }
+  if (MADB_PARALLEL_FIX(Stmt, Count) && (Pool= MADB_FixPoolGet(Stmt->Connection)) != NULL)
+  {
+    Parts= (unsigned int)MIN(Pool->ThreadCount + 1, Count / MADB_FIX_PART_ROWS);
+  }
+  if (!(RowResult= (SQLRETURN *)MADB_ArenaAlloc(&Plan->Copies, sizeof(SQLRETURN) * (size_t)(First + Count))) ||
+      !(Part= (MADB_FixPart *)MADB_ArenaAlloc(&Plan->Copies, sizeof(MADB_FixPart) * Parts)))
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+  }
+  for (Row= First; Row < First + Count; ++Row)
+  {
+    RowResult[Row]= SQL_SUCCESS;
+  }
+
+  PartRows= (Count + Parts - 1) / Parts;
+  for (k= 0; k < Parts; ++k)
+  {
+    Part[k].Stmt=      Stmt;
+    Part[k].First=     First + k * PartRows;
+    Part[k].Count=     MIN(PartRows, First + Count - Part[k].First);
+    Part[k].RowResult= RowResult;
+    Part[k].Next=      k + 1 < Parts ? &Part[k + 1] : NULL;
+    Part[k].Done=      FALSE;
+    /* Copy keeps the prefix of error messages */
+    memcpy(&Part[k].Error, &Stmt->Error, sizeof(MADB_Error));
+    MADB_CLEAR_ERROR(&Part[k].Error);
+  }
+  /* 1st part is converted by the application's thread. While waiting for the others, it converts queued parts too */
+  if (Parts > 1)
+  {
+    EnterCriticalSection(&Pool->cs);
+    if (Pool->QueueLast != NULL)
+    {
+      Pool->QueueLast->Next= &Part[1];
+    }
+    else
+    {
+      Pool->Queue= &Part[1];
+    }
+    Pool->QueueLast= &Part[Parts - 1];
+    MADB_CondBroadcast(&Pool->Queued);
+    LeaveCriticalSection(&Pool->cs);
+  }
+  MADB_FixRows(&Part[0]);
+  if (Parts > 1)
   {
-    return MADB_SetError(&Stmt->Error, MADB_ERR_24000, NULL, 0);
+    EnterCriticalSection(&Pool->cs);
+    for (k= 1; k < Parts; ++k)
+    {
+      while (!Part[k].Done)
+      {
+        if (Pool->Queue != NULL)
+        {
+          MADB_FixPoolConvert(Pool);
+        }
+        else
+        {
+          MADB_CondWait(&Pool->Converted, &Pool->cs);
+        }
+      }
+    }
+    LeaveCriticalSection(&Pool->cs);
   }
 
-  if ((Stmt->Options.UseBookmarks == SQL_UB_VARIABLE && Stmt->Options.BookmarkType == SQL_C_BOOKMARK) ||
-      (Stmt->Options.UseBookmarks != SQL_UB_VARIABLE && Stmt->Options.BookmarkType == SQL_C_VARBOOKMARK))
+  for (k= 0; k < Parts; ++k)
   {
-    MADB_SetError(&Stmt->Error, MADB_ERR_07006, NULL, 0);
-    return Stmt->Error.ReturnValue;
+    if (Part[k].Error.ReturnValue != SQL_SUCCESS &&
+        (Reported == NULL || (Part[k].Error.ReturnValue == SQL_ERROR && Reported->Error.ReturnValue != SQL_ERROR)))
+    {
+      Reported= &Part[k];
+    }
+  }
+  if (Reported != NULL)
+  {
+    MADB_CopyError(&Stmt->Error, &Reported->Error);
   }
 
-  /* We don't have much to do if ArraySize == 0 */
-  if (Stmt->Ard->Header.ArraySize == 0)
+  for (Row= First; Row < First + Count; ++Row)
   {
-    return SQL_SUCCESS;
+    CALC_ALL_ROWS_RC(Result, RowResult[Row], Row - First);
+    if (Stmt->Ird->Header.ArrayStatusPtr)
+    {
+      Stmt->Ird->Header.ArrayStatusPtr[Row]= MADB_MapToRowStatus(RowResult[Row]);
+    }
   }
 
-  Stmt->LastRowFetched= 0;
+  return Result;
+}
+/* }}} */
 
-  if (Stmt->result == NULL && !(Stmt->result= (MYSQL_BIND *)MADB_CALLOC(sizeof(MYSQL_BIND) * mysql_stmt_field_count(Stmt->stmt))))
+/* {{{ MADB_StmtBindRowset - builds the fetch plan, and binds C/C to it */
+SQLRETURN MADB_StmtBindRowset(MADB_Stmt *Stmt)
+{
+  /*************** Setting up BIND structures ********************/
+  /* Plan is only re-built if result metadata or columns binding have changed, and C/C is bound once per rowset.
+     For each row only pointers to application's buffers are moved */
+  if (!SQL_SUCCEEDED(MADB_PrepareFetchPlan(Stmt)))
   {
-    MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
     return Stmt->Error.ReturnValue;
   }
+  MADB_BindFetchPlan(Stmt);
 
-  Rows2Fetch= MADB_RowsToFetch(&Stmt->Cursor, Stmt->Ard->Header.ArraySize, mysql_stmt_num_rows(Stmt->stmt));
-  if (Rows2Fetch == 0)
-  {
-    return SQL_NO_DATA;
-  }
+  return SQL_SUCCESS;
+}
+/* }}} */
 
-  if (Stmt->Ard->Header.ArrayStatusPtr)
-  {
-    MADB_InitStatusPtr(Stmt->Ard->Header.ArrayStatusPtr, Stmt->Ard->Header.ArraySize, SQL_NO_DATA);
-  }
+/* {{{ MADB_FetchRowset - reads rows of the rowset, and converts them. Has to be called inside the connection's lock, since
+       rows of the unbuffered result, or of the server side cursor, are read from the connection. Bound tells, that C/C has
+       been bound to the fetch plan already(see MADB_StmtFetchBound) */
+static SQLRETURN MADB_FetchRowset(MADB_Stmt *Stmt, SQLULEN Rows2Fetch, SQLULEN *ProcessedPtr, BOOL Bound)
+{
+  unsigned int     RowNum, j, rc;
+  MYSQL_ROW_OFFSET SaveCursor= NULL;
+  SQLRETURN        Result= SQL_SUCCESS, RowResult;
+  BOOL             ColumnMajor;
 
-  if (Stmt->Ird->Header.RowsProcessedPtr)
+  if (!Bound && !SQL_SUCCEEDED(MADB_StmtBindRowset(Stmt)))
   {
-    ProcessedPtr= Stmt->Ird->Header.RowsProcessedPtr;
+    return Stmt->Error.ReturnValue;
   }
-  if (Stmt->Ird->Header.ArrayStatusPtr)
+  /* Copies of values of the previous rowset are not needed anymore */
+  MADB_ArenaReset(&Stmt->FetchPlan->Copies);
+
+  /* Column-major fetch reads the whole rowset first, and then converts values column by column. Conversion of large rowset
+     is then split between threads */
+  ColumnMajor= MADB_COLUMN_MAJOR(Stmt);
+  if (ColumnMajor)
   {
-    MADB_InitStatusPtr(Stmt->Ird->Header.ArrayStatusPtr, Stmt->Ard->Header.ArraySize, SQL_ROW_NOROW);
-  }
+    MADB_FetchPlan *Plan= Stmt->FetchPlan;
 
-  *ProcessedPtr= 0;
+    if (Plan->ValuesRows < Rows2Fetch)
+    {
+      unsigned char **Values= (unsigned char **)MADB_REALLOC(Plan->Values,
+                                                             sizeof(unsigned char *) * Plan->BoundCount * Rows2Fetch);
+      if (Values != NULL)
+      {
+        Plan->Values=     Values;
+        Plan->ValuesRows= Rows2Fetch;
+      }
+      else
+      {
+        /* Row-major fetch does not need it */
+        ColumnMajor= FALSE;
+      }
+    }
+  }
 
   /* We need to return to 1st row in the rowset only if there are >1 rows in it. Otherwise we stay on it anyway */
   if (Rows2Fetch > 1 && Stmt->Options.CursorType != SQL_CURSOR_FORWARD_ONLY)
@@ -2056,13 +2916,10 @@ SQLRETURN MADB_StmtFetch(MADB_Stmt *Stmt)
     {
       RowNum= j;
     }
-    /*************** Setting up BIND structures ********************/
-    /* Basically, nothing should happen here, but if happens, then it will happen on each row.
-    Thus it's ok to stop */
-    RETURN_ERROR_OR_CONTINUE(MADB_PrepareBind(Stmt, RowNum));
-
-    /************************ Bind! ********************************/  
-    mysql_stmt_bind_result(Stmt->stmt, Stmt->result);
+    if (!ColumnMajor)
+    {
+      MADB_FetchPlanRow(Stmt, RowNum);
+    }
 
     if (Stmt->Options.UseBookmarks && Stmt->Options.BookmarkPtr != NULL)
     {
@@ -2072,7 +2929,7 @@ SQLRETURN MADB_StmtFetch(MADB_Stmt *Stmt)
       *p= (long)Stmt->Cursor.Position;
     }
     /************************ Fetch! ********************************/
-    rc= mysql_stmt_fetch(Stmt->stmt);
+    rc= ColumnMajor ? MADB_FetchRowValues(Stmt, RowNum) : MADB_FetchRow(Stmt);
 
     *ProcessedPtr += 1;
 
@@ -2083,7 +2940,18 @@ SQLRETURN MADB_StmtFetch(MADB_Stmt *Stmt)
 
     switch(rc) {
     case 1:
-      RowResult= MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
+      /* MADB_FetchRowRaw and MADB_FetchRowValues set the error themselves, if they could not copy values */
+      RowResult= Stmt->Error.ReturnValue == SQL_ERROR ? SQL_ERROR :
+                   MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
+      if (ColumnMajor)
+      {
+        /* Rows read before are still converted, but the fetch error is the one to report */
+        MADB_Error FetchError;
+
+        MADB_CopyError(&FetchError, &Stmt->Error);
+        Result= MADB_FixColumnMajor(Stmt, SaveCursor != NULL ? 1 : 0, j);
+        MADB_CopyError(&Stmt->Error, &FetchError);
+      }
       /* If mysql_stmt_fetch returned error, there is no sense to continue */
       if (Stmt->Ird->Header.ArrayStatusPtr)
       {
@@ -2094,11 +2962,12 @@ SQLRETURN MADB_StmtFetch(MADB_Stmt *Stmt)
 
     case MYSQL_DATA_TRUNCATED:
     {
-      /* We will not report truncation if a dummy buffer was bound */
-      int     col;
+      /* We will not report truncation if a dummy buffer was bound. Only bound columns can have it */
+      int     col, k;
 
-      for (col= 0; col < MADB_STMT_COLUMN_COUNT(Stmt); ++col)
+      for (k= 0; k < Stmt->FetchPlan->BoundCount; ++k)
       {
+        col= Stmt->FetchPlan->Bound[k];
         if (Stmt->stmt->bind[col].error && *Stmt->stmt->bind[col].error > 0 &&
             !(Stmt->stmt->bind[col].flags & MADB_BIND_DUMMY))
         {
@@ -2125,6 +2994,11 @@ SQLRETURN MADB_StmtFetch(MADB_Stmt *Stmt)
       break;
     }
     case MYSQL_NO_DATA:
+      /* Whole result has been read, and the connection can be used by others */
+      if (Stmt->Connection->Streamer == Stmt)
+      {
+        Stmt->Connection->Streamer= NULL;
+      }
       /* We have already incremented this counter, since there was no more rows, need to decrement */
       --*ProcessedPtr;
       /* SQL_NO_DATA should be only returned if first fetched row is already beyond end of the resultset */
@@ -2138,6 +3012,20 @@ SQLRETURN MADB_StmtFetch(MADB_Stmt *Stmt)
     ++Stmt->LastRowFetched;
     ++Stmt->PositionedCursor;
 
+    if (ColumnMajor)
+    {
+      continue;
+    }
+    /* Row of the keyset, that has not been found when re-read, has no values to convert */
+    if (Stmt->Options.CursorType == SQL_CURSOR_KEYSET_DRIVEN && MADB_KeysetRowDeleted(Stmt, Stmt->Cursor.Position + RowNum))
+    {
+      if (Stmt->Ird->Header.ArrayStatusPtr)
+      {
+        Stmt->Ird->Header.ArrayStatusPtr[RowNum]= SQL_ROW_DELETED;
+      }
+      continue;
+    }
+
     /*Conversion etc. At this point, after fetch we can have RowResult either SQL_SUCCESS or SQL_SUCCESS_WITH_INFO */
     switch (MADB_FixFetchedValues(Stmt, RowNum, SaveCursor))
     {
@@ -2156,12 +3044,156 @@ SQLRETURN MADB_StmtFetch(MADB_Stmt *Stmt)
       Stmt->Ird->Header.ArrayStatusPtr[RowNum]= MADB_MapToRowStatus(RowResult);
     }
   }
+
+  if (ColumnMajor)
+  {
+    Result= MADB_FixColumnMajor(Stmt, 0, *ProcessedPtr);
+  }
     
   memset(Stmt->CharOffset, 0, sizeof(long) * mysql_stmt_field_count(Stmt->stmt));
   memset(Stmt->Lengths, 0, sizeof(long) * mysql_stmt_field_count(Stmt->stmt));
 
   ResetDescIntBuffers(Stmt->Ird);
 
+  /* While application processes this rowset, next one can be fetched */
+  if (!Bound)
+  {
+    MADB_PrefetchStart(Stmt, Result);
+  }
+
+  return Result;
+}
+/* }}} */
+
+/* {{{ MADB_StmtFetchBound - fetches the rowset of forward-only cursor, C/C has been bound to by MADB_StmtBindRowset. Used
+       by the prefetch worker, that must neither take the connection's lock, which the thread waiting for it may hold, nor
+       bind the handle it shares with the application's thread */
+SQLRETURN MADB_StmtFetchBound(MADB_Stmt *Stmt)
+{
+  SQLULEN Rows2Fetch= Stmt->Ard->Header.ArraySize, Processed, *ProcessedPtr= &Processed;
+
+  MADB_CLEAR_ERROR(&Stmt->Error);
+  Stmt->LastRowFetched=    0;
+  Stmt->Cursor.RowsetSize= Rows2Fetch;
+
+  if (Stmt->Ird->Header.RowsProcessedPtr)
+  {
+    ProcessedPtr= Stmt->Ird->Header.RowsProcessedPtr;
+  }
+  if (Stmt->Ird->Header.ArrayStatusPtr)
+  {
+    MADB_InitStatusPtr(Stmt->Ird->Header.ArrayStatusPtr, Rows2Fetch, SQL_ROW_NOROW);
+  }
+  *ProcessedPtr= 0;
+
+  return MADB_FetchRowset(Stmt, Rows2Fetch, ProcessedPtr, TRUE);
+}
+/* }}} */
+
+/* {{{ MADB_StmtFetch */
+SQLRETURN MADB_StmtFetch(MADB_Stmt *Stmt)
+{
+  SQLULEN          Rows2Fetch=  Stmt->Ard->Header.ArraySize, Processed, *ProcessedPtr= &Processed;
+  SQLRETURN        Result;
+
+  MADB_CLEAR_ERROR(&Stmt->Error);
+
+  if (!(MADB_STMT_COLUMN_COUNT(Stmt) > 0))
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_24000, NULL, 0);
+  }
+
+  if ((Stmt->Options.UseBookmarks == SQL_UB_VARIABLE && Stmt->Options.BookmarkType == SQL_C_BOOKMARK) ||
+      (Stmt->Options.UseBookmarks != SQL_UB_VARIABLE && Stmt->Options.BookmarkType == SQL_C_VARBOOKMARK))
+  {
+    MADB_SetError(&Stmt->Error, MADB_ERR_07006, NULL, 0);
+    return Stmt->Error.ReturnValue;
+  }
+
+  /* We don't have much to do if ArraySize == 0 */
+  if (Stmt->Ard->Header.ArraySize == 0)
+  {
+    return SQL_SUCCESS;
+  }
+
+  /* SQLGetData buffers of the previous rowset are not needed anymore, nor lengths of values of its row */
+  MADB_ArenaReset(&Stmt->Scratch);
+  MADB_COLUMN_LENGTHS_RESET(Stmt);
+
+  /* The rowset has been read and converted in background already */
+  if (MADB_PREFETCH_PENDING(Stmt))
+  {
+    return MADB_PrefetchTake(Stmt);
+  }
+
+  Stmt->LastRowFetched= 0;
+
+  if (Stmt->result == NULL && !(Stmt->result= (MYSQL_BIND *)MADB_CALLOC(sizeof(MYSQL_BIND) * mysql_stmt_field_count(Stmt->stmt))))
+  {
+    MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+    return Stmt->Error.ReturnValue;
+  }
+
+  LOCK_MARIADB(Stmt->Connection);
+  /* The application may use other statements of the connection from other threads. If other statement is reading its
+     result from the connection, the rest of that result is stored first. Server side cursor sends COM_STMT_FETCH for
+     every batch, that must not get in the middle of other result */
+  if (Stmt->Connection->Streamer != Stmt)
+  {
+    MADB_StoreStreamer(Stmt->Connection, NULL);
+  }
+
+  if (Stmt->Options.CursorType == SQL_CURSOR_FORWARD_ONLY)
+  {
+    /* Number of rows is not known for the unbuffered result - we just fetch till MYSQL_NO_DATA */
+    Stmt->Cursor.RowsetSize= Rows2Fetch;
+
+    /* Rowset size may change between fetches, and next batch from the server side cursor should fit it */
+    if (MADB_STMT_USE_SERVER_CURSOR(Stmt))
+    {
+      unsigned long PrefetchRows= MADB_STMT_PREFETCH_ROWS(Stmt);
+      mysql_stmt_attr_set(Stmt->stmt, STMT_ATTR_PREFETCH_ROWS, (void*)&PrefetchRows);
+    }
+  }
+  else
+  {
+    Rows2Fetch= MADB_RowsToFetch(&Stmt->Cursor, Stmt->Ard->Header.ArraySize, mysql_stmt_num_rows(Stmt->stmt));
+  }
+  if (Rows2Fetch == 0)
+  {
+    UNLOCK_MARIADB(Stmt->Connection);
+    return SQL_NO_DATA;
+  }
+
+  /* Reading the rowset returns to its 1st row at the end, thus rows of the rowset, that are not in memory, have to be in
+     the window all at once */
+  if (Stmt->Options.CursorType != SQL_CURSOR_FORWARD_ONLY && Stmt->Cursor.Position >= 0 &&
+      MADB_SPILL_WINDOWED(Stmt, Stmt->Cursor.Position) &&
+      !SQL_SUCCEEDED(MADB_SpillSeek(Stmt, (unsigned long long)Stmt->Cursor.Position, Rows2Fetch)))
+  {
+    UNLOCK_MARIADB(Stmt->Connection);
+    return Stmt->Error.ReturnValue;
+  }
+
+  if (Stmt->Ard->Header.ArrayStatusPtr)
+  {
+    MADB_InitStatusPtr(Stmt->Ard->Header.ArrayStatusPtr, Stmt->Ard->Header.ArraySize, SQL_NO_DATA);
+  }
+
+  if (Stmt->Ird->Header.RowsProcessedPtr)
+  {
+    ProcessedPtr= Stmt->Ird->Header.RowsProcessedPtr;
+  }
+  if (Stmt->Ird->Header.ArrayStatusPtr)
+  {
+    MADB_InitStatusPtr(Stmt->Ird->Header.ArrayStatusPtr, Stmt->Ard->Header.ArraySize, SQL_ROW_NOROW);
+  }
+
+  *ProcessedPtr= 0;
+
+  Result= MADB_FetchRowset(Stmt, Rows2Fetch, ProcessedPtr, FALSE);
+  UNLOCK_MARIADB(Stmt->Connection);
+
   return Result;
 }
 /* }}} */
@@ -2276,6 +3308,12 @@ SQLRETURN MADB_StmtGetAttr(MADB_Stmt *Stmt, SQLINTEGER Attribute, SQLPOINTER Val
   case SQL_ATTR_RETRIEVE_DATA:
     *(SQLULEN *)ValuePtr= SQL_RD_ON;
     break;
+  case MADB_ATTR_ARROW_STREAM:
+    ret= MADB_ArrowExport(Stmt, (struct ArrowArrayStream *)ValuePtr, BufferLength);
+    break;
+  case MADB_ATTR_COLUMN_MAJOR:
+    *(SQLUINTEGER *)ValuePtr= Stmt->Options.ColumnMajor;
+    break;
   }
   return ret;
 }
@@ -2337,6 +3375,7 @@ SQLRETURN MADB_StmtSetAttr(MADB_Stmt *Stmt, SQLINTEGER Attribute, SQLPOINTER Val
         return Stmt->Error.ReturnValue;
       }
       RemoveStmtRefFromDesc(Stmt->Ard, Stmt, FALSE);
+      MADB_FetchPlanFree(Stmt);
       Stmt->Ard= Desc;
       Stmt->Ard->DescType= MADB_DESC_ARD;
       if (Stmt->Ard != Stmt->IArd)
@@ -2349,6 +3388,7 @@ SQLRETURN MADB_StmtSetAttr(MADB_Stmt *Stmt, SQLINTEGER Attribute, SQLPOINTER Val
     else
     {
       RemoveStmtRefFromDesc(Stmt->Ard, Stmt, FALSE);
+      MADB_FetchPlanFree(Stmt);
       Stmt->Ard= Stmt->IArd;
     }
     break;
@@ -2380,6 +3420,7 @@ SQLRETURN MADB_StmtSetAttr(MADB_Stmt *Stmt, SQLINTEGER Attribute, SQLPOINTER Val
     break;
   case SQL_ATTR_ROW_BIND_TYPE:
     Stmt->Ard->Header.BindType= (SQLINTEGER)(SQLLEN)ValuePtr;
+    ++Stmt->Ard->Version;
     break;
   case SQL_ATTR_ROW_OPERATION_PTR:
     Stmt->Ard->Header.ArrayStatusPtr= (SQLUSMALLINT *)ValuePtr;
@@ -2422,19 +3463,14 @@ SQLRETURN MADB_StmtSetAttr(MADB_Stmt *Stmt, SQLINTEGER Attribute, SQLPOINTER Val
     }
     else if (MA_ODBC_CURSOR_DYNAMIC(Stmt->Connection))
     {
-      if ((SQLULEN)ValuePtr == SQL_CURSOR_KEYSET_DRIVEN)
-      {
-        Stmt->Options.CursorType= SQL_CURSOR_STATIC;
-        MADB_SetError(&Stmt->Error, MADB_ERR_01S02, "Option value changed to default (SQL_CURSOR_STATIC)", 0);
-        return Stmt->Error.ReturnValue;
-      }
       Stmt->Options.CursorType= (SQLUINTEGER)(SQLULEN)ValuePtr;
     }
-    /* only FORWARD or Static is allowed */
+    /* only FORWARD, Static or Keyset-driven is allowed. Keyset-driven cursor is changed to static on execution, if the result
+       has no complete primary or unique key(see MADB_KeysetBuild) */
     else
     {
       if ((SQLULEN)ValuePtr != SQL_CURSOR_FORWARD_ONLY &&
-          (SQLULEN)ValuePtr != SQL_CURSOR_STATIC)
+          (SQLULEN)ValuePtr != SQL_CURSOR_STATIC && (SQLULEN)ValuePtr != SQL_CURSOR_KEYSET_DRIVEN)
       {
         Stmt->Options.CursorType= SQL_CURSOR_STATIC;
         MADB_SetError(&Stmt->Error, MADB_ERR_01S02, "Option value changed to default (SQL_CURSOR_STATIC)", 0);
@@ -2458,6 +3494,9 @@ SQLRETURN MADB_StmtSetAttr(MADB_Stmt *Stmt, SQLINTEGER Attribute, SQLPOINTER Val
   case SQL_ATTR_MAX_LENGTH:
     Stmt->Options.MaxLength= (SQLULEN)ValuePtr;
     break;
+  case MADB_ATTR_COLUMN_MAJOR:
+    Stmt->Options.ColumnMajor= (SQLULEN)ValuePtr != 0;
+    break;
   case SQL_ATTR_MAX_ROWS:
     Stmt->Options.MaxRows= (SQLULEN)ValuePtr;
     break;
@@ -2534,6 +3573,39 @@ SQLRETURN MADB_GetBookmark(MADB_Stmt  *Stmt,
   return SQL_SUCCESS;
 }
 
+/* {{{ MADB_ColumnLength - returns max_length of the column, or, if it is not known, since the result is not stored
+       (streamed result or server side cursor), the length of the value in the current row. That is only looked up once
+       per row, every SQLGetData call on the column reuses it */
+unsigned long MADB_ColumnLength(MADB_Stmt *Stmt, unsigned int Offset)
+{
+  MYSQL_BIND Bind;
+
+  if (Stmt->stmt->fields[Offset].max_length > 0)
+  {
+    return Stmt->stmt->fields[Offset].max_length;
+  }
+  if (Stmt->ColumnLengths != NULL && Stmt->ColumnLengths[Offset] > 0)
+  {
+    return Stmt->ColumnLengths[Offset] - 1;
+  }
+
+  memset(&Bind, 0, sizeof(MYSQL_BIND));
+  Bind.buffer_type= MYSQL_TYPE_STRING;
+  Bind.length=      &Bind.length_value;
+
+  if (mysql_stmt_fetch_column(Stmt->stmt, &Bind, Offset, 0) || (long)Bind.length_value == -1)
+  {
+    Bind.length_value= 0;
+  }
+  if (Stmt->ColumnLengths != NULL)
+  {
+    Stmt->ColumnLengths[Offset]= Bind.length_value + 1;
+  }
+
+  return Bind.length_value;
+}
+/* }}} */
+
 /* {{{ MADB_StmtGetData */
 SQLRETURN MADB_StmtGetData(SQLHSTMT StatementHandle,
                            SQLUSMALLINT Col_or_Param_Num,
@@ -2554,6 +3626,7 @@ SQLRETURN MADB_StmtGetData(SQLHSTMT StatementHandle,
   my_bool         Error;
   MADB_DescRecord *IrdRec= NULL;
   MYSQL_FIELD     *Field= mysql_fetch_field_direct(Stmt->metadata, Offset);
+  unsigned long   MaxLength;
 
   MADB_CLEAR_ERROR(&Stmt->Error);
 
@@ -2575,6 +3648,7 @@ SQLRETURN MADB_StmtGetData(SQLHSTMT StatementHandle,
     return SQL_SUCCESS;
   }
 
+  MaxLength= MADB_ColumnLength(Stmt, Offset);
   memset(&Bind, 0, sizeof(MYSQL_BIND));
 
   /* We might need it for SQL_C_DEFAULT type, or to obtain length of fixed length types(Access likes to have it) */
@@ -2634,13 +3708,13 @@ SQLRETURN MADB_StmtGetData(SQLHSTMT StatementHandle,
         char  *ClientValue= NULL;
         BOOL isTime;
 
-        if (!(ClientValue = (char *)MADB_CALLOC(Stmt->stmt->fields[Offset].max_length + 1)))
+        if (!(ClientValue = (char *)MADB_ArenaAlloc(&Stmt->Scratch, MaxLength + 1)))
         {
           return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
         }
         Bind.buffer=        ClientValue;
         Bind.buffer_type=   MYSQL_TYPE_STRING;
-        Bind.buffer_length= Stmt->stmt->fields[Offset].max_length + 1;
+        Bind.buffer_length= MaxLength + 1;
         mysql_stmt_fetch_column(Stmt->stmt, &Bind, Offset, 0);
         RETURN_ERROR_OR_CONTINUE(MADB_Str2Ts(ClientValue, Bind.length_value, &tm, FALSE, &Stmt->Error, &isTime));
       }
@@ -2677,13 +3751,13 @@ SQLRETURN MADB_StmtGetData(SQLHSTMT StatementHandle,
         char *ClientValue= NULL;
         BOOL isTime;
 
-        if (!(ClientValue = (char *)MADB_CALLOC(Stmt->stmt->fields[Offset].max_length + 1)))
+        if (!(ClientValue = (char *)MADB_ArenaAlloc(&Stmt->Scratch, MaxLength + 1)))
         {
           return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
         }
         Bind.buffer=        ClientValue;
         Bind.buffer_type=   MYSQL_TYPE_STRING;
-        Bind.buffer_length= Stmt->stmt->fields[Offset].max_length + 1;
+        Bind.buffer_length= MaxLength + 1;
         mysql_stmt_fetch_column(Stmt->stmt, &Bind, Offset, 0);
         RETURN_ERROR_OR_CONTINUE(MADB_Str2Ts(ClientValue, Bind.length_value, &tm, TRUE, &Stmt->Error, &isTime));
       }
@@ -2729,117 +3803,115 @@ SQLRETURN MADB_StmtGetData(SQLHSTMT StatementHandle,
   case SQL_WVARCHAR:
   case SQL_WLONGVARCHAR:
     {
-      char  *ClientValue= NULL;
-      size_t CharLength= 0;
+      size_t CharLength, CopyLength;
 
-      /* Kinda this it not 1st call for this value, and we have it nice and recoded */
-      if (IrdRec->InternalBuffer == NULL/* && Stmt->Lengths[Offset] == 0*/)
+      /* The first call for the value converts it as a whole. If it does not fit application's buffer(or the application
+         only asks for the length), converted value is kept in IrdRec->InternalBuffer, and following calls copy next
+         parts of it from there, without fetching and converting the value again */
+      if (IrdRec->InternalBuffer == NULL)
       {
-        if (!(ClientValue = (char *)MADB_CALLOC(Stmt->stmt->fields[Offset].max_length + 1)))
+        char *ClientValue;
+
+        if (!(ClientValue = (char *)MADB_ArenaAlloc(&Stmt->Scratch, MaxLength + 1)))
         {
           MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
           return Stmt->Error.ReturnValue;
         }
         Bind.buffer=        ClientValue;
         Bind.buffer_type=   MYSQL_TYPE_STRING;
-        Bind.buffer_length= Stmt->stmt->fields[Offset].max_length + 1;
+        Bind.buffer_length= MaxLength + 1;
 
-        if (mysql_stmt_fetch_column(Stmt->stmt, &Bind, Offset, Stmt->CharOffset[Offset]))
+        if (mysql_stmt_fetch_column(Stmt->stmt, &Bind, Offset, 0))
         {
           MADB_SetNativeError(&Stmt->Error, SQL_HANDLE_STMT, Stmt->stmt);
           return Stmt->Error.ReturnValue;
         }
 
-        /* check total length: if not enough space, we need to calculate new CharOffset for next fetch */
-        if (Stmt->stmt->fields[Offset].max_length)
+        if (MaxLength)
         {
           size_t ReqBuffOctetLen;
-          /* Size in chars */
-          CharLength= MbstrCharLen(ClientValue, Stmt->stmt->fields[Offset].max_length - Stmt->CharOffset[Offset],
-            Stmt->Connection->Charset.cs_info);
-          /* MbstrCharLen gave us length in characters. For encoding of each character we might need
-             2 SQLWCHARs in case of UTF16, or 1 SQLWCHAR in case of UTF32. Probably we need calcualate better
-             number of required SQLWCHARs */
-          ReqBuffOctetLen= (CharLength + 1)*(4/sizeof(SQLWCHAR))*sizeof(SQLWCHAR);
-
-          if (BufferLength)
+
+          if (MADB_IS_UTF8(Stmt->Connection->Charset.cs_info))
           {
-            /* Buffer is not big enough. Alocating InternalBuffer.
-               MADB_SetString would do that anyway if - allocate buffer fitting the whole wide string,
-               and then copied its part to the application's buffer */
-            if (ReqBuffOctetLen > (size_t)BufferLength)
-            {
-              IrdRec->InternalBuffer= (char*)MADB_CALLOC(ReqBuffOctetLen);
+            /* utf8 string never has less bytes, than its utf16 or utf32 representation has units */
+            ReqBuffOctetLen= (MaxLength + 1)*sizeof(SQLWCHAR);
+          }
+          else
+          {
+            /* MbstrCharLen gives length in characters. For encoding of each character we might need
+               2 SQLWCHARs in case of UTF16, or 1 SQLWCHAR in case of UTF32 */
+            ReqBuffOctetLen= (MbstrCharLen(ClientValue, MaxLength, Stmt->Connection->Charset.cs_info) + 1)
+                             *(4/sizeof(SQLWCHAR))*sizeof(SQLWCHAR);
+          }
 
-              if (IrdRec->InternalBuffer == 0)
-              {
-                MADB_FREE(ClientValue);
-                return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
-              }
+          if (BufferLength > 0 && ReqBuffOctetLen <= (size_t)BufferLength)
+          {
+            /* Application's buffer is big enough - writing directly there */
+            CharLength= MADB_SetString(&Stmt->Connection->Charset, TargetValuePtr, (SQLINTEGER)(BufferLength / sizeof(SQLWCHAR)),
+              ClientValue, MaxLength, &Stmt->Error);
+          }
+          else
+          {
+            IrdRec->InternalBuffer= (char*)MADB_CALLOC(ReqBuffOctetLen);
 
-              CharLength= MADB_SetString(&Stmt->Connection->Charset, IrdRec->InternalBuffer, (SQLINTEGER)ReqBuffOctetLen / sizeof(SQLWCHAR),
-                ClientValue, Stmt->stmt->fields[Offset].max_length - Stmt->CharOffset[Offset], &Stmt->Error);
-            }
-            else
+            if (IrdRec->InternalBuffer == 0)
             {
-              /* Application's buffer is big enough - writing directly there */
-              CharLength= MADB_SetString(&Stmt->Connection->Charset, TargetValuePtr, (SQLINTEGER)(BufferLength / sizeof(SQLWCHAR)),
-                ClientValue, Stmt->stmt->fields[Offset].max_length - Stmt->CharOffset[Offset], &Stmt->Error);
+              return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
             }
 
-            if (!SQL_SUCCEEDED(Stmt->Error.ReturnValue))
-            {
-              MADB_FREE(ClientValue);
-              MADB_FREE(IrdRec->InternalBuffer);
-
-              return Stmt->Error.ReturnValue;
-            }
+            CharLength= MADB_SetString(&Stmt->Connection->Charset, IrdRec->InternalBuffer, (SQLINTEGER)ReqBuffOctetLen / sizeof(SQLWCHAR),
+              ClientValue, MaxLength, &Stmt->Error);
           }
 
-          if (!Stmt->CharOffset[Offset])
+          if (!SQL_SUCCEEDED(Stmt->Error.ReturnValue))
           {
-            Stmt->Lengths[Offset]= (unsigned long)(CharLength*sizeof(SQLWCHAR));
+            MADB_FREE(IrdRec->InternalBuffer);
+
+            return Stmt->Error.ReturnValue;
           }
+
+          Stmt->Lengths[Offset]= (unsigned long)(CharLength*sizeof(SQLWCHAR));
         }
         else if (BufferLength >= sizeof(SQLWCHAR))
         {
           *(SQLWCHAR*)TargetValuePtr= 0;
         }
       }
-      else  /* IrdRec->InternalBuffer == NULL && Stmt->Lengths[Offset] == 0 */
-      {
-        CharLength= SqlwcsLen((SQLWCHAR*)((char*)IrdRec->InternalBuffer + Stmt->CharOffset[Offset]), -1);
-      }
+
+      /* Length of the rest of the value, that has not been returned yet */
+      CharLength= (Stmt->Lengths[Offset] - Stmt->CharOffset[Offset])/sizeof(SQLWCHAR);
 
       if (StrLen_or_IndPtr)
       {
         *StrLen_or_IndPtr= CharLength * sizeof(SQLWCHAR);
       }
 
-      if (!BufferLength)
+      if (BufferLength < (SQLLEN)sizeof(SQLWCHAR))
       {
-        MADB_FREE(ClientValue);
-
         return MADB_SetError(&Stmt->Error, MADB_ERR_01004, NULL, 0);
       }
 
+      /* Units, that fit the buffer along with the terminating null */
+      CopyLength= MIN((size_t)BufferLength/sizeof(SQLWCHAR) - 1, CharLength);
+
       if (IrdRec->InternalBuffer)
       {
-        /* If we have more place than only for the TN */
-        if (BufferLength > sizeof(SQLWCHAR))
+        SQLWCHAR *Rest= (SQLWCHAR*)((char*)IrdRec->InternalBuffer + Stmt->CharOffset[Offset]);
+
+        /* Surrogate pair is not split between the parts, unless the buffer can't hold the pair at all. Backing off to
+           nothing would never make progress */
+        if (sizeof(SQLWCHAR) == 2 && CopyLength > 1 && CopyLength < CharLength
+         && (Rest[CopyLength - 1] & 0xFC00) == 0xD800)
         {
-          memcpy(TargetValuePtr, (char*)IrdRec->InternalBuffer + Stmt->CharOffset[Offset],
-            MIN(BufferLength - sizeof(SQLWCHAR), CharLength*sizeof(SQLWCHAR)));
+          --CopyLength;
         }
-        /* Terminating Null */
-        *(SQLWCHAR*)((char*)TargetValuePtr + MIN(BufferLength - sizeof(SQLWCHAR), CharLength*sizeof(SQLWCHAR)))= 0;
+        memcpy(TargetValuePtr, Rest, CopyLength*sizeof(SQLWCHAR));
+        ((SQLWCHAR*)TargetValuePtr)[CopyLength]= 0;
       }
 
-      if (CharLength >= BufferLength / sizeof(SQLWCHAR))
+      if (CopyLength < CharLength)
       {
-        /* Calculate new offset and substract 1 byte for null termination */
-        Stmt->CharOffset[Offset]+= (unsigned long)BufferLength - sizeof(SQLWCHAR);
-        MADB_FREE(ClientValue);
+        Stmt->CharOffset[Offset]+= (unsigned long)(CopyLength*sizeof(SQLWCHAR));
 
         return MADB_SetError(&Stmt->Error, MADB_ERR_01004, NULL, 0);
       }
@@ -2848,8 +3920,6 @@ SQLRETURN MADB_StmtGetData(SQLHSTMT StatementHandle,
         Stmt->CharOffset[Offset]= Stmt->Lengths[Offset];
         MADB_FREE(IrdRec->InternalBuffer);
       }
-
-      MADB_FREE(ClientValue);
     }
     break;
   case SQL_CHAR:
@@ -2859,7 +3929,7 @@ SQLRETURN MADB_StmtGetData(SQLHSTMT StatementHandle,
     {
       if (!BufferLength && StrLen_or_IndPtr)
       {
-        *StrLen_or_IndPtr= Stmt->stmt->fields[Offset].max_length * 2;
+        *StrLen_or_IndPtr= MaxLength * 2;
         return SQL_SUCCESS_WITH_INFO;
       }
      
@@ -2895,13 +3965,13 @@ SQLRETURN MADB_StmtGetData(SQLHSTMT StatementHandle,
         
         if (InternalUse) 
         {
-          *StrLen_or_IndPtr= MIN(*Bind.length, Stmt->stmt->fields[Offset].max_length);
+          *StrLen_or_IndPtr= MIN(*Bind.length, MaxLength);
         }
         else
         {
           if (!Stmt->CharOffset[Offset])
           {
-            Stmt->Lengths[Offset]= MIN(*Bind.length, Stmt->stmt->fields[Offset].max_length);
+            Stmt->Lengths[Offset]= MIN(*Bind.length, MaxLength);
           }
           *StrLen_or_IndPtr= Stmt->Lengths[Offset] - Stmt->CharOffset[Offset];
         }
@@ -2926,7 +3996,7 @@ SQLRETURN MADB_StmtGetData(SQLHSTMT StatementHandle,
 
       if (!InternalUse && !Stmt->CharOffset[Offset])
       {
-        Stmt->Lengths[Offset]= MIN(*Bind.length, Stmt->stmt->fields[Offset].max_length);
+        Stmt->Lengths[Offset]= MIN(*Bind.length, MaxLength);
       }
       if (ZeroTerminated)
       {
@@ -2970,19 +4040,25 @@ SQLRETURN MADB_StmtGetData(SQLHSTMT StatementHandle,
     MADB_DescRecord *Ard= MADB_DescGetInternalRecord(Stmt->Ard, Offset, MADB_DESC_READ);
 
     Bind.buffer_length= MADB_DEFAULT_PRECISION + 1/*-*/ + 1/*.*/;
-    tmp=                (char *)MADB_CALLOC(Bind.buffer_length);
+    tmp=                (char *)MADB_ArenaAlloc(&Stmt->Scratch, Bind.buffer_length + 1);
     Bind.buffer=        tmp;
 
+    if (tmp == NULL)
+    {
+      return MADB_SetError(&Stmt->Error, MADB_ERR_HY001, NULL, 0);
+    }
+    /* Arena memory is not zeroed, and the value filling the whole buffer would not be terminated */
+    tmp[Bind.buffer_length]= '\0';
+
     Bind.buffer_type=   MadbType;
 
     mysql_stmt_fetch_column(Stmt->stmt, &Bind, Offset, 0);
 
     MADB_CLEAR_ERROR(&Stmt->Error);
 
-    if (Bind.buffer_length < Stmt->stmt->fields[Offset].max_length)
+    if (Bind.buffer_length < MaxLength)
     {
       MADB_SetError(&Stmt->Error, MADB_ERR_22003, NULL, 0);
-      MADB_FREE(tmp);
       return Stmt->Error.ReturnValue;
     }
 
@@ -3069,6 +4145,9 @@ SQLRETURN MADB_StmtRowCount(MADB_Stmt *Stmt, SQLLEN *RowCountPtr)
 {
   if (Stmt->AffectedRows != -1)
     *RowCountPtr= (SQLLEN)Stmt->AffectedRows;
+  /* Unbuffered result - we can't know number of rows before all of them are fetched */
+  else if (MADB_STMT_IS_STREAMED(Stmt) && mysql_stmt_field_count(Stmt->stmt))
+    *RowCountPtr= -1;
   else if (Stmt->stmt && Stmt->stmt->result.rows && mysql_stmt_field_count(Stmt->stmt))
     *RowCountPtr= (SQLLEN)mysql_stmt_num_rows(Stmt->stmt);
   else
@@ -4265,7 +5344,15 @@ SQLRETURN MADB_RefreshDynamicCursor(MADB_Stmt *Stmt)
   long long AffectedRows=   Stmt->AffectedRows;
   SQLLEN    LastRowFetched= Stmt->LastRowFetched;
 
-  ret= Stmt->Methods->Execute(Stmt, FALSE);
+  /* Re-executing Presto query on every scroll is expensive - the result is re-used for DYNAMIC_CURSOR_REFRESH ms */
+  if (MADB_DYNCURSOR_IS_CURRENT(Stmt))
+  {
+    ret= SQL_SUCCESS;
+  }
+  else
+  {
+    ret= Stmt->Methods->Execute(Stmt, FALSE);
+  }
 
   Stmt->Cursor.Position= CurrentRow;
   if (Stmt->Cursor.Position > 0 && (my_ulonglong)Stmt->Cursor.Position >= mysql_stmt_num_rows(Stmt->stmt))
@@ -4298,13 +5385,17 @@ SQLRETURN MADB_StmtSetPos(MADB_Stmt *Stmt, SQLSETPOSIROW RowNumber, SQLUSMALLINT
     MADB_SetError(&Stmt->Error, MADB_ERR_24000, NULL, 0);
     return Stmt->Error.ReturnValue;
   }
-  /* skip this for now, since we don't use unbuffered result sets 
-  if (Stmt->Options.CursorType == SQL_CURSOR_FORWARD_ONLY)
+  /* Forward-only cursor is read unbuffered, and can't be positioned within the rowset. The only row we can stay on is the last
+     fetched one, and the insert does not need positioning at all */
+  if (Stmt->Options.CursorType == SQL_CURSOR_FORWARD_ONLY && Operation != SQL_ADD)
   {
-    MADB_SetError(&Stmt->Error, MADB_ERR_24000, NULL, 0);
+    if (Operation == SQL_POSITION && RowNumber > 0 && (SQLLEN)RowNumber == Stmt->LastRowFetched)
+    {
+      return SQL_SUCCESS;
+    }
+    MADB_SetError(&Stmt->Error, MADB_ERR_HY109, NULL, 0);
     return Stmt->Error.ReturnValue;
   }
-  */
   if (LockType != SQL_LOCK_NO_CHANGE)
   {
     MADB_SetError(&Stmt->Error, MADB_ERR_HYC00, NULL, 0);
@@ -4609,6 +5700,7 @@ SQLRETURN MADB_StmtSetPos(MADB_Stmt *Stmt, SQLSETPOSIROW RowNumber, SQLUSMALLINT
         }
 
         LOCK_MARIADB(Stmt->Connection);
+        MADB_StoreStreamer(Stmt->Connection, Stmt);
         if (mysql_real_query(Stmt->Connection->mariadb, DynamicStmt.str, (unsigned long)DynamicStmt.length))
         {
           MADB_DynstrFree(&DynamicStmt);
@@ -4620,6 +5712,7 @@ SQLRETURN MADB_StmtSetPos(MADB_Stmt *Stmt, SQLSETPOSIROW RowNumber, SQLUSMALLINT
           return Stmt->Error.ReturnValue;
         }
         MADB_DynstrFree(&DynamicStmt);
+        ++Stmt->Connection->Changes;
         Stmt->AffectedRows+= mysql_affected_rows(Stmt->Connection->mariadb);
         Start++;
       }
@@ -4733,7 +5826,12 @@ SQLRETURN MADB_StmtFetchScroll(MADB_Stmt *Stmt, SQLSMALLINT FetchOrientation,
     break;
   }
 
-  if (Position < 0)
+  if (Stmt->Options.CursorType == SQL_CURSOR_FORWARD_ONLY)
+  {
+    /* Result is unbuffered and its size is unknown. The fetch will tell if there are no more rows */
+    Stmt->Cursor.Position= Position;
+  }
+  else if (Position < 0)
   {
     MADB_STMT_RESET_CURSOR(Stmt);
   }
@@ -4741,7 +5839,8 @@ SQLRETURN MADB_StmtFetchScroll(MADB_Stmt *Stmt, SQLSMALLINT FetchOrientation,
   {
     Stmt->Cursor.Position= (SQLLEN)MIN((my_ulonglong)Position, mysql_stmt_num_rows(Stmt->stmt));
   }
-  if (Position < 0 || (my_ulonglong)Position > mysql_stmt_num_rows(Stmt->stmt) - 1)
+  if (Stmt->Options.CursorType != SQL_CURSOR_FORWARD_ONLY &&
+      (Position < 0 || (my_ulonglong)Position > mysql_stmt_num_rows(Stmt->stmt) - 1))
   {
     /* We need to put cursor before RS start, not only return error */
     if (Position < 0)
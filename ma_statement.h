@@ -103,10 +103,98 @@ struct st_ma_stmt_methods
   SQLRETURN (*GetOutParams)(MADB_Stmt *Stmt, int CurrentOffset);
 };
 
+/* Column of the fetch plan. Value of row N goes to Ptr + BindOffset + N * Stride, where Ptr is the ARD record's pointer */
+struct st_ma_fetch_column;
+
+/* Converter of the fetched value of the column to the application's buffer. Chosen for the column by its pair of IRD SQL type
+   and ARD C type, once the fetch plan is built */
+typedef SQLRETURN (*MADB_FixValue)(MADB_Stmt *Stmt, struct st_ma_fetch_column *Column, unsigned int i, int RowNumber,
+                                   void *DataPtr, SQLLEN *LengthPtr, SQLLEN *IndicatorPtr);
+/* Converter of values of the column for rows First..First+Count-1 of the rowset, used by column-major fetch. Value[Row]
+   points to the value in the row, NULL for NULL value. Results of rows are accumulated in RowResult[Row], diagnostics go to
+   Error, since parts of the rowset can be converted by different threads */
+typedef void (*MADB_FixBatch)(MADB_Stmt *Stmt, struct st_ma_fetch_column *Column, unsigned char **Value, SQLULEN First,
+                              SQLULEN Count, SQLRETURN *RowResult, MADB_Error *Error);
+
+typedef struct st_ma_fetch_column
+{
+  void            *DataPtr;       /* ARD record's pointers */
+  SQLLEN          *LengthPtr;
+  SQLLEN          *IndicatorPtr;
+  MYSQL_BIND       Bind;          /* Template of the C/C bind structure for the column */
+  char            *Buffer;        /* Conversion buffer, if the value is not fetched directly to the application's buffer */
+  size_t           DataStride;
+  size_t           LengthStride;  /* Stride of both length and indicator buffers */
+  MADB_FixValue    Fix;           /* NULL, if the column has no data buffer bound */
+  MADB_FixBatch    Batch;         /* NULL, if the column can't be fetched column-major */
+  unsigned int     Width;         /* Width of the value, Batch copies */
+  SQLLEN           OctetLength;   /* ARD record's octet length */
+  SQLSMALLINT      CType;         /* ARD record's (verbose) type */
+  SQLSMALLINT      SqlType;       /* IRD record's concise type */
+  my_bool          InUse;         /* Column is bound */
+  my_bool          Direct;        /* C/C writes the value directly to the application's buffer */
+  my_bool          Raw;           /* C/C doesn't fetch the value, the converter reads it from the row */
+} MADB_FetchColumn;
+
+/* Fetch plan - how columns are fetched and converted. It's built once per result metadata and ARD binding, and is used for
+   every row until either of them changes */
+typedef struct st_ma_fetch_plan
+{
+  MADB_Desc        *Ard;
+  unsigned int      ArdVersion;
+  unsigned int      IrdVersion;
+  SQLSMALLINT       ColumnCount;
+  size_t            BindOffset;   /* Value of the ARD's bind offset at the beginning of the rowset */
+  MADB_FetchColumn *Column;
+  SQLSMALLINT      *Bound;        /* Indexes of bound columns, so that per row work does not depend on the result width */
+  SQLSMALLINT       BoundCount;
+  my_bool           Batchable;    /* All bound columns can be fetched column-major */
+  unsigned char   **Values;       /* Column-major fetch: pointers to values of bound columns, rows of each column together */
+  SQLULEN           ValuesRows;   /* Number of rows Values has room for */
+  MADB_Arena        Copies;       /* Copies of values of rows, that do not stay in memory after the next row is read */
+} MADB_FetchPlan;
+
+/* Part of the rowset, converted column-major by one thread */
+typedef struct st_ma_fix_part
+{
+  MADB_Stmt   *Stmt;
+  SQLULEN      First;
+  SQLULEN      Count;
+  SQLRETURN   *RowResult;
+  MADB_Error   Error;         /* Diagnostics of the part, merged into the statement's once all parts are converted */
+  struct st_ma_fix_part *Next; /* Next part in the queue of the pool */
+  my_bool      Done;
+} MADB_FixPart;
+
+/* Connection's threads converting parts of large rowsets. Started on first use, and joined when the connection is freed */
+typedef struct st_ma_fix_pool
+{
+  CRITICAL_SECTION cs;
+  MADB_COND     Queued;       /* Signalled when parts are queued, or the pool is being closed */
+  MADB_COND     Converted;    /* Signalled when a part has been converted */
+  MADB_FixPart *Queue;
+  MADB_FixPart *QueueLast;
+  MADB_THREAD  *Thread;
+  unsigned int  ThreadCount;
+  my_bool       Closing;
+} MADB_FixPool;
+
+#define MADB_PLAN_PTR(aPlan, aPtr, aStride, aRow) ((aPtr) == NULL ? NULL :\
+  (void *)((char *)(aPtr) + (aPlan)->BindOffset + (aStride) * (aRow)))
+
 SQLRETURN    MADB_StmtInit          (MADB_Dbc *Connection, SQLHANDLE *pHStmt);
 SQLUSMALLINT MapColAttributeDescType(SQLUSMALLINT FieldIdentifier);
 MYSQL_RES*   FetchMetadata          (MADB_Stmt *Stmt);
 SQLRETURN    MADB_DoExecute(MADB_Stmt *Stmt, BOOL ExecDirect);
+void         MADB_SetServerCursor(MADB_Stmt *Stmt);
+BOOL         MADB_ServerCursorExists(MADB_Stmt *Stmt);
+unsigned long MADB_ColumnLength(MADB_Stmt *Stmt, unsigned int Offset);
+void         ResetDescIntBuffers(MADB_Desc *Desc);
+void         MADB_FetchPlanFree(MADB_Stmt *Stmt);
+void         MADB_FixPoolFree(MADB_Dbc *Dbc);
+SQLRETURN    MADB_StmtBindRowset(MADB_Stmt *Stmt);
+SQLRETURN    MADB_StmtFetchBound(MADB_Stmt *Stmt);
+int          MADB_CutFetchedRow(MADB_Stmt *Stmt, MADB_Arena *Arena);
 
 #define MADB_MAX_CURSOR_NAME 64 * 3 + 1
 #define MADB_CHECK_STMT_HANDLE(a,b)\
@@ -120,10 +208,44 @@ SQLRETURN    MADB_DoExecute(MADB_Stmt *Stmt, BOOL ExecDirect);
 /* So far we always use all fields for index. Once that is changed, this should be changed as well */
 #define MADB_POS_COMM_IDX_FIELD_COUNT(aStmt) MADB_STMT_COLUMN_COUNT((aStmt)->PositionedCursor)
 #define MADB_STMT_FORGET_NEXT_POS(aStmt) (aStmt)->Cursor.Next= NULL
+#define MADB_COLUMN_LENGTHS_RESET(aStmt) if ((aStmt)->ColumnLengths != NULL)\
+  memset((aStmt)->ColumnLengths, 0, sizeof(long) * mysql_stmt_field_count((aStmt)->stmt))
 #define MADB_STMT_RESET_CURSOR(aStmt) (aStmt)->Cursor.Position= -1; MADB_STMT_FORGET_NEXT_POS(aStmt)
 #define MADB_STMT_CLOSE_STMT(aStmt)   mysql_stmt_close((aStmt)->stmt);(aStmt)->stmt= NULL
+/* Result of forward-only cursor is not stored on execution, but read from the connection as rows are fetched */
+#define MADB_STMT_IS_STREAMED(aStmt)  ((aStmt)->State == MADB_SS_EXECUTED && (aStmt)->MultiStmts == NULL &&\
+                                       (aStmt)->Options.CursorType == SQL_CURSOR_FORWARD_ONLY)
+/* Forward-only result can be read via server side cursor in batches of PREFETCH_ROWS or of rowset size rows */
+#define MADB_STMT_USE_SERVER_CURSOR(aStmt) ((aStmt)->Connection->Dsn->PrefetchRows > 0 &&\
+                                       (aStmt)->Options.CursorType == SQL_CURSOR_FORWARD_ONLY)
+/* Result of a statement of multi-statement batch, executed with server side cursor, is not stored on execution. Statements
+   of the batch are still executed one after another by SQLExecute, but rows stay on the server, and are only transferred,
+   if the application fetches them. Their execution does not overlap with the application reading the results. If server
+   has not opened the cursor, rows follow the execution response, and have to be read right away */
+#define MADB_STMT_LAZY_RESULT(aStmt) (MADB_STMT_USE_SERVER_CURSOR(aStmt) && MADB_ServerCursorExists(aStmt))
+/* Dynamic cursor re-reads its result before scrolling, unless it was read less than DYNAMIC_CURSOR_REFRESH ms ago, and nothing
+   has been changed via the connection since then */
+#define MADB_DYNCURSOR_IS_CURRENT(aStmt) ((aStmt)->Connection->Dsn->DynCursorRefresh > 0 &&\
+                                       (aStmt)->Cursor.Changes == (aStmt)->Connection->Changes &&\
+                                       MADB_GetTickCount() - (aStmt)->Cursor.Refreshed < (aStmt)->Connection->Dsn->DynCursorRefresh)
+#define MADB_DYNCURSOR_SET_REFRESHED(aStmt) (aStmt)->Cursor.Refreshed= MADB_GetTickCount();\
+                                       (aStmt)->Cursor.Changes= (aStmt)->Connection->Changes
+#define MADB_STMT_PREFETCH_ROWS(aStmt) (unsigned long)MAX((aStmt)->Ard->Header.ArraySize, (aStmt)->Connection->Dsn->PrefetchRows)
+/* Driver specific statement attribute. If set, and columns are bound column-wise, rowset is read first, and then values are
+   converted column by column, if all bound columns can be. Only then large rowset can be converted by several threads */
+#define MADB_ATTR_COLUMN_MAJOR (SQL_DRIVER_STMT_ATTR_BASE + 2)
+#define MADB_COLUMN_MAJOR(aStmt) ((aStmt)->Options.ColumnMajor && (aStmt)->FetchPlan->Batchable &&\
+                                  (aStmt)->Ard->Header.BindType == SQL_BIND_BY_COLUMN &&\
+                                  (aStmt)->Options.CursorType != SQL_CURSOR_KEYSET_DRIVEN)
+/* Column-major conversion of large rowset is split between the application's thread, and up to CONVERSION_THREADS - 1
+   threads of the connection's pool, each converting at least MADB_FIX_PART_ROWS rows */
+#define MADB_FIX_PART_ROWS 2048
+#define MADB_PARALLEL_FIX(aStmt, aRows) ((aStmt)->Connection->Dsn->ConversionThreads > 1 &&\
+                                         (aRows) >= 2 * MADB_FIX_PART_ROWS)
 
 #define MADB_OCTETS_PER_CHAR 2
+/* Buffer length for the string representation of date/time value, if the result is not stored, and max_length of the field is not known */
+#define MADB_MAX_DATETIME_STRLEN 64
 
 #define MADB_TRANSFER_OCTET_LENGTH(TYPE_DEF_COL_NAME)\
   "@tol:=CAST(CASE @dt"\
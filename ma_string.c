@@ -206,13 +206,59 @@ my_bool MADB_DynStrGetColumns(MADB_Stmt *Stmt, MADB_DynString *DynString)
   return FALSE;
 }
 
+/* {{{ MADB_DynStrAppendLiteral - appends the value of the field, given as string, as SQL literal */
+my_bool MADB_DynStrAppendLiteral(MYSQL *Mariadb, MADB_DynString *DynString, MYSQL_FIELD *Field, char *Value, unsigned long Length)
+{
+  char   *Escaped= MADB_CALLOC(2 * Length + 1);
+  my_bool rc;
+
+  if (Escaped == NULL)
+  {
+    return TRUE;
+  }
+  mysql_real_escape_string(Mariadb, Escaped, Value, Length);
+
+  //add literal value prefix and suffix base on data type
+  switch(Field->type) {
+  case MYSQL_TYPE_BLOB:
+  case MYSQL_TYPE_LONG_BLOB:
+  case MYSQL_TYPE_MEDIUM_BLOB:
+  case MYSQL_TYPE_STRING:
+  case MYSQL_TYPE_TINY_BLOB:
+  case MYSQL_TYPE_VAR_STRING:
+    if (Field->flags & BINARY_FLAG)
+    {
+      rc= MADB_DynstrAppend(DynString, "0x") ||
+          MADB_DynstrAppend(DynString, Escaped);
+      break;
+    }
+    /* else default */
+  case MYSQL_TYPE_DATE:
+  case MYSQL_TYPE_DATETIME:
+  case MYSQL_TYPE_NEWDATE:
+  case MYSQL_TYPE_TIME:
+  case MYSQL_TYPE_TIMESTAMP:
+  case MYSQL_TYPE_YEAR:
+    rc= MADB_DynstrAppend(DynString, "'") ||
+        MADB_DynstrAppend(DynString, Escaped) ||
+        MADB_DynstrAppend(DynString, "'");
+    break;
+  default:
+    rc= MADB_DynstrAppend(DynString, Escaped);
+    break;
+  }
+  MADB_FREE(Escaped);
+
+  return rc;
+}
+/* }}} */
+
 my_bool MADB_DynStrGetWhere(MADB_Stmt *Stmt, MADB_DynString *DynString, char *TableName, my_bool ParameterMarkers)
 {
   int UniqueCount=0, PrimaryCount= 0;
   int i, Flag= 0;
-  char *Column= NULL, *Escaped= NULL;
+  char *Column= NULL;
   SQLLEN StrLength;
-  unsigned long EscapedLength;
 
   for (i= 0; i < MADB_STMT_COLUMN_COUNT(Stmt); i++)
   {
@@ -279,52 +325,12 @@ my_bool MADB_DynStrGetWhere(MADB_Stmt *Stmt, MADB_DynString *DynString, char *Ta
         {
           Column= MADB_CALLOC(StrLength + 1);
           Stmt->Methods->GetData(Stmt,i+1, SQL_C_CHAR, Column, StrLength + 1, &StrLength, TRUE);
-          Escaped = MADB_CALLOC(2 * StrLength + 1);
-          EscapedLength= mysql_real_escape_string(Stmt->Connection->mariadb, Escaped, Column, (unsigned long)StrLength);
-
-          //add literal value prefix and suffix base on data type
-          switch(field->type) {
-          case MYSQL_TYPE_BLOB:
-          case MYSQL_TYPE_LONG_BLOB:
-          case MYSQL_TYPE_MEDIUM_BLOB:
-          case MYSQL_TYPE_STRING:
-          case MYSQL_TYPE_TINY_BLOB:
-          case MYSQL_TYPE_VAR_STRING:
-            if (field->flags & BINARY_FLAG)
-            {
-              if (MADB_DynstrAppend(DynString, "= 0x") ||
-                MADB_DynstrAppend(DynString, Escaped) ||//, EscapedLength) ||
-                MADB_DynstrAppend(DynString, ""))
-              {
-                goto memerror;
-              }
-              break;
-            }
-            /* else default */
-          case MYSQL_TYPE_DATE:
-          case MYSQL_TYPE_DATETIME:
-          case MYSQL_TYPE_NEWDATE:
-          case MYSQL_TYPE_TIME:
-          case MYSQL_TYPE_TIMESTAMP:
-          case MYSQL_TYPE_YEAR:
-            if (MADB_DynstrAppend(DynString, "= '") ||
-                MADB_DynstrAppend(DynString, Escaped) ||//, EscapedLength) ||
-                MADB_DynstrAppend(DynString, "'"))
-              {
-                goto memerror;
-              }
-            break;
-          default:
-            if (MADB_DynstrAppend(DynString, "= ") ||
-                MADB_DynstrAppend(DynString, Escaped) ||//, EscapedLength) ||
-                MADB_DynstrAppend(DynString, ""))
-              {
-                goto memerror;
-              }
-            break;
+          if (MADB_DynstrAppend(DynString, "= ") ||
+              MADB_DynStrAppendLiteral(Stmt->Connection->mariadb, DynString, field, Column, (unsigned long)StrLength))
+          {
+            goto memerror;
           }
           MADB_FREE(Column);
-          MADB_FREE(Escaped);
         }
       }
     }
@@ -482,6 +488,25 @@ SQLLEN MbstrOctetLen(const char *str, SQLLEN *CharLen, MARIADB_CHARSET_INFO *cs)
 
   if (str)
   {
+    if (MADB_IS_UTF8(cs))
+    {
+      if (*CharLen < 0)
+      {
+        result=   (SQLLEN)strlen(str);
+        *CharLen= (SQLLEN)MADB_Utf8CharLen(str, (size_t)result);
+      }
+      else
+      {
+        const unsigned char *ptr= (const unsigned char *)str;
+
+        /* Length of the character by its first byte, without charset's callback */
+        while (inChars-- > 0)
+        {
+          result+= ptr[result] < 0xC0 ? 1 : ptr[result] < 0xE0 ? 2 : ptr[result] < 0xF0 ? 3 : 4;
+        }
+      }
+      return result;
+    }
     if (cs->mb_charlen == NULL)
     {
       /* Charset uses no more than a byte per char. Result is strlen or umber of chars */
@@ -528,6 +553,10 @@ SQLLEN MbstrCharLen(const char *str, SQLINTEGER OctetLen, MARIADB_CHARSET_INFO *
     {
       return OctetLen;
     }
+    if (MADB_IS_UTF8(cs))
+    {
+      return OctetLen > 0 ? (SQLLEN)MADB_Utf8CharLen(str, (size_t)OctetLen) : 0;
+    }
     while (ptr < str + OctetLen)
     {
       charlen= cs->mb_charlen((unsigned char)*ptr);
@@ -586,19 +615,11 @@ SQLINTEGER SqlwcsCharLen(SQLWCHAR *str, SQLLEN octets)
    @buff_length[in] - size of the str buffer or negative number  */
 SQLLEN SqlwcsLen(SQLWCHAR *str, SQLLEN buff_length)
 {
-  SQLINTEGER result= 0;
-
   if (str)
   {
-    /* If buff_length is negative - we will never hit 1st condition, otherwise we hit it after last character
-       of the buffer is processed */
-    while ((--buff_length) != -1 && *str)
-    {
-      ++result;
-      ++str;
-    }
+    return MADB_WcsLen(str, buff_length);
   }
-  return result;
+  return 0;
 }
 
 /* Length of a string with respect to specified buffer size
@@ -30,6 +30,7 @@ my_bool   MADB_DynStrUpdateSet(MADB_Stmt *Stmt, MADB_DynString *DynString);
 my_bool   MADB_DynStrInsertSet(MADB_Stmt *Stmt, MADB_DynString *DynString);
 my_bool   MADB_DynStrGetWhere(MADB_Stmt *Stmt, MADB_DynString *DynString, char *TableName, my_bool ParameterMarkers);
 my_bool   MADB_DynStrAppendQuoted(MADB_DynString *DynString, char *String);
+my_bool   MADB_DynStrAppendLiteral(MYSQL *Mariadb, MADB_DynString *DynString, MYSQL_FIELD *Field, char *Value, unsigned long Length);
 my_bool   MADB_DynStrGetColumns(MADB_Stmt *Stmt, MADB_DynString *DynString);
 my_bool   MADB_DynStrGetValues(MADB_Stmt *Stmt, MADB_DynString *DynString);
 SQLWCHAR* MADB_ConvertToWchar(const char *Ptr, SQLLEN PtrLength, Client_Charset* cc);
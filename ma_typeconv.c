@@ -21,101 +21,16 @@
 
 #include <ma_odbc.h>
 
-/* Borrowed from C/C and adapted */
+/* {{{ MADB_Str2Ts */
 SQLRETURN MADB_Str2Ts(const char *Str, size_t Length, MYSQL_TIME *Tm, BOOL Interval, MADB_Error *Error, BOOL *isTime)
 {
-  char *Start= MADB_ALLOC(Length + 1), *Frac, *End= Start + Length;
-  my_bool isDate= 0;
-
-  if (Start == NULL)
+  if (!MADB_ParseDateTime(Str, Length, Tm, Interval, isTime))
   {
-    return MADB_SetError(Error, MADB_ERR_HY001, NULL, 0);
-  }
-
-  memset(Tm, 0, sizeof(MYSQL_TIME));
-  memcpy(Start, Str, Length);
-  Start[Length]= '\0';
-
-  while (Length && isspace(*Start)) Start++, Length--;
-
-  if (Length == 0)
-  {
-    return SQL_SUCCESS;//MADB_SetError(Error, MADB_ERR_22008, NULL, 0);
-  }  
-
-  /* Determine time type:
-  MYSQL_TIMESTAMP_DATE: [-]YY[YY].MM.DD
-  MYSQL_TIMESTAMP_DATETIME: [-]YY[YY].MM.DD hh:mm:ss.mmmmmm
-  MYSQL_TIMESTAMP_TIME: [-]hh:mm:ss.mmmmmm
-  */
-  if (strchr(Start, '-'))
-  {
-    if (sscanf(Start, "%d-%u-%u", &Tm->year, &Tm->month, &Tm->day) < 3)
-    {
-      return MADB_SetError(Error, MADB_ERR_22008, NULL, 0);
-    }
-    isDate= 1;
-    if (!(Start= strchr(Start, ' ')))
-    {
-      goto check;
-    }
+    return MADB_SetError(Error, MADB_ERR_22008, NULL, 0);
   }
-  if (!strchr(Start, ':'))
-  {
-    goto check;
-  }
-
-  if (isDate == 0)
-  {
-    *isTime= 1;
-  }
-
-  if ((Frac= strchr(Start, '.')) != NULL) /* fractional seconds */
-  {
-    size_t FracMulIdx= End - (Frac + 1) - 1/*to get index array index */;
-    /* ODBC - nano-seconds */
-    if (sscanf(Start, "%d:%u:%u.%6lu", &Tm->hour, &Tm->minute,
-      &Tm->second, &Tm->second_part) < 4)
-    {
-      return MADB_SetError(Error, MADB_ERR_22008, NULL, 0);
-    }
-    /* 9 digits up to nano-seconds, and -1 since comparing with arr idx  */
-    if (FracMulIdx < 6 - 1)
-    {
-      static unsigned long Mul[]= {100000, 10000, 1000, 100, 10};
-      Tm->second_part*= Mul[FracMulIdx];
-    }
-  }
-  else
-  {
-    if (sscanf(Start, "%d:%u:%u", &Tm->hour, &Tm->minute,
-      &Tm->second) < 3)
-    {
-      return MADB_SetError(Error, MADB_ERR_22008, NULL, 0);
-    }
-  }
-
-check:
-  if (Interval == FALSE)
-  {
-    if (isDate)
-    {
-      if (Tm->year > 0)
-      {
-        if (Tm->year < 70)
-        {
-          Tm->year+= 2000;
-        }
-        else if (Tm->year < 100)
-        {
-          Tm->year+= 1900;
-        }
-      }
-    }
-  }
- 
   return SQL_SUCCESS;
 }
+/* }}} */
 
 /* {{{ MADB_ConversionSupported */
 BOOL MADB_ConversionSupported(MADB_DescRecord *From, MADB_DescRecord *To)
@@ -162,82 +77,347 @@ char MADB_ConvertCharToBit(MADB_Stmt *Stmt, char *src)
 }
 /* }}} */
 
-/* {{{ MADB_ConvertNumericToChar */
-size_t MADB_ConvertNumericToChar(SQL_NUMERIC_STRUCT *Numeric, char *Buffer, int *ErrorCode)
+/* 128-bit unsigned integer arithmetic for SQL_NUMERIC_STRUCT conversions. Compiler's 128-bit type is used where it
+   exists, elsewhere the number is kept in four 32-bit limbs. Multipliers and divisors do not exceed 10^9 */
+#if defined(__SIZEOF_INT128__)
+typedef unsigned __int128 MADB_Uint128;
+
+#define MADB_U128_ISZERO(A)  ((A) == 0)
+#define MADB_U128_FITS64(A)  (((A) >> 64) == 0)
+#define MADB_U128_LOW64(A)   ((unsigned long long)(A))
+
+static void MADB_U128MulAdd(MADB_Uint128 *A, unsigned int Mul, unsigned int Add)
+{
+  *A= *A * Mul + Add;
+}
+
+static unsigned int MADB_U128DivMod(MADB_Uint128 *A, unsigned int Div)
+{
+  unsigned int Rest= (unsigned int)(*A % Div);
+
+  *A/= Div;
+  return Rest;
+}
+
+static void MADB_U128FromBytes(MADB_Uint128 *A, const SQLCHAR *Bytes)
 {
-  long long Numerator= 0;
-  long long Denominator= 1;
-  unsigned long long Left= 0, Right= 0;
-  int Scale= 0;
-  int ppos= 0;
-  long ByteDenominator= 1;
   int i;
-  char *p;
-  my_bool hasDot= FALSE;
 
-  Buffer[0]= 0;
-  *ErrorCode= 0;
+  *A= 0;
+  for (i= SQL_MAX_NUMERIC_LEN - 1; i >= 0; --i)
+  {
+    *A= (*A << 8) | Bytes[i];
+  }
+}
 
-  Scale+= (Numeric->scale < 0) ? -Numeric->scale : Numeric->scale;
+static void MADB_U128ToBytes(MADB_Uint128 A, SQLCHAR *Bytes)
+{
+  int i;
 
-  for (i=0; i < SQL_MAX_NUMERIC_LEN; ++i)
+  for (i= 0; i < SQL_MAX_NUMERIC_LEN; ++i, A>>= 8)
   {
-    Numerator+= Numeric->val[i] * ByteDenominator;
-    ByteDenominator<<= 8;
+    Bytes[i]= (SQLCHAR)A;
   }
-  if (!Numeric->sign)
-    Numerator= -Numerator;
-  Denominator= (long long)pow(10, Scale);
-  Left= Numerator / Denominator;
-  //_i64toa_s(Numerator, Buffer, 38, 10);
-  if (Numeric->scale > 0)
+}
+#else
+typedef struct
+{
+  unsigned int Limb[4]; /* Least significant first */
+} MADB_Uint128;
+
+#define MADB_U128_ISZERO(A)  (((A).Limb[0] | (A).Limb[1] | (A).Limb[2] | (A).Limb[3]) == 0)
+#define MADB_U128_FITS64(A)  (((A).Limb[2] | (A).Limb[3]) == 0)
+#define MADB_U128_LOW64(A)   ((unsigned long long)(A).Limb[1] << 32 | (A).Limb[0])
+
+static void MADB_U128MulAdd(MADB_Uint128 *A, unsigned int Mul, unsigned int Add)
+{
+  unsigned long long Carry= Add;
+  int i;
+
+  for (i= 0; i < 4; ++i)
   {
-    char tmp[38];
-    _snprintf(tmp, 38, "%%.%df", Numeric->scale);
-    _snprintf(Buffer, 38, tmp, Numerator / pow(10, Scale));
+    Carry+= (unsigned long long)A->Limb[i] * Mul;
+    A->Limb[i]= (unsigned int)Carry;
+    Carry>>= 32;
   }
-  else
+}
+
+static unsigned int MADB_U128DivMod(MADB_Uint128 *A, unsigned int Div)
+{
+  unsigned long long Rest= 0;
+  int i;
+
+  for (i= 3; i >= 0; --i)
+  {
+    Rest= Rest << 32 | A->Limb[i];
+    A->Limb[i]= (unsigned int)(Rest / Div);
+    Rest%= Div;
+  }
+  return (unsigned int)Rest;
+}
+
+static void MADB_U128FromBytes(MADB_Uint128 *A, const SQLCHAR *Bytes)
+{
+  int i;
+
+  for (i= 0; i < 4; ++i)
+  {
+    A->Limb[i]= (unsigned int)Bytes[4*i] | (unsigned int)Bytes[4*i + 1] << 8 | (unsigned int)Bytes[4*i + 2] << 16
+              | (unsigned int)Bytes[4*i + 3] << 24;
+  }
+}
+
+static void MADB_U128ToBytes(MADB_Uint128 A, SQLCHAR *Bytes)
+{
+  int i;
+
+  for (i= 0; i < SQL_MAX_NUMERIC_LEN; ++i)
   {
-    _snprintf(Buffer, 38, "%lld", Numerator);
-    while (strlen(Buffer) < (size_t)(Numeric->precision - Numeric->scale))
-      strcat(Buffer, "0");
+    Bytes[i]= (SQLCHAR)(A.Limb[i / 4] >> (8 * (i % 4)));
   }
+}
+#endif
+
+static const unsigned int MADB_Pow10[]= {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+/* {{{ MADB_U128MulPow10 - multiplies by 10^Exp */
+static void MADB_U128MulPow10(MADB_Uint128 *A, unsigned int Exp)
+{
+  while (Exp > 0)
+  {
+    unsigned int Step= MIN(Exp, 9);
 
+    MADB_U128MulAdd(A, MADB_Pow10[Step], 0);
+    Exp-= Step;
+  }
+}
+/* }}} */
 
-  if (Buffer[0] == '-')
-    Buffer++;
+/* {{{ MADB_U128ToDigits - writes decimal digits of the number to the end of the buffer, and returns pointer to the first
+       digit. Buffer has to have room for 39 digits */
+static char *MADB_U128ToDigits(MADB_Uint128 A, char *BufferEnd)
+{
+  char *Digit= BufferEnd;
 
-  /* Truncation checks:
-  1st ensure, that the digits before decimal point will fit */
-  if ((p= strchr(Buffer, '.')))
+  /* The number is cut into 9 digits pieces, until it fits 64 bits */
+  while (!MADB_U128_FITS64(A))
   {
-    if (p - Buffer - 1 > Numeric->precision)
+    unsigned int Piece= MADB_U128DivMod(&A, MADB_Pow10[9]), i;
+
+    for (i= 0; i < 9; ++i, Piece/= 10)
     {
-      *ErrorCode= MADB_ERR_22003;
-      Buffer[Numeric->precision]= 0;
-      goto end;
+      *--Digit= '0' + Piece % 10;
     }
-    if (Numeric->scale > 0 && Left > 0 && (p - Buffer) + strlen(p) > Numeric->precision)
+  }
+  {
+    unsigned long long Rest= MADB_U128_LOW64(A);
+
+    do
     {
-      *ErrorCode= MADB_ERR_01S07;
-      Buffer[Numeric->precision + 1]= 0;
-      goto end;
+      *--Digit= '0' + (char)(Rest % 10);
+      Rest/= 10;
+    } while (Rest != 0);
+  }
+  return Digit;
+}
+/* }}} */
+
+/* {{{ MADB_StrToNumeric - parses decimal string into SQL_NUMERIC_STRUCT, which precision and scale are set by the caller.
+       The value is accumulated into 128-bit integer in one pass. Fractional digits beyond the scale are truncated, with
+       negative scale the value has to be multiple of 10^-scale. Returns MADB_ERR_22003 if value does not fit the precision */
+int MADB_StrToNumeric(const char *Str, SQL_NUMERIC_STRUCT *Numeric)
+{
+  MADB_Uint128 Value;
+  unsigned int Chunk= 0, ChunkDigits= 0, Significant= 0;
+  int          Scale= (SQLSCHAR)Numeric->scale, FracDigits= 0;
+  unsigned int Precision= Numeric->precision != 0 ? MIN(Numeric->precision, MADB_DEFAULT_PRECISION)
+                                                 : MADB_DEFAULT_PRECISION;
+
+  memset(&Value, 0, sizeof(Value));
+  Numeric->sign= 1;
+  memset(Numeric->val, 0, sizeof(Numeric->val));
+
+  while (isspace(0x000000ff & *Str))
+  {
+    ++Str;
+  }
+  if (*Str == '-' || *Str == '+')
+  {
+    Numeric->sign= *Str++ == '+';
+  }
+  /* Leading zeros are not significant */
+  while (*Str == '0')
+  {
+    ++Str;
+  }
+
+  for (;;)
+  {
+    if (*Str >= '0' && *Str <= '9')
+    {
+      /* Digits beyond the scale are truncated */
+      if (FracDigits > 0 && FracDigits > Scale)
+      {
+        break;
+      }
+      if (Significant > 0 || *Str != '0')
+      {
+        if (++Significant > MADB_DEFAULT_PRECISION)
+        {
+          return MADB_ERR_22003;
+        }
+      }
+      Chunk= Chunk * 10 + (*Str - '0');
+      if (++ChunkDigits == 9)
+      {
+        MADB_U128MulAdd(&Value, MADB_Pow10[9], Chunk);
+        Chunk= ChunkDigits= 0;
+      }
+      if (FracDigits > 0)
+      {
+        ++FracDigits;
+      }
+    }
+    else if (*Str == '.' && FracDigits == 0 && Scale > 0)
+    {
+      /* FracDigits is one more than the number of digits read after the point */
+      FracDigits= 1;
+    }
+    else
+    {
+      break;
+    }
+    ++Str;
+  }
+  MADB_U128MulAdd(&Value, MADB_Pow10[ChunkDigits], Chunk);
+
+  if (FracDigits > 0)
+  {
+    Scale-= FracDigits - 1;
+  }
+
+  if (Scale > 0)
+  {
+    /* Padding the fraction up to the scale */
+    if (Significant > 0)
+    {
+      if ((Significant+= Scale) > MADB_DEFAULT_PRECISION)
+      {
+        return MADB_ERR_22003;
+      }
+      MADB_U128MulPow10(&Value, Scale);
+    }
+  }
+  else if (Scale < 0 && Significant > 0)
+  {
+    /* Value is stored divided by 10^-scale, and that must not lose digits */
+    unsigned int Exp= -Scale;
+
+    if (Exp >= Significant)
+    {
+      return MADB_ERR_22003;
+    }
+    Significant-= Exp;
+    while (Exp > 0)
+    {
+      unsigned int Step= MIN(Exp, 9);
+
+      if (MADB_U128DivMod(&Value, MADB_Pow10[Step]) != 0)
+      {
+        return MADB_ERR_22003;
+      }
+      Exp-= Step;
+    }
+  }
+
+  if (Significant > Precision)
+  {
+    return MADB_ERR_22003;
+  }
+  MADB_U128ToBytes(Value, Numeric->val);
+
+  return 0;
+}
+/* }}} */
+
+/* {{{ MADB_ConvertNumericToChar - formats SQL_NUMERIC_STRUCT as decimal string with scale digits after the point.
+       MADB_ERR_22003 is returned via ErrorCode if the integral part has more digits than precision permits, and
+       MADB_ERR_01S07 if fractional digits had to be truncated to fit the precision */
+size_t MADB_ConvertNumericToChar(SQL_NUMERIC_STRUCT *Numeric, char *Buffer, int *ErrorCode)
+{
+  MADB_Uint128 Value;
+  char         Digits[MADB_DEFAULT_PRECISION + 1], *Digit, *End= Digits + sizeof(Digits), *Start= Buffer;
+  int          Scale= (SQLSCHAR)Numeric->scale, Precision= Numeric->precision, DigitsCount, IntDigits;
+
+  *ErrorCode= 0;
+  Buffer[0]= '\0';
+  if (Precision == 0 || Precision > MADB_DEFAULT_PRECISION)
+  {
+    Precision= MADB_DEFAULT_PRECISION;
+  }
+
+  MADB_U128FromBytes(&Value, Numeric->val);
+  Digit=       MADB_U128ToDigits(Value, End);
+  DigitsCount= (int)(End - Digit);
+  IntDigits=   DigitsCount - Scale;
+
+  if (IntDigits > Precision && !MADB_U128_ISZERO(Value))
+  {
+    *ErrorCode= MADB_ERR_22003;
+    return 0;
+  }
+
+  if (Numeric->sign == 0 && !MADB_U128_ISZERO(Value))
+  {
+    *Buffer++= '-';
+  }
+
+  if (Scale <= 0)
+  {
+    memcpy(Buffer, Digit, DigitsCount);
+    Buffer+= DigitsCount;
+    if (!MADB_U128_ISZERO(Value))
+    {
+      memset(Buffer, '0', -Scale);
+      Buffer+= -Scale;
     }
   }
-  while (Numeric->scale < 0 && strlen(Buffer) < (size_t)(Numeric->precision - Numeric->scale))
-    strcat(Buffer, "0");
+  else
+  {
+    int FracDigits= Scale;
 
+    if (IntDigits > 0)
+    {
+      memcpy(Buffer, Digit, IntDigits);
+      Buffer+= IntDigits;
+      Digit+=  IntDigits;
+    }
+    else
+    {
+      *Buffer++= '0';
+    }
+
+    if (MAX(IntDigits, 0) + FracDigits > Precision)
+    {
+      *ErrorCode= MADB_ERR_01S07;
+      FracDigits= Precision - MAX(IntDigits, 0);
+    }
 
-  if (strlen(Buffer) > (size_t)(Numeric->precision + Scale) && Numeric->scale > 0)
-    *ErrorCode= MADB_ERR_01S07;
+    if (FracDigits > 0)
+    {
+      /* Leading zeros of the fraction, that the number does not have among its digits */
+      int Zeros= MIN(MAX(-IntDigits, 0), FracDigits);
+
+      *Buffer++= '.';
+      memset(Buffer, '0', Zeros);
+      Buffer+= Zeros;
+      memcpy(Buffer, Digit, FracDigits - Zeros);
+      Buffer+= FracDigits - Zeros;
+    }
+  }
+  *Buffer= '\0';
 
-end:
-  /* check if last char is decimal point */
-  if (strlen(Buffer) && Buffer[strlen(Buffer)-1] == '.')
-    Buffer[strlen(Buffer)-1] = 0;
-  if (!Numeric->sign)
-    Buffer--;
-  return strlen(Buffer);
+  return Buffer - Start;
 }
 /* }}} */
 
@@ -26,6 +26,7 @@
 #define MADB_CHARSIZE_FOR_NUMERIC 80
 BOOL      MADB_ConversionSupported(MADB_DescRecord *From, MADB_DescRecord *To);
 size_t    MADB_ConvertNumericToChar(SQL_NUMERIC_STRUCT *Numeric, char *Buffer, int *ErrorCode);
+int       MADB_StrToNumeric(const char *Str, SQL_NUMERIC_STRUCT *Numeric);
 SQLLEN    MADB_CalculateLength(MADB_Stmt *Stmt, SQLLEN *OctetLengthPtr, MADB_DescRecord *CRec, void* DataPtr);
 SQLRETURN MADB_C2SQL(MADB_Stmt* Stmt, MADB_DescRecord *CRec, MADB_DescRecord *SqlRec, SQLULEN ParamSetIdx, MYSQL_BIND *bind);
 
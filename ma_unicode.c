@@ -0,0 +1,580 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+#include <ma_odbc.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define MADB_HAVE_SSE2 1
+# include <emmintrin.h>
+#endif
+/* AVX2 kernel is compiled for the target regardless of compiler flags, and is only used if CPU supports it */
+#if defined(MADB_HAVE_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define MADB_HAVE_AVX2 1
+# include <immintrin.h>
+#endif
+
+typedef size_t (*MADB_AsciiToWcharFunc)(const unsigned char *Src, size_t Length, SQLWCHAR *Dest);
+typedef size_t (*MADB_WcharToAsciiFunc)(const SQLWCHAR *Src, size_t Length, unsigned char *Dest);
+typedef size_t (*MADB_Utf8CharLenFunc)(const char *Str, size_t Length);
+typedef SQLLEN (*MADB_WcsLenFunc)(const SQLWCHAR *Str, SQLLEN Limit);
+
+static size_t MADB_AsciiToWcharResolve(const unsigned char *Src, size_t Length, SQLWCHAR *Dest);
+static size_t MADB_WcharToAsciiResolve(const SQLWCHAR *Src, size_t Length, unsigned char *Dest);
+static size_t MADB_Utf8CharLenResolve(const char *Str, size_t Length);
+static SQLLEN MADB_WcsLenResolve(const SQLWCHAR *Str, SQLLEN Limit);
+
+/* Kernels are chosen on their first call */
+static MADB_AsciiToWcharFunc MADB_AsciiToWchar=   MADB_AsciiToWcharResolve;
+static MADB_WcharToAsciiFunc MADB_WcharToAscii=   MADB_WcharToAsciiResolve;
+static MADB_Utf8CharLenFunc  MADB_Utf8CharLenPtr= MADB_Utf8CharLenResolve;
+static MADB_WcsLenFunc       MADB_WcsLenPtr=      MADB_WcsLenResolve;
+
+
+/* {{{ MADB_BitCount */
+static unsigned int MADB_BitCount(unsigned int x)
+{
+  x= x - ((x >> 1) & 0x55555555);
+  x= (x & 0x33333333) + ((x >> 2) & 0x33333333);
+  return (((x + (x >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+/* }}} */
+
+/* {{{ MADB_LowestBit - number of the lowest set bit of not 0 value */
+static unsigned int MADB_LowestBit(unsigned int x)
+{
+  return MADB_BitCount((x & (0 - x)) - 1);
+}
+/* }}} */
+
+
+/* {{{ MADB_AsciiToWcharScalar - converts leading ASCII characters of the string
+       @returns number of converted characters. Conversion stops at first not ASCII character */
+static size_t MADB_AsciiToWcharScalar(const unsigned char *Src, size_t Length, SQLWCHAR *Dest)
+{
+  size_t i= 0;
+
+  while (i < Length && Src[i] < 0x80)
+  {
+    Dest[i]= (SQLWCHAR)Src[i];
+    ++i;
+  }
+  return i;
+}
+/* }}} */
+
+/* {{{ MADB_WcharToAsciiScalar - converts leading SQLWCHAR units, that are ASCII characters
+       @returns number of converted units */
+static size_t MADB_WcharToAsciiScalar(const SQLWCHAR *Src, size_t Length, unsigned char *Dest)
+{
+  size_t i= 0;
+
+  while (i < Length && (unsigned int)Src[i] < 0x80)
+  {
+    Dest[i]= (unsigned char)Src[i];
+    ++i;
+  }
+  return i;
+}
+/* }}} */
+
+/* {{{ MADB_Utf8CharLenScalar - number of characters in first Length bytes of utf8 string, or before terminating null */
+static size_t MADB_Utf8CharLenScalar(const char *Str, size_t Length)
+{
+  size_t i, Count= 0;
+
+  for (i= 0; i < Length && Str[i] != '\0'; ++i)
+  {
+    /* Counting all bytes but continuation ones */
+    Count+= (Str[i] & 0xC0) != 0x80;
+  }
+  return Count;
+}
+/* }}} */
+
+/* {{{ MADB_WcsLenScalar - length of SQLWCHAR string in units. Limit is the size of the buffer, or negative if not known */
+static SQLLEN MADB_WcsLenScalar(const SQLWCHAR *Str, SQLLEN Limit)
+{
+  SQLLEN i;
+
+  for (i= 0; (Limit < 0 || i < Limit) && Str[i] != 0; ++i);
+
+  return i;
+}
+/* }}} */
+
+#ifdef MADB_HAVE_SSE2
+/* {{{ MADB_Utf8CharLenSse2 */
+static size_t MADB_Utf8CharLenSse2(const char *Str, size_t Length)
+{
+  const __m128i Zero= _mm_setzero_si128(), LastContinuation= _mm_set1_epi8(-65 /* 0xBF */);
+  size_t        i= 0, Count= 0;
+
+  for (; i + 16 <= Length; i+= 16)
+  {
+    __m128i Chunk= _mm_loadu_si128((const __m128i *)(Str + i));
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(Chunk, Zero)) != 0)
+    {
+      break;
+    }
+    /* All ASCII - every byte is a character */
+    if (_mm_movemask_epi8(Chunk) == 0)
+    {
+      Count+= 16;
+    }
+    else
+    {
+      /* As signed, continuation bytes are in [-128, -65] range */
+      Count+= MADB_BitCount(_mm_movemask_epi8(_mm_cmpgt_epi8(Chunk, LastContinuation)));
+    }
+  }
+
+  return Count + MADB_Utf8CharLenScalar(Str + i, Length - i);
+}
+/* }}} */
+
+/* {{{ MADB_WcsLenSse2 */
+static SQLLEN MADB_WcsLenSse2(const SQLWCHAR *Str, SQLLEN Limit)
+{
+  const __m128i   Zero= _mm_setzero_si128();
+  const SQLWCHAR *p= Str;
+  const SQLLEN    BlockUnits= 16 / sizeof(SQLWCHAR);
+  unsigned int    Mask;
+
+  if ((size_t)Str % sizeof(SQLWCHAR) != 0)
+  {
+    return MADB_WcsLenScalar(Str, Limit);
+  }
+  /* Going to 16 bytes boundary. Aligned load never crosses page boundary, and it's safe to read past the terminating null */
+  while (((size_t)p & 15) != 0)
+  {
+    if ((Limit >= 0 && p - Str >= Limit) || *p == 0)
+    {
+      return p - Str;
+    }
+    ++p;
+  }
+
+  while (Limit < 0 || (p - Str) + BlockUnits <= Limit)
+  {
+    __m128i Chunk= _mm_load_si128((const __m128i *)p);
+
+    Mask= _mm_movemask_epi8(sizeof(SQLWCHAR) == 2 ? _mm_cmpeq_epi16(Chunk, Zero) : _mm_cmpeq_epi32(Chunk, Zero));
+    if (Mask != 0)
+    {
+      return (p - Str) + MADB_LowestBit(Mask) / sizeof(SQLWCHAR);
+    }
+    p+= BlockUnits;
+  }
+
+  return (p - Str) + MADB_WcsLenScalar(p, Limit - (p - Str));
+}
+/* }}} */
+
+/* {{{ MADB_AsciiToWcharSse2 */
+static size_t MADB_AsciiToWcharSse2(const unsigned char *Src, size_t Length, SQLWCHAR *Dest)
+{
+  const __m128i Zero= _mm_setzero_si128();
+  size_t        i= 0;
+
+  for (; i + 16 <= Length; i+= 16)
+  {
+    __m128i Chunk= _mm_loadu_si128((const __m128i *)(Src + i));
+
+    if (_mm_movemask_epi8(Chunk) != 0)
+    {
+      break;
+    }
+    if (sizeof(SQLWCHAR) == 2)
+    {
+      _mm_storeu_si128((__m128i *)(Dest + i),     _mm_unpacklo_epi8(Chunk, Zero));
+      _mm_storeu_si128((__m128i *)(Dest + i + 8), _mm_unpackhi_epi8(Chunk, Zero));
+    }
+    else
+    {
+      __m128i Lo= _mm_unpacklo_epi8(Chunk, Zero), Hi= _mm_unpackhi_epi8(Chunk, Zero);
+
+      _mm_storeu_si128((__m128i *)(Dest + i),      _mm_unpacklo_epi16(Lo, Zero));
+      _mm_storeu_si128((__m128i *)(Dest + i + 4),  _mm_unpackhi_epi16(Lo, Zero));
+      _mm_storeu_si128((__m128i *)(Dest + i + 8),  _mm_unpacklo_epi16(Hi, Zero));
+      _mm_storeu_si128((__m128i *)(Dest + i + 12), _mm_unpackhi_epi16(Hi, Zero));
+    }
+  }
+
+  return i + MADB_AsciiToWcharScalar(Src + i, Length - i, Dest + i);
+}
+/* }}} */
+
+/* {{{ MADB_WcharToAsciiSse2 */
+static size_t MADB_WcharToAsciiSse2(const SQLWCHAR *Src, size_t Length, unsigned char *Dest)
+{
+  const __m128i Zero= _mm_setzero_si128();
+  size_t        i= 0;
+
+  for (; i + 16 <= Length; i+= 16)
+  {
+    if (sizeof(SQLWCHAR) == 2)
+    {
+      __m128i A= _mm_loadu_si128((const __m128i *)(Src + i)),
+              B= _mm_loadu_si128((const __m128i *)(Src + i + 8));
+
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(A, B), _mm_set1_epi16((short)0xFF80)), Zero)) != 0xFFFF)
+      {
+        break;
+      }
+      _mm_storeu_si128((__m128i *)(Dest + i), _mm_packus_epi16(A, B));
+    }
+    else
+    {
+      __m128i A= _mm_loadu_si128((const __m128i *)(Src + i)),
+              B= _mm_loadu_si128((const __m128i *)(Src + i + 4)),
+              C= _mm_loadu_si128((const __m128i *)(Src + i + 8)),
+              D= _mm_loadu_si128((const __m128i *)(Src + i + 12)),
+              Any= _mm_or_si128(_mm_or_si128(A, B), _mm_or_si128(C, D));
+
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(Any, _mm_set1_epi32((int)0xFFFFFF80)), Zero)) != 0xFFFF)
+      {
+        break;
+      }
+      /* All values are below 0x80, thus signed saturation is exact */
+      _mm_storeu_si128((__m128i *)(Dest + i), _mm_packus_epi16(_mm_packs_epi32(A, B), _mm_packs_epi32(C, D)));
+    }
+  }
+
+  return i + MADB_WcharToAsciiScalar(Src + i, Length - i, Dest + i);
+}
+/* }}} */
+#endif
+
+#ifdef MADB_HAVE_AVX2
+/* {{{ MADB_Utf8CharLenAvx2 */
+__attribute__((target("avx2")))
+static size_t MADB_Utf8CharLenAvx2(const char *Str, size_t Length)
+{
+  const __m256i Zero= _mm256_setzero_si256(), LastContinuation= _mm256_set1_epi8(-65);
+  size_t        i= 0, Count= 0;
+
+  for (; i + 32 <= Length; i+= 32)
+  {
+    __m256i Chunk= _mm256_loadu_si256((const __m256i *)(Str + i));
+
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(Chunk, Zero)) != 0)
+    {
+      break;
+    }
+    if (_mm256_movemask_epi8(Chunk) == 0)
+    {
+      Count+= 32;
+    }
+    else
+    {
+      Count+= MADB_BitCount((unsigned int)_mm256_movemask_epi8(_mm256_cmpgt_epi8(Chunk, LastContinuation)));
+    }
+  }
+
+  /* Avoiding penalty of switching to legacy SSE code with dirty upper halves of registers */
+  _mm256_zeroupper();
+  return Count + MADB_Utf8CharLenSse2(Str + i, Length - i);
+}
+/* }}} */
+
+/* {{{ MADB_AsciiToWcharAvx2 */
+__attribute__((target("avx2")))
+static size_t MADB_AsciiToWcharAvx2(const unsigned char *Src, size_t Length, SQLWCHAR *Dest)
+{
+  size_t i= 0;
+
+  for (; i + 32 <= Length; i+= 32)
+  {
+    __m256i Chunk= _mm256_loadu_si256((const __m256i *)(Src + i));
+
+    if (_mm256_movemask_epi8(Chunk) != 0)
+    {
+      break;
+    }
+    if (sizeof(SQLWCHAR) == 2)
+    {
+      _mm256_storeu_si256((__m256i *)(Dest + i),      _mm256_cvtepu8_epi16(_mm256_castsi256_si128(Chunk)));
+      _mm256_storeu_si256((__m256i *)(Dest + i + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(Chunk, 1)));
+    }
+    else
+    {
+      _mm256_storeu_si256((__m256i *)(Dest + i),      _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(Src + i))));
+      _mm256_storeu_si256((__m256i *)(Dest + i + 8),  _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(Src + i + 8))));
+      _mm256_storeu_si256((__m256i *)(Dest + i + 16), _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(Src + i + 16))));
+      _mm256_storeu_si256((__m256i *)(Dest + i + 24), _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(Src + i + 24))));
+    }
+  }
+
+  _mm256_zeroupper();
+  return i + MADB_AsciiToWcharSse2(Src + i, Length - i, Dest + i);
+}
+/* }}} */
+#endif
+
+/* {{{ MADB_AsciiToWcharResolve */
+static size_t MADB_AsciiToWcharResolve(const unsigned char *Src, size_t Length, SQLWCHAR *Dest)
+{
+#if defined(MADB_HAVE_AVX2)
+  __builtin_cpu_init();
+  MADB_AsciiToWchar= __builtin_cpu_supports("avx2") ? MADB_AsciiToWcharAvx2 : MADB_AsciiToWcharSse2;
+#elif defined(MADB_HAVE_SSE2)
+  MADB_AsciiToWchar= MADB_AsciiToWcharSse2;
+#else
+  MADB_AsciiToWchar= MADB_AsciiToWcharScalar;
+#endif
+  return MADB_AsciiToWchar(Src, Length, Dest);
+}
+/* }}} */
+
+/* {{{ MADB_WcharToAsciiResolve */
+static size_t MADB_WcharToAsciiResolve(const SQLWCHAR *Src, size_t Length, unsigned char *Dest)
+{
+#if defined(MADB_HAVE_SSE2)
+  MADB_WcharToAscii= MADB_WcharToAsciiSse2;
+#else
+  MADB_WcharToAscii= MADB_WcharToAsciiScalar;
+#endif
+  return MADB_WcharToAscii(Src, Length, Dest);
+}
+/* }}} */
+
+
+/* {{{ MADB_Utf8CharLenResolve */
+static size_t MADB_Utf8CharLenResolve(const char *Str, size_t Length)
+{
+#if defined(MADB_HAVE_AVX2)
+  __builtin_cpu_init();
+  MADB_Utf8CharLenPtr= __builtin_cpu_supports("avx2") ? MADB_Utf8CharLenAvx2 : MADB_Utf8CharLenSse2;
+#elif defined(MADB_HAVE_SSE2)
+  MADB_Utf8CharLenPtr= MADB_Utf8CharLenSse2;
+#else
+  MADB_Utf8CharLenPtr= MADB_Utf8CharLenScalar;
+#endif
+  return MADB_Utf8CharLenPtr(Str, Length);
+}
+/* }}} */
+
+/* {{{ MADB_WcsLenResolve */
+static SQLLEN MADB_WcsLenResolve(const SQLWCHAR *Str, SQLLEN Limit)
+{
+#if defined(MADB_HAVE_SSE2)
+  MADB_WcsLenPtr= MADB_WcsLenSse2;
+#else
+  MADB_WcsLenPtr= MADB_WcsLenScalar;
+#endif
+  return MADB_WcsLenPtr(Str, Limit);
+}
+/* }}} */
+
+
+/* {{{ MADB_Utf8CharLen - number of characters in first Length bytes of utf8 string, or before its terminating null.
+       Incomplete character at the end is counted, stray continuation bytes are not */
+size_t MADB_Utf8CharLen(const char *Str, size_t Length)
+{
+  return MADB_Utf8CharLenPtr(Str, Length);
+}
+/* }}} */
+
+
+/* {{{ MADB_WcsLen - length of SQLWCHAR string in units
+       @Limit[in] - size of the buffer in units, or negative number if the string is null terminated */
+SQLLEN MADB_WcsLen(const SQLWCHAR *Str, SQLLEN Limit)
+{
+  return MADB_WcsLenPtr(Str, Limit);
+}
+/* }}} */
+
+
+/* {{{ MADB_Utf8Decode - decodes one not-ASCII utf8 character, and moves the pointer past it.
+       Invalid or incomplete sequence is decoded as U+FFFD, and only its first byte is skipped */
+static unsigned int MADB_Utf8Decode(const unsigned char **Ptr, const unsigned char *End)
+{
+  const unsigned char *p= *Ptr;
+  unsigned int         Cp, Min, Bytes, i;
+
+  if (*p >= 0xC2 && *p <= 0xDF)
+  {
+    Cp= *p & 0x1F; Bytes= 2; Min= 0x80;
+  }
+  else if ((*p & 0xF0) == 0xE0)
+  {
+    Cp= *p & 0x0F; Bytes= 3; Min= 0x800;
+  }
+  else if (*p >= 0xF0 && *p <= 0xF4)
+  {
+    Cp= *p & 0x07; Bytes= 4; Min= 0x10000;
+  }
+  else
+  {
+    ++*Ptr;
+    return 0xFFFD;
+  }
+
+  if (p + Bytes > End)
+  {
+    ++*Ptr;
+    return 0xFFFD;
+  }
+
+  for (i= 1; i < Bytes; ++i)
+  {
+    if ((p[i] & 0xC0) != 0x80)
+    {
+      ++*Ptr;
+      return 0xFFFD;
+    }
+    Cp= (Cp << 6) | (p[i] & 0x3F);
+  }
+  /* Overlong forms, surrogates and values beyond unicode range */
+  if (Cp < Min || (Cp >= 0xD800 && Cp <= 0xDFFF) || Cp > 0x10FFFF)
+  {
+    ++*Ptr;
+    return 0xFFFD;
+  }
+
+  *Ptr+= Bytes;
+  return Cp;
+}
+/* }}} */
+
+
+/* {{{ MADB_Utf8ToWchar - converts utf8 string to SQLWCHAR string
+       @DestLength[in]    - size of the Dest buffer in SQLWCHAR units
+       @NullTerminate[in] - whether to reserve a unit of the buffer for terminating null, and write it
+       @Truncated[out]    - whether whole string didn't fit the buffer. Surrogate pair is never split
+       @returns length of whole converted string in SQLWCHAR units, not counting terminating null */
+SQLLEN MADB_Utf8ToWchar(const char *Src, size_t SrcLength, SQLWCHAR *Dest, SQLLEN DestLength, BOOL NullTerminate,
+                        BOOL *Truncated)
+{
+  const unsigned char *p=    (const unsigned char *)Src, *End= p + SrcLength;
+  SQLLEN               Room= NullTerminate ? DestLength - 1 : DestLength, Written= 0, Length= 0;
+  unsigned int         Cp;
+
+  while (p < End)
+  {
+    if (*p < 0x80)
+    {
+      if (Length == Written && Written < Room)
+      {
+        size_t Ascii= MADB_AsciiToWchar(p, MIN((size_t)(End - p), (size_t)(Room - Written)), Dest + Written);
+
+        p+=       Ascii;
+        Written+= Ascii;
+        Length+=  Ascii;
+      }
+      else
+      {
+        ++p;
+        ++Length;
+      }
+      continue;
+    }
+
+    Cp= MADB_Utf8Decode(&p, End);
+
+    if (sizeof(SQLWCHAR) == 2 && Cp > 0xFFFF)
+    {
+      if (Length == Written && Written + 2 <= Room)
+      {
+        Cp-= 0x10000;
+        Dest[Written++]= (SQLWCHAR)(0xD800 | (Cp >> 10));
+        Dest[Written++]= (SQLWCHAR)(0xDC00 | (Cp & 0x3FF));
+      }
+      Length+= 2;
+    }
+    else
+    {
+      if (Length == Written && Written < Room)
+      {
+        Dest[Written++]= (SQLWCHAR)Cp;
+      }
+      ++Length;
+    }
+  }
+
+  if (NullTerminate && DestLength > 0)
+  {
+    Dest[Written]= 0;
+  }
+  *Truncated= Length > Written;
+
+  return Length;
+}
+/* }}} */
+
+
+/* {{{ MADB_WcharToUtf8 - converts SQLWCHAR string of SrcLength units to utf8. Dest has to have space for
+       SrcLength*MADB_UTF8_PER_WCHAR bytes. Unpaired surrogates are converted to U+FFFD, and Error is set then
+       @returns number of written bytes */
+size_t MADB_WcharToUtf8(const SQLWCHAR *Src, size_t SrcLength, char *Dest, BOOL *Error)
+{
+  const SQLWCHAR *End= Src + SrcLength;
+  unsigned char  *p=   (unsigned char *)Dest;
+  unsigned int    Cp;
+
+  while (Src < End)
+  {
+    Cp= (unsigned int)*Src;
+    if (Cp < 0x80)
+    {
+      size_t Ascii= MADB_WcharToAscii(Src, End - Src, p);
+
+      Src+= Ascii;
+      p+=   Ascii;
+      continue;
+    }
+    ++Src;
+
+    if (Cp >= 0xD800 && Cp <= 0xDBFF && sizeof(SQLWCHAR) == 2 && Src < End &&
+        (unsigned int)*Src >= 0xDC00 && (unsigned int)*Src <= 0xDFFF)
+    {
+      Cp= 0x10000 + ((Cp - 0xD800) << 10) + ((unsigned int)*Src++ - 0xDC00);
+    }
+    else if ((Cp >= 0xD800 && Cp <= 0xDFFF) || Cp > 0x10FFFF)
+    {
+      Cp= 0xFFFD;
+      if (Error != NULL)
+      {
+        *Error= TRUE;
+      }
+    }
+
+    if (Cp < 0x800)
+    {
+      *p++= (unsigned char)(0xC0 | (Cp >> 6));
+    }
+    else
+    {
+      if (Cp < 0x10000)
+      {
+        *p++= (unsigned char)(0xE0 | (Cp >> 12));
+      }
+      else
+      {
+        *p++= (unsigned char)(0xF0 | (Cp >> 18));
+        *p++= (unsigned char)(0x80 | ((Cp >> 12) & 0x3F));
+      }
+      *p++= (unsigned char)(0x80 | ((Cp >> 6) & 0x3F));
+    }
+    *p++= (unsigned char)(0x80 | (Cp & 0x3F));
+  }
+
+  return (size_t)(p - (unsigned char *)Dest);
+}
+/* }}} */
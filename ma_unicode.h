@@ -0,0 +1,38 @@
+/************************************************************************************
+   Copyright (C) 2021 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+/* Conversions between utf8 and SQLWCHAR strings(utf16 or utf32, depending on the SQLWCHAR size), that do not go through
+ * generic charset conversion, and length scanning of such strings. Runs of ASCII characters are converted, and strings are
+ * scanned with SIMD kernels, chosen at runtime according to CPU capabilities */
+
+#ifndef _ma_unicode_h_
+#define _ma_unicode_h_
+
+/* Maximum number of utf8 bytes per SQLWCHAR unit */
+#define MADB_UTF8_PER_WCHAR (sizeof(SQLWCHAR) == 2 ? 3 : 4)
+
+#define MADB_IS_UTF8(aCs) (strncmp((aCs)->csname, "utf8", 4) == 0)
+
+SQLLEN MADB_Utf8ToWchar(const char *Src, size_t SrcLength, SQLWCHAR *Dest, SQLLEN DestLength, BOOL NullTerminate,
+                        BOOL *Truncated);
+size_t MADB_WcharToUtf8(const SQLWCHAR *Src, size_t SrcLength, char *Dest, BOOL *Error);
+size_t MADB_Utf8CharLen(const char *Str, size_t Length);
+SQLLEN MADB_WcsLen(const SQLWCHAR *Str, SQLLEN Limit);
+
+#endif
@@ -929,6 +929,9 @@ SQLRETURN SQL_API SQLDisconnect(SQLHDBC ConnectionHandle)
     MADB_DescFree((MADB_Desc*)Element->data, FALSE);
   }
 
+  /* Dropped statements may have left their handles in the cache */
+  MADB_PsCacheFree(Connection);
+
   if (Connection->mariadb)
   {
     mysql_close(Connection->mariadb);
@@ -1784,6 +1787,12 @@ SQLRETURN SQL_API SQLGetData(SQLHSTMT StatementHandle,
     return MADB_GetBookmark(Stmt, TargetType, TargetValuePtr, BufferLength, StrLen_or_IndPtr);
   }
 
+  /* If next rowset is being fetched in background, the worker is waited for, and C/C is pointed back to the current row */
+  if (!MADB_PrefetchRestoreRow(Stmt))
+  {
+    return MADB_SetError(&Stmt->Error, MADB_ERR_HY109, NULL, 0);
+  }
+
   /* We don't need this to be checked in case of "internal" use of the GetData, i.e. for internal needs we should always get the data */
   if ( Stmt->CharOffset[Col_or_Param_Num - 1] > 0
     && Stmt->CharOffset[Col_or_Param_Num - 1] >= Stmt->Lengths[Col_or_Param_Num - 1])
@@ -0,0 +1,139 @@
+/*
+  Copyright (C) 2018-2020. Huawei Technologies Co., Ltd. All rights reserved.
+  
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+  
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "tap.h"
+
+/* Arrow C Data and Stream Interfaces, as defined by the specification, the way applications get them */
+#include <stdint.h>
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+struct ArrowSchema
+{
+    const char *format;
+    const char *name;
+    const char *metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema **children;
+    struct ArrowSchema *dictionary;
+    void (*release)(struct ArrowSchema *);
+    void *private_data;
+};
+
+struct ArrowArray
+{
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void **buffers;
+    struct ArrowArray **children;
+    struct ArrowArray *dictionary;
+    void (*release)(struct ArrowArray *);
+    void *private_data;
+};
+#endif
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+struct ArrowArrayStream
+{
+    int (*get_schema)(struct ArrowArrayStream *, struct ArrowSchema *out);
+    int (*get_next)(struct ArrowArrayStream *, struct ArrowArray *out);
+    const char *(*get_last_error)(struct ArrowArrayStream *);
+    void (*release)(struct ArrowArrayStream *);
+    void *private_data;
+};
+#endif
+
+#define MADB_ATTR_ARROW_STREAM 0x4001
+
+ODBC_TEST(test_arrow_stream)
+{
+    struct ArrowArrayStream Stream;
+    struct ArrowSchema Schema;
+    struct ArrowArray Batch;
+    const int64_t *Offsets;
+    int64_t Total = 0;
+    int rc;
+
+    /* 2 rows per batch */
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)2, 0));
+    OK_SIMPLE_STMT(Stmt, "select 1 as id, 'a' as val union all select 2, 'bc' union all select 3, null order by id");
+
+    CHECK_STMT_RC(Stmt, SQLGetStmtAttr(Stmt, MADB_ATTR_ARROW_STREAM, &Stream, sizeof(Stream), NULL));
+
+    IS(Stream.get_schema(&Stream, &Schema) == 0);
+    is_num(Schema.n_children, 2);
+    IS_STR(Schema.format, "+s", 3);
+    IS_STR(Schema.children[0]->format, "i", 2);
+    IS_STR(Schema.children[0]->name, "id", 3);
+    Schema.release(&Schema);
+    IS(Schema.release == NULL);
+
+    while ((rc = Stream.get_next(&Stream, &Batch)) == 0 && Batch.release != NULL)
+    {
+        is_num(Batch.n_children, 2);
+        is_num(Batch.length, Total == 0 ? 2 : 1);
+        is_num(((const int32_t *)Batch.children[0]->buffers[1])[0], Total + 1);
+        is_num(Batch.children[1]->n_buffers, 3);
+        Offsets = (const int64_t *)Batch.children[1]->buffers[1];
+        if (Total == 0)
+        {
+            is_num(Offsets[1], 1);
+            is_num(Offsets[2], 3);
+            FAIL_IF(memcmp(Batch.children[1]->buffers[2], "abc", 3) != 0, "Wrong string values");
+        }
+        else
+        {
+            /* NULL value */
+            is_num(Batch.children[1]->null_count, 1);
+            is_num(((const unsigned char *)Batch.children[1]->buffers[0])[0] & 1, 0);
+        }
+
+        Total += Batch.length;
+        Batch.release(&Batch);
+    }
+    FAIL_IF(rc != 0, Stream.get_last_error(&Stream));
+    is_num(Total, 3);
+
+    /* After the end of the result stream only keeps returning the end */
+    IS(Stream.get_next(&Stream, &Batch) == 0 && Batch.release == NULL);
+    Stream.release(&Stream);
+
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, 0));
+
+    return OK;
+}
+
+MA_ODBC_TESTS my_tests[]=
+{
+    { test_arrow_stream, "test_arrow_stream" },
+    { NULL, NULL }
+};
+
+int main(int argc, char **argv)
+{
+  int tests= sizeof(my_tests)/sizeof(MA_ODBC_TESTS) - 1;
+  get_options(argc, argv);
+  plan(tests);
+  mark_all_tests_normal(my_tests);
+  return run_tests(my_tests);
+}
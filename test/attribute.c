@@ -1239,6 +1239,51 @@ ODBC_TEST(test_send_long_data)
                  param bind type/offset/operation pointer/status pointer/processed pointer/size
                  row array size/row bind offset/row status pointer/fetch pointer info
 */
+/* All unicode characters have to survive conversion to utf8 and back */
+ODBC_TEST(test_cursor_name_unicode)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    SQLWCHAR Name[1026], Back[1026];
+    SQLSMALLINT BackLen;
+    SQLINTEGER Units;
+    unsigned int Cp = 1;
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, TRUE, NULL, NULL, NULL, 0, NULL, NULL, NULL, "CHARSET=utf8mb4");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    while (Cp <= 0x10FFFF)
+    {
+        for (Units = 0; Units < 1024 && Cp <= 0x10FFFF; ++Cp)
+        {
+            if (Cp >= 0xD800 && Cp <= 0xDFFF)
+            {
+                continue;
+            }
+            if (sizeof(SQLWCHAR) == 2 && Cp > 0xFFFF)
+            {
+                Name[Units++] = (SQLWCHAR)(0xD800 | ((Cp - 0x10000) >> 10));
+                Name[Units++] = (SQLWCHAR)(0xDC00 | ((Cp - 0x10000) & 0x3FF));
+            }
+            else
+            {
+                Name[Units++] = (SQLWCHAR)Cp;
+            }
+        }
+        CHECK_STMT_RC(hstmt1, SQLSetCursorNameW(hstmt1, Name, (SQLSMALLINT)Units));
+        CHECK_STMT_RC(hstmt1, SQLGetCursorNameW(hstmt1, Back, sizeof(Back) / sizeof(SQLWCHAR), &BackLen));
+        is_num(BackLen, Units);
+        FAIL_IF(memcmp(Name, Back, Units * sizeof(SQLWCHAR)) != 0, "Cursor name changed in conversion");
+        is_num(Back[Units], 0);
+    }
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
 MA_ODBC_TESTS my_tests[]=
 {
     {test_attr_basic,               "test_attr_basic"},
@@ -1259,6 +1304,7 @@ MA_ODBC_TESTS my_tests[]=
     {test_com_close,                "test_com_close"},
     {test_statement_operate,        "test_statement_operate"},
     {test_send_long_data,           "test_send_long_data"},
+    {test_cursor_name_unicode,      "test_cursor_name_unicode"},
     {NULL, NULL}
 };
 
@@ -41,6 +41,21 @@ void cleanup(SQLHANDLE hstmt, char* tblname)
 SQLINTEGER ArrIds[PARAM_ARRAY_SIZE] = { 1,2,3,4,5,6,7,8,9,10 };
 SQLCHAR ArrVals[PARAM_ARRAY_SIZE][2] = { "a","b","c","d","e","f","g","h","i","j" };
 
+/* Fills test_tbl_blockcursor with ArrIds/ArrVals using one parameter array execution */
+static int insertdata(SQLHANDLE hstmt)
+{
+    CHECK_STMT_RC(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)PARAM_ARRAY_SIZE, 0));
+    CHECK_STMT_RC(hstmt, SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                        SQL_INTEGER, 0, 0, ArrIds, 0, NULL));
+    CHECK_STMT_RC(hstmt, SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR,
+                                        SQL_VARCHAR, sizeof(ArrVals[0]), 0, ArrVals, sizeof(ArrVals[0]), NULL));
+    OK_SIMPLE_STMT(hstmt, "insert into test_tbl_blockcursor (id, val) values (?,?)");
+    CHECK_STMT_RC(hstmt, SQLFreeStmt(hstmt, SQL_RESET_PARAMS));
+    CHECK_STMT_RC(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)1, 0));
+
+    return OK;
+}
+
 ODBC_TEST(test_colwise)
 {
     SQLHANDLE henv1;
@@ -249,10 +264,980 @@ ODBC_TEST(test_rowwise)
     return OK;
 }
 
+#define STREAM_ARRAY_SIZE 3
+
+ODBC_TEST(test_forward_only_stream)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    SQLHANDLE hstmt2;
+
+    preparedata();
+
+    ODBC_Connect(&henv1, &hdbc1, &hstmt1);
+
+    IS(insertdata(hstmt1) == OK);
+
+    /* Forward-only result is read from the wire as it is fetched */
+    SQLLEN rowsfetched = 0, rowcnt = 0;
+    SQLINTEGER RowIds[STREAM_ARRAY_SIZE] = { 0 };
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_FORWARD_ONLY, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)STREAM_ARRAY_SIZE, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROWS_FETCHED_PTR, &rowsfetched, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, RowIds, 0, NULL));
+
+    OK_SIMPLE_STMT(hstmt1, "select id from test_tbl_blockcursor order by id");
+
+    /* Size of unbuffered result is not known */
+    CHECK_STMT_RC(hstmt1, SQLRowCount(hstmt1, &rowcnt));
+    is_num(rowcnt, -1);
+
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(rowsfetched, STREAM_ARRAY_SIZE);
+    is_num(RowIds[0], 1);
+
+    /* Forward-only cursor can't be positioned within the rowset */
+    FAIL_IF(SQLSetPos(hstmt1, 1, SQL_POSITION, SQL_LOCK_NO_CHANGE) != SQL_ERROR, "SQLSetPos should fail");
+    CHECK_SQLSTATE(hstmt1, "HY109");
+
+    /* Other statement on the same connection makes driver to read the rest of the result */
+    CHECK_DBC_RC(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt2));
+    OK_SIMPLE_STMT(hstmt2, "select count(*) from test_tbl_blockcursor");
+    CHECK_STMT_RC(hstmt2, SQLFetch(hstmt2));
+    is_num(my_fetch_int(hstmt2, 1), PARAM_ARRAY_SIZE);
+    CHECK_STMT_RC(hstmt2, SQLFreeHandle(SQL_HANDLE_STMT, hstmt2));
+
+    int rowcount = STREAM_ARRAY_SIZE;
+    while (SQL_SUCCEEDED(SQLFetch(hstmt1))) {
+        is_num(RowIds[0], rowcount + 1);
+        rowcount += (int)rowsfetched;
+    }
+    is_num(rowcount, PARAM_ARRAY_SIZE);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    cleanup(hstmt1, "test_tbl_blockcursor");
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+ODBC_TEST(test_prefetch_rowset)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+
+    preparedata();
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, FALSE, NULL, NULL, NULL, 0, NULL, NULL, NULL, "PREFETCH_ROWSET=1");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    IS(insertdata(hstmt1) == OK);
+
+    /* Starting from 2nd rowset, next rowset is read in background */
+    SQLLEN rowsfetched = 0;
+    SQLINTEGER RowIds[2][STREAM_ARRAY_SIZE] = { 0 };
+    SQLCHAR RowVals[STREAM_ARRAY_SIZE][2] = { 0 };
+    SQLLEN ValLens[STREAM_ARRAY_SIZE] = { 0 };
+    SQLUSMALLINT RowStatus[STREAM_ARRAY_SIZE];
+    int rowcount = 0, rowset = 0;
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_FORWARD_ONLY, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)STREAM_ARRAY_SIZE, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROWS_FETCHED_PTR, &rowsfetched, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_STATUS_PTR, RowStatus, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_CHAR, RowVals, sizeof(RowVals[0]), ValLens));
+
+    OK_SIMPLE_STMT(hstmt1, "select id, val from test_tbl_blockcursor order by id");
+
+    /* Values are copied to the buffers bound at the moment of fetch */
+    do {
+        CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, RowIds[rowset % 2], 0, NULL));
+        if (!SQL_SUCCEEDED(SQLFetch(hstmt1))) {
+            break;
+        }
+        is_num(RowIds[rowset % 2][0], rowcount + 1);
+        IS_STR(RowVals[0], ArrVals[rowcount], 2);
+        is_num(ValLens[0], 1);
+        is_num(RowStatus[0], SQL_ROW_SUCCESS);
+        rowcount += (int)rowsfetched;
+        ++rowset;
+    } while (1);
+    is_num(rowcount, PARAM_ARRAY_SIZE);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+    cleanup(hstmt1, "test_tbl_blockcursor");
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+ODBC_TEST(test_prefetch_rebind)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+
+    preparedata();
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, FALSE, NULL, NULL, NULL, 0, NULL, NULL, NULL, "PREFETCH_ROWSET=1");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    IS(insertdata(hstmt1) == OK);
+
+    SQLLEN rowsfetched = 0;
+    SQLINTEGER RowIds[STREAM_ARRAY_SIZE] = { 0 };
+    SQLCHAR IdStrs[STREAM_ARRAY_SIZE][12] = { 0 };
+    SQLCHAR Val[32];
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_FORWARD_ONLY, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)STREAM_ARRAY_SIZE, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROWS_FETCHED_PTR, &rowsfetched, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, RowIds, 0, NULL));
+
+    OK_SIMPLE_STMT(hstmt1, "select id, val from test_tbl_blockcursor order by id");
+
+    /* After 2nd rowset the driver reads rows 7-9 in background */
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(RowIds[0], 4);
+
+    /* Rows, that have been read already, are converted to the new type */
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_CHAR, IdStrs, sizeof(IdStrs[0]), NULL));
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(rowsfetched, STREAM_ARRAY_SIZE);
+    IS_STR(IdStrs[0], "7", 2);
+    IS_STR(IdStrs[2], "9", 2);
+
+    /* Row 10 is being read in background, but the current row is still there */
+    IS_STR(my_fetch_str(hstmt1, Val, 2), ArrVals[8], 2);
+
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(rowsfetched, 1);
+    IS_STR(IdStrs[0], "10", 3);
+    IS_STR(my_fetch_str(hstmt1, Val, 2), ArrVals[9], 2);
+
+    EXPECT_STMT(hstmt1, SQLFetch(hstmt1), SQL_NO_DATA);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+    cleanup(hstmt1, "test_tbl_blockcursor");
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+ODBC_TEST(test_spill_static_cursor)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, FALSE, NULL, NULL, NULL, 0, NULL, NULL, NULL, "CURSOR_MEMORY_LIMIT=1");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    /* ~4MB result - rows beyond first megabyte are in temporary file */
+    SQLINTEGER RowIds[ROW_ARRAY_SIZE] = { 0 };
+    SQLCHAR RowVals[ROW_ARRAY_SIZE][4097] = { 0 };
+    SQLLEN ValLens[ROW_ARRAY_SIZE] = { 0 };
+    SQLLEN rowsfetched = 0;
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_STATIC, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)ROW_ARRAY_SIZE, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROWS_FETCHED_PTR, &rowsfetched, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, RowIds, 0, NULL));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_CHAR, RowVals, sizeof(RowVals[0]), ValLens));
+
+    OK_SIMPLE_STMT(hstmt1, "select x, rpad(cast(x as varchar), 4096, '*') from unnest(sequence(1, 1000)) as t(x) order by x");
+
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 996));
+    is_num(rowsfetched, ROW_ARRAY_SIZE);
+    is_num(RowIds[0], 996);
+    is_num(RowIds[4], 1000);
+    is_num(ValLens[4], 4096);
+    IS_STR(RowVals[4], "1000****", 8);
+
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_FIRST, 0));
+    is_num(RowIds[0], 1);
+    IS_STR(RowVals[0], "1*******", 8);
+
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 500));
+    is_num(RowIds[0], 500);
+    is_num(RowIds[4], 504);
+    IS_STR(RowVals[1], "501*****", 8);
+
+    /* Rows in the file are read into the window by batches - walking over several of them */
+    for (int expected = 505; expected <= 1000; expected += ROW_ARRAY_SIZE)
+    {
+        CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_NEXT, 0));
+        is_num(rowsfetched, ROW_ARRAY_SIZE);
+        is_num(RowIds[0], expected);
+        is_num(RowIds[ROW_ARRAY_SIZE - 1], expected + ROW_ARRAY_SIZE - 1);
+    }
+    EXPECT_STMT(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_NEXT, 0), SQL_NO_DATA);
+
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_LAST, 0));
+    is_num(RowIds[4], 1000);
+
+    EXPECT_STMT(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_NEXT, 0), SQL_NO_DATA);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+ODBC_TEST(test_rebind_between_rowsets)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+
+    preparedata();
+
+    ODBC_Connect(&henv1, &hdbc1, &hstmt1);
+
+    IS(insertdata(hstmt1) == OK);
+
+    /* Fetch plan is built for the 1st rowset, and has to be rebuilt after the columns are rebound */
+    SQLINTEGER RowIds[ROW_ARRAY_SIZE] = { 0 };
+    SQLCHAR RowIdStrs[ROW_ARRAY_SIZE][8] = { 0 };
+    SQLLEN IdLens[ROW_ARRAY_SIZE] = { 0 };
+    SQLWCHAR RowVals[ROW_ARRAY_SIZE][2] = { 0 };
+    SQLLEN ValLens[ROW_ARRAY_SIZE] = { 0 };
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)ROW_ARRAY_SIZE, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, RowIds, 0, NULL));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_WCHAR, RowVals, sizeof(RowVals[0]), ValLens));
+
+    OK_SIMPLE_STMT(hstmt1, "select id, val from test_tbl_blockcursor order by id");
+
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(RowIds[0], 1);
+    is_num(RowIds[4], 5);
+    is_num(RowVals[4][0], 'e');
+    is_num(ValLens[4], sizeof(SQLWCHAR));
+
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_CHAR, RowIdStrs, sizeof(RowIdStrs[0]), IdLens));
+
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    IS_STR(RowIdStrs[0], "6", 2);
+    IS_STR(RowIdStrs[4], "10", 3);
+    is_num(IdLens[4], 2);
+    is_num(RowVals[0][0], 'f');
+    is_num(RowVals[4][0], 'j');
+
+    EXPECT_STMT(hstmt1, SQLFetch(hstmt1), SQL_NO_DATA);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+    cleanup(hstmt1, "test_tbl_blockcursor");
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+ODBC_TEST(test_wchar_truncation)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, FALSE, NULL, NULL, NULL, 0, NULL, NULL, NULL, "CHARSET=utf8");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    /* utf8 values are transcoded from the row to the application's buffers */
+    SQLWCHAR RowVals[3][3] = { 0 };
+    SQLLEN ValLens[3] = { 0 };
+    SQLUSMALLINT RowStatus[3] = { 0 };
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)3, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_STATUS_PTR, RowStatus, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_WCHAR, RowVals, sizeof(RowVals[0]), ValLens));
+
+    OK_SIMPLE_STMT(hstmt1, "select x from (values 'a\xC3\xA9\xE2\x82\xAC', null, 'ab') as t(x)");
+
+    EXPECT_STMT(hstmt1, SQLFetch(hstmt1), SQL_SUCCESS_WITH_INFO);
+    CHECK_SQLSTATE(hstmt1, "01004");
+    is_num(RowVals[0][0], 'a');
+    is_num(RowVals[0][1], 0xE9);
+    is_num(RowVals[0][2], 0);
+    is_num(ValLens[0], 3 * sizeof(SQLWCHAR));
+    is_num(RowStatus[0], SQL_ROW_SUCCESS_WITH_INFO);
+    is_num(ValLens[1], SQL_NULL_DATA);
+    is_num(RowVals[2][0], 'a');
+    is_num(RowVals[2][1], 'b');
+    is_num(RowVals[2][2], 0);
+    is_num(ValLens[2], 2 * sizeof(SQLWCHAR));
+    is_num(RowStatus[2], SQL_ROW_SUCCESS);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+/* Long value read with SQLGetData in small parts is converted once, and parts never split surrogate pair */
+ODBC_TEST(test_getdata_wchar_pieces)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    SQLWCHAR Piece[8], *Whole;
+    SQLLEN Len, Total, Received = 0;
+    SQLRETURN rc;
+    /* 1000 times 'a', euro sign and U+1F600, that takes 2 units in utf16 */
+    SQLLEN Units = sizeof(SQLWCHAR) == 2 ? 4000 : 3000, PatternLen = sizeof(SQLWCHAR) == 2 ? 4 : 3, i;
+    SQLWCHAR Pattern[4] = { 'a', 0x20AC, 0, 0 };
+
+    if (sizeof(SQLWCHAR) == 2)
+    {
+        Pattern[2] = 0xD83D;
+        Pattern[3] = 0xDE00;
+    }
+    else
+    {
+        Pattern[2] = (SQLWCHAR)0x1F600;
+    }
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, FALSE, NULL, NULL, NULL, 0, NULL, NULL, NULL, "CHARSET=utf8");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    Whole = (SQLWCHAR*)malloc((Units + 1) * sizeof(SQLWCHAR));
+    FAIL_IF(Whole == NULL, "Could not allocate memory");
+
+    OK_SIMPLE_STMT(hstmt1, "select rpad('', 3000, 'a\xE2\x82\xAC\xF0\x9F\x98\x80')");
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+
+    /* Length only */
+    EXPECT_STMT(hstmt1, SQLGetData(hstmt1, 1, SQL_C_WCHAR, Piece, 0, &Total), SQL_SUCCESS_WITH_INFO);
+    is_num(Total, Units * sizeof(SQLWCHAR));
+
+    while ((rc = SQLGetData(hstmt1, 1, SQL_C_WCHAR, Piece, sizeof(Piece), &Len)) != SQL_NO_DATA)
+    {
+        SQLLEN Count = 0;
+
+        FAIL_IF(!SQL_SUCCEEDED(rc), "SQLGetData failed");
+        /* Length of the rest of the value */
+        is_num(Len, Total - Received * sizeof(SQLWCHAR));
+
+        while (Piece[Count] != 0)
+        {
+            ++Count;
+        }
+        FAIL_IF(Count == 0 || Received + Count > Units, "Wrong part length");
+        FAIL_IF(sizeof(SQLWCHAR) == 2 && (Piece[Count - 1] & 0xFC00) == 0xD800, "Surrogate pair has been split");
+        FAIL_IF((rc == SQL_SUCCESS) != (Received + Count == Units), "Wrong return code");
+
+        memcpy(Whole + Received, Piece, Count * sizeof(SQLWCHAR));
+        Received += Count;
+    }
+    is_num(Received, Units);
+
+    for (i = 0; i < Units; ++i)
+    {
+        if (Whole[i] != Pattern[i % PatternLen])
+        {
+            diag("Unit %ld: %x expected, %x received", (long)i, Pattern[i % PatternLen], Whole[i]);
+            free(Whole);
+            return FAIL;
+        }
+    }
+    free(Whole);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+/* Buffer, that holds only one unit and the terminating null, still makes progress over a surrogate pair */
+ODBC_TEST(test_getdata_wchar_one_unit)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    SQLWCHAR Piece[2], Whole[4];
+    SQLLEN Len, Units = sizeof(SQLWCHAR) == 2 ? 3 : 2, Received = 0;
+    SQLRETURN rc;
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, FALSE, NULL, NULL, NULL, 0, NULL, NULL, NULL, "CHARSET=utf8");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    /* U+1F600 and 'b' */
+    OK_SIMPLE_STMT(hstmt1, "select '\xF0\x9F\x98\x80" "b'");
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+
+    while ((rc = SQLGetData(hstmt1, 1, SQL_C_WCHAR, Piece, sizeof(Piece), &Len)) != SQL_NO_DATA)
+    {
+        FAIL_IF(!SQL_SUCCEEDED(rc), "SQLGetData failed");
+        FAIL_IF(Received == Units, "SQLGetData does not make progress");
+        is_num(Len, (Units - Received) * sizeof(SQLWCHAR));
+        FAIL_IF(Piece[0] == 0 || Piece[1] != 0, "Wrong part length");
+        FAIL_IF((rc == SQL_SUCCESS) != (Received + 1 == Units), "Wrong return code");
+        Whole[Received++] = Piece[0];
+    }
+    is_num(Received, Units);
+
+    if (sizeof(SQLWCHAR) == 2)
+    {
+        is_num(Whole[0], 0xD83D);
+        is_num(Whole[1], 0xDE00);
+    }
+    else
+    {
+        is_num(Whole[0], 0x1F600);
+    }
+    is_num(Whole[Units - 1], 'b');
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+/* Static cursor positioned randomly, re-executed with result of different size */
+ODBC_TEST(test_scroll_random_access)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    SQLINTEGER Id = 0, i;
+    SQLINTEGER Positions[] = { 7000, 3, 9999, 1, 5000, 10000 };
+
+    ODBC_Connect(&henv1, &hdbc1, &hstmt1);
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_STATIC, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, &Id, 0, NULL));
+
+    OK_SIMPLE_STMT(hstmt1, "select x from unnest(sequence(1, 10000)) as t(x) order by x");
+
+    for (i = 0; i < sizeof(Positions) / sizeof(Positions[0]); ++i)
+    {
+        CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, Positions[i]));
+        is_num(Id, Positions[i]);
+    }
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_PRIOR, 0));
+    is_num(Id, 9999);
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_RELATIVE, -4000));
+    is_num(Id, 5999);
+    EXPECT_STMT(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 10001), SQL_NO_DATA);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+    /* Rows of the new result have to be found, not the ones of the previous */
+    OK_SIMPLE_STMT(hstmt1, "select x * 2 from unnest(sequence(1, 100)) as t(x) order by x");
+
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 50));
+    is_num(Id, 100);
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_LAST, 0));
+    is_num(Id, 200);
+    EXPECT_STMT(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 101), SQL_NO_DATA);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+/* Keyset-driven cursor is only built for results carrying complete primary or unique key. Otherwise execution changes it to
+   static with 01S02, and the cursor scrolls all the same */
+ODBC_TEST(test_keyset_cursor)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    SQLINTEGER Id = 0;
+    SQLULEN CursorType = 0;
+    SQLRETURN rc;
+
+    ODBC_Connect(&henv1, &hdbc1, &hstmt1);
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_KEYSET_DRIVEN, 0));
+    CHECK_STMT_RC(hstmt1, SQLGetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, &CursorType, 0, NULL));
+    is_num(CursorType, SQL_CURSOR_KEYSET_DRIVEN);
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, &Id, 0, NULL));
+
+    rc = SQLExecDirect(hstmt1, (SQLCHAR *)"select x from unnest(sequence(1, 1000)) as t(x) order by x", SQL_NTS);
+    /* Result of the expression has no key */
+    is_num(rc, SQL_SUCCESS_WITH_INFO);
+    CHECK_SQLSTATE(hstmt1, "01S02");
+    CHECK_STMT_RC(hstmt1, SQLGetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, &CursorType, 0, NULL));
+    is_num(CursorType, SQL_CURSOR_STATIC);
+
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 700));
+    is_num(Id, 700);
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 3));
+    is_num(Id, 3);
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_LAST, 0));
+    is_num(Id, 1000);
+    EXPECT_STMT(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 1001), SQL_NO_DATA);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+/* SQLSetPos(SQL_UPDATE) on the row positioned inside the rowset has to find that row, and not the one read before */
+ODBC_TEST(test_setpos_update_positioned)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    SQLINTEGER Ids[ROW_ARRAY_SIZE];
+    SQLCHAR Vals[ROW_ARRAY_SIZE][2];
+    SQLLEN IdLens[ROW_ARRAY_SIZE], ValLens[ROW_ARRAY_SIZE];
+    SQLCHAR Val[32];
+
+    preparedata();
+
+    ODBC_Connect(&henv1, &hdbc1, &hstmt1);
+
+    IS(insertdata(hstmt1) == OK);
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_STATIC, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)ROW_ARRAY_SIZE, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, Ids, 0, IdLens));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_CHAR, Vals, sizeof(Vals[0]), ValLens));
+
+    OK_SIMPLE_STMT(hstmt1, "select id, val from test_tbl_blockcursor order by id");
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(Ids[2], 3);
+
+    CHECK_STMT_RC(hstmt1, SQLSetPos(hstmt1, 3, SQL_POSITION, SQL_LOCK_NO_CHANGE));
+    strcpy((char *)Vals[2], "z");
+    ValLens[2] = 1;
+    CHECK_STMT_RC(hstmt1, SQLSetPos(hstmt1, 3, SQL_UPDATE, SQL_LOCK_NO_CHANGE));
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, 0));
+
+    OK_SIMPLE_STMT(hstmt1, "select val from test_tbl_blockcursor where id = 3");
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    IS_STR(my_fetch_str(hstmt1, Val, 1), "z", 2);
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+    /* Rows, the cursor was on before, are not changed */
+    OK_SIMPLE_STMT(hstmt1, "select count(*) from test_tbl_blockcursor where val = 'z'");
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(my_fetch_int(hstmt1, 1), 1);
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+    cleanup(hstmt1, "test_tbl_blockcursor");
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+/* Rows added with SQLSetPos in the middle of the forward-only result. Rest of the result is stored, and still fetched */
+ODBC_TEST(test_setpos_add_stream)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    SQLINTEGER Ids[ROW_ARRAY_SIZE];
+    SQLCHAR Vals[ROW_ARRAY_SIZE][2];
+    SQLLEN IdLens[ROW_ARRAY_SIZE], ValLens[ROW_ARRAY_SIZE], Fetched = 0;
+    int i, Expected = ROW_ARRAY_SIZE + 1;
+
+    preparedata();
+
+    ODBC_Connect(&henv1, &hdbc1, &hstmt1);
+
+    IS(insertdata(hstmt1) == OK);
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_FORWARD_ONLY, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)ROW_ARRAY_SIZE, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROWS_FETCHED_PTR, &Fetched, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, Ids, 0, IdLens));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_CHAR, Vals, sizeof(Vals[0]), ValLens));
+
+    OK_SIMPLE_STMT(hstmt1, "select id, val from test_tbl_blockcursor order by id");
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(Ids[0], 1);
+
+    for (i = 0; i < ROW_ARRAY_SIZE; ++i)
+    {
+        Ids[i] += 100;
+    }
+    CHECK_STMT_RC(hstmt1, SQLSetPos(hstmt1, 0, SQL_ADD, SQL_LOCK_NO_CHANGE));
+
+    /* Rows read after the insert are the ones of the original result */
+    while (SQL_SUCCEEDED(SQLFetch(hstmt1)))
+    {
+        for (i = 0; i < Fetched; ++i)
+        {
+            is_num(Ids[i], Expected++);
+        }
+    }
+    is_num(Expected, PARAM_ARRAY_SIZE + 1);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, 0));
+
+    OK_SIMPLE_STMT(hstmt1, "select count(*) from test_tbl_blockcursor");
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(my_fetch_int(hstmt1, 1), PARAM_ARRAY_SIZE + ROW_ARRAY_SIZE);
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+    cleanup(hstmt1, "test_tbl_blockcursor");
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+/* Within DYNAMIC_CURSOR_REFRESH dynamic cursor is scrolled without re-executing the query */
+ODBC_TEST(test_dynamic_cursor_refresh)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    unsigned long Options = my_options | 32; /* Dynamic cursor */
+    SQLDOUBLE Value = 0, First = 0;
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, FALSE, NULL, NULL, NULL, 0, NULL, &Options, NULL, "DYNAMIC_CURSOR_REFRESH=600000");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_DYNAMIC, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_DOUBLE, &Value, 0, NULL));
+
+    /* Every execution gives different values */
+    OK_SIMPLE_STMT(hstmt1, "select random() from unnest(sequence(1, 10))");
+
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 3));
+    First = Value;
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_LAST, 0));
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_FIRST, 0));
+    CHECK_STMT_RC(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 3));
+    FAIL_IF(Value != First, "Query should not be re-executed");
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+/* SQL_ATTR_MAX_LENGTH cuts character and binary values, and that is not reported as truncation. Character values are cut
+   at character boundary */
+ODBC_TEST(test_max_length)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    SQLCHAR Buffer[64];
+    SQLWCHAR WBuffer[16];
+    SQLLEN Len, WLen;
+    SQLULEN CursorType[] = { SQL_CURSOR_FORWARD_ONLY, SQL_CURSOR_STATIC };
+    unsigned int i;
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, FALSE, NULL, NULL, NULL, 0, NULL, NULL, NULL, "CHARSET=utf8");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    for (i = 0; i < sizeof(CursorType)/sizeof(CursorType[0]); ++i)
+    {
+        CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)CursorType[i], 0));
+        CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_MAX_LENGTH, (SQLPOINTER)10, 0));
+
+        OK_SIMPLE_STMT(hstmt1, "select rpad('', 10000, 'x'), rpad('', 100, '\xE2\x82\xAC'), 5");
+        CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_CHAR, Buffer, sizeof(Buffer), &Len));
+
+        EXPECT_STMT(hstmt1, SQLFetch(hstmt1), SQL_SUCCESS);
+        is_num(Len, 10);
+        IS_STR(Buffer, "xxxxxxxxxx", 11);
+
+        /* 3 euro signs take 9 bytes, 4th does not fit */
+        EXPECT_STMT(hstmt1, SQLGetData(hstmt1, 2, SQL_C_WCHAR, WBuffer, sizeof(WBuffer), &WLen), SQL_SUCCESS);
+        is_num(WLen, 3 * sizeof(SQLWCHAR));
+        FAIL_IF(WBuffer[0] != 0x20AC || WBuffer[2] != 0x20AC || WBuffer[3] != 0, "Wrong value of the cut column");
+
+        /* Numeric columns are not affected */
+        CHECK_STMT_RC(hstmt1, SQLGetData(hstmt1, 3, SQL_C_CHAR, Buffer, sizeof(Buffer), &Len));
+        IS_STR(Buffer, "5", 2);
+
+        EXPECT_STMT(hstmt1, SQLFetch(hstmt1), SQL_NO_DATA);
+        CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+        CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+    }
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+/* SQL_ATTR_MAX_LENGTH applies to results produced after it is set. Stored rows are never changed by the fetch */
+ODBC_TEST(test_max_length_after_execute)
+{
+    SQLCHAR Buffer[128];
+    SQLLEN Len;
+
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_STATIC, 0));
+    OK_SIMPLE_STMT(Stmt, "select rpad('', 100, 'x')");
+    CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 1, SQL_C_CHAR, Buffer, sizeof(Buffer), &Len));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_MAX_LENGTH, (SQLPOINTER)10, 0));
+
+    CHECK_STMT_RC(Stmt, SQLFetchScroll(Stmt, SQL_FETCH_FIRST, 0));
+    is_num(Len, 100);
+    CHECK_STMT_RC(Stmt, SQLFetchScroll(Stmt, SQL_FETCH_FIRST, 0));
+    is_num(Len, 100);
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+    OK_SIMPLE_STMT(Stmt, "select rpad('', 100, 'x')");
+    CHECK_STMT_RC(Stmt, SQLFetchScroll(Stmt, SQL_FETCH_FIRST, 0));
+    is_num(Len, 10);
+    IS_STR(Buffer, "xxxxxxxxxx", 11);
+
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_MAX_LENGTH, (SQLPOINTER)0, 0));
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_UNBIND));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_FORWARD_ONLY, 0));
+
+    return OK;
+}
+
+/* Only few columns of the wide result are bound. Unbound columns are still available for SQLGetData */
+ODBC_TEST(test_sparse_binding)
+{
+    SQLINTEGER Third[2], Seventh[2], Value;
+    SQLLEN ThirdInd[2], SeventhInd[2];
+    SQLULEN Fetched;
+
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)2, 0));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROWS_FETCHED_PTR, &Fetched, 0));
+
+    OK_SIMPLE_STMT(Stmt, "select 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 union all select 11, 12, null, 14, 15, 16, 17, 18, 19, 20");
+    CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 3, SQL_C_LONG, Third, 0, ThirdInd));
+    CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 7, SQL_C_LONG, Seventh, 0, SeventhInd));
+
+    CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+    is_num(Fetched, 2);
+    is_num(Third[0], 3);
+    is_num(ThirdInd[1], SQL_NULL_DATA);
+    is_num(Seventh[0], 7);
+    is_num(Seventh[1], 17);
+
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, 0));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROWS_FETCHED_PTR, NULL, 0));
+
+    OK_SIMPLE_STMT(Stmt, "select 1, 2, 3, 4, 5, 6, 7, 8, 9, 10");
+    CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+    is_num(Third[0], 3);
+    CHECK_STMT_RC(Stmt, SQLGetData(Stmt, 10, SQL_C_LONG, &Value, 0, NULL));
+    is_num(Value, 10);
+
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_UNBIND));
+
+    return OK;
+}
+
+#define MADB_ATTR_COLUMN_MAJOR 0x4002
+
+ODBC_TEST(test_column_major)
+{
+    SQLINTEGER Id[3];
+    SQLCHAR Name[3][4];
+    SQLLEN IdInd[3], NameLen[3];
+    SQLUSMALLINT Status[3];
+    SQLUINTEGER ColumnMajor = 0;
+    SQLULEN Fetched;
+
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, (SQLINTEGER)MADB_ATTR_COLUMN_MAJOR, (SQLPOINTER)1, 0));
+    CHECK_STMT_RC(Stmt, SQLGetStmtAttr(Stmt, (SQLINTEGER)MADB_ATTR_COLUMN_MAJOR, &ColumnMajor, 0, NULL));
+    is_num(ColumnMajor, 1);
+
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)3, 0));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROWS_FETCHED_PTR, &Fetched, 0));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_STATUS_PTR, Status, 0));
+
+    OK_SIMPLE_STMT(Stmt, "select 1, 'abc' union all select null, 'abcdef' union all select 3, null");
+    CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 1, SQL_C_LONG, Id, 0, IdInd));
+    CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 2, SQL_C_CHAR, Name, sizeof(Name[0]), NameLen));
+
+    EXPECT_STMT(Stmt, SQLFetch(Stmt), SQL_SUCCESS_WITH_INFO);
+    is_num(Fetched, 3);
+    is_num(Id[0], 1);
+    is_num(IdInd[1], SQL_NULL_DATA);
+    is_num(Id[2], 3);
+    IS_STR(Name[0], "abc", 4);
+    is_num(NameLen[1], 6);
+    is_num(NameLen[2], SQL_NULL_DATA);
+    is_num(Status[0], SQL_ROW_SUCCESS);
+    is_num(Status[1], SQL_ROW_SUCCESS_WITH_INFO);
+    is_num(Status[2], SQL_ROW_SUCCESS);
+    CHECK_SQLSTATE(Stmt, "01004");
+
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_UNBIND));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, 0));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROWS_FETCHED_PTR, NULL, 0));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_STATUS_PTR, NULL, 0));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, (SQLINTEGER)MADB_ATTR_COLUMN_MAJOR, (SQLPOINTER)0, 0));
+
+    return OK;
+}
+
+/* Results of the batch are left in server side cursors, and only rows the application fetches are transferred */
+ODBC_TEST(test_lazy_batch_results)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    unsigned long Options = my_options | 67108864; /* Multi statements */
+    SQLINTEGER Value[3];
+    SQLULEN Fetched;
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, FALSE, NULL, NULL, NULL, 0, NULL, &Options, NULL, "PREFETCH_ROWS=2");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)3, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROWS_FETCHED_PTR, &Fetched, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, Value, 0, NULL));
+
+    OK_SIMPLE_STMT(hstmt1, "select cast(x as integer) from unnest(sequence(1, 5)) as t(x) order by x;"
+                           "select 10;"
+                           "select cast(x as integer) from unnest(sequence(21, 23)) as t(x) order by x");
+
+    /* Only first rowset of the 1st result is read, and the rest is skipped */
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(Fetched, 3);
+    is_num(Value[2], 3);
+
+    CHECK_STMT_RC(hstmt1, SQLMoreResults(hstmt1));
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(Fetched, 1);
+    is_num(Value[0], 10);
+    EXPECT_STMT(hstmt1, SQLFetch(hstmt1), SQL_NO_DATA);
+
+    CHECK_STMT_RC(hstmt1, SQLMoreResults(hstmt1));
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(Fetched, 3);
+    is_num(Value[0], 21);
+    is_num(Value[2], 23);
+    EXPECT_STMT(hstmt1, SQLMoreResults(hstmt1), SQL_NO_DATA);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+/* Large rowset is converted by several threads. Result must not depend on that */
+#define PARALLEL_ROWS 10000
+
+ODBC_TEST(test_parallel_conversion)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    static SQLBIGINT Ids[PARALLEL_ROWS];
+    static SQLCHAR Vals[PARALLEL_ROWS][8];
+    static SQLLEN ValLens[PARALLEL_ROWS];
+    static SQLUSMALLINT Status[PARALLEL_ROWS];
+    SQLULEN Fetched, i;
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, FALSE, NULL, NULL, NULL, 0, NULL, NULL, NULL, "CONVERSION_THREADS=4");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, (SQLINTEGER)MADB_ATTR_COLUMN_MAJOR, (SQLPOINTER)1, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)PARALLEL_ROWS, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROWS_FETCHED_PTR, &Fetched, 0));
+    CHECK_STMT_RC(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_STATUS_PTR, Status, 0));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_SBIGINT, Ids, 0, NULL));
+    CHECK_STMT_RC(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_CHAR, Vals, sizeof(Vals[0]), ValLens));
+
+    OK_SIMPLE_STMT(hstmt1, "select x, case when x = 7000 then null else cast(x as varchar) end from unnest(sequence(1, 10000)) as t(x) order by x");
+
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(Fetched, PARALLEL_ROWS);
+    for (i = 0; i < PARALLEL_ROWS; ++i)
+    {
+        is_num(Ids[i], i + 1);
+        is_num(Status[i], SQL_ROW_SUCCESS);
+    }
+    IS_STR(Vals[0], "1", 2);
+    IS_STR(Vals[4999], "5000", 5);
+    is_num(ValLens[6999], SQL_NULL_DATA);
+    IS_STR(Vals[9999], "10000", 6);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+    /* Threads of the connection convert the next result too */
+    OK_SIMPLE_STMT(hstmt1, "select x * 2, cast(x as varchar) from unnest(sequence(1, 10000)) as t(x) order by x");
+
+    CHECK_STMT_RC(hstmt1, SQLFetch(hstmt1));
+    is_num(Fetched, PARALLEL_ROWS);
+    is_num(Ids[0], 2);
+    is_num(Ids[9999], 20000);
+    IS_STR(Vals[6999], "7000", 5);
+
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+    CHECK_STMT_RC(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
 MA_ODBC_TESTS my_tests[]=
 {
     { test_colwise ,"test_colwise" },
     { test_rowwise , "test_rowwise" },
+    { test_forward_only_stream, "test_forward_only_stream" },
+    { test_prefetch_rowset, "test_prefetch_rowset" },
+    { test_prefetch_rebind, "test_prefetch_rebind" },
+    { test_spill_static_cursor, "test_spill_static_cursor" },
+    { test_rebind_between_rowsets, "test_rebind_between_rowsets" },
+    { test_wchar_truncation, "test_wchar_truncation" },
+    { test_getdata_wchar_pieces, "test_getdata_wchar_pieces" },
+    { test_getdata_wchar_one_unit, "test_getdata_wchar_one_unit" },
+    { test_scroll_random_access, "test_scroll_random_access" },
+    { test_keyset_cursor, "test_keyset_cursor" },
+    { test_setpos_update_positioned, "test_setpos_update_positioned" },
+    { test_setpos_add_stream, "test_setpos_add_stream" },
+    { test_dynamic_cursor_refresh, "test_dynamic_cursor_refresh" },
+    { test_max_length, "test_max_length" },
+    { test_max_length_after_execute, "test_max_length_after_execute" },
+    { test_sparse_binding, "test_sparse_binding" },
+    { test_column_major, "test_column_major" },
+    { test_parallel_conversion, "test_parallel_conversion" },
+    { test_lazy_batch_results, "test_lazy_batch_results" },
     { NULL, NULL }
 };
 
@@ -445,6 +445,84 @@ ODBC_TEST(test_DatesAndTime)
 }
 
 
+/* DECIMAL(38,x) values fetched into, and sent from SQL_NUMERIC_STRUCT, with scale taken from the descriptors */
+ODBC_TEST(test_NumericStruct)
+{
+    /* 12345678901234567890123456789012345678 */
+    SQLCHAR Digits38[SQL_MAX_NUMERIC_LEN] = { 0x4e, 0xf3, 0x38, 0xde, 0x50, 0x90, 0x49, 0xc4,
+                                              0x13, 0x33, 0x02, 0xf0, 0xf6, 0xb0, 0x49, 0x09 };
+    SQL_NUMERIC_STRUCT Big, Small;
+    SQLHDESC Ard;
+    SQLCHAR Buffer[64];
+    SQLLEN Len;
+
+    CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 1, SQL_C_NUMERIC, &Big, sizeof(Big), NULL));
+    CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 2, SQL_C_NUMERIC, &Small, sizeof(Small), NULL));
+    CHECK_STMT_RC(Stmt, SQLGetStmtAttr(Stmt, SQL_ATTR_APP_ROW_DESC, &Ard, SQL_IS_POINTER, NULL));
+    CHECK_DESC_RC(Ard, SQLSetDescField(Ard, 1, SQL_DESC_PRECISION, (SQLPOINTER)38, SQL_IS_INTEGER));
+    CHECK_DESC_RC(Ard, SQLSetDescField(Ard, 1, SQL_DESC_SCALE, (SQLPOINTER)8, SQL_IS_INTEGER));
+    CHECK_DESC_RC(Ard, SQLSetDescField(Ard, 1, SQL_DESC_DATA_PTR, &Big, SQL_IS_POINTER));
+    CHECK_DESC_RC(Ard, SQLSetDescField(Ard, 2, SQL_DESC_PRECISION, (SQLPOINTER)10, SQL_IS_INTEGER));
+    CHECK_DESC_RC(Ard, SQLSetDescField(Ard, 2, SQL_DESC_SCALE, (SQLPOINTER)4, SQL_IS_INTEGER));
+    CHECK_DESC_RC(Ard, SQLSetDescField(Ard, 2, SQL_DESC_DATA_PTR, &Small, SQL_IS_POINTER));
+
+    OK_SIMPLE_STMT(Stmt, "SELECT DECIMAL '-123456789012345678901234567890.12345678', DECIMAL '0.05'");
+    CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+
+    is_num(Big.precision, 38);
+    is_num(Big.scale, 8);
+    is_num(Big.sign, 0);
+    IS(memcmp(Big.val, Digits38, sizeof(Digits38)) == 0);
+    is_num(Small.scale, 4);
+    is_num(Small.sign, 1);
+    is_num(Small.val[0], 0xf4); /* 500 */
+    is_num(Small.val[1], 0x01);
+
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_UNBIND));
+
+    CHECK_STMT_RC(Stmt, SQLBindParameter(Stmt, 1, SQL_PARAM_INPUT, SQL_C_NUMERIC, SQL_DECIMAL, 38, 8, &Big, 0, NULL));
+    OK_SIMPLE_STMT(Stmt, "SELECT CAST(? AS VARCHAR)");
+    CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+    CHECK_STMT_RC(Stmt, SQLGetData(Stmt, 1, SQL_C_CHAR, Buffer, sizeof(Buffer), &Len));
+    IS_STR(Buffer, "-123456789012345678901234567890.12345678", Len + 1);
+
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_RESET_PARAMS));
+
+    return OK;
+}
+
+
+/* Value, that does not fit SQL_NUMERIC_STRUCT's precision, fails the row, and row operation array stays untouched */
+ODBC_TEST(test_NumericOverflow)
+{
+    SQL_NUMERIC_STRUCT Num;
+    SQLHDESC Ard;
+    SQLUSMALLINT RowStatus = SQL_ROW_NOROW, RowOperation = SQL_ROW_PROCEED;
+
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_STATUS_PTR, &RowStatus, 0));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_OPERATION_PTR, &RowOperation, 0));
+    CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 1, SQL_C_NUMERIC, &Num, sizeof(Num), NULL));
+    CHECK_STMT_RC(Stmt, SQLGetStmtAttr(Stmt, SQL_ATTR_APP_ROW_DESC, &Ard, SQL_IS_POINTER, NULL));
+    CHECK_DESC_RC(Ard, SQLSetDescField(Ard, 1, SQL_DESC_PRECISION, (SQLPOINTER)2, SQL_IS_INTEGER));
+    CHECK_DESC_RC(Ard, SQLSetDescField(Ard, 1, SQL_DESC_SCALE, (SQLPOINTER)0, SQL_IS_INTEGER));
+    CHECK_DESC_RC(Ard, SQLSetDescField(Ard, 1, SQL_DESC_DATA_PTR, &Num, SQL_IS_POINTER));
+
+    OK_SIMPLE_STMT(Stmt, "SELECT DECIMAL '12345'");
+    EXPECT_STMT(Stmt, SQLFetch(Stmt), SQL_ERROR);
+    CHECK_SQLSTATE(Stmt, "22003");
+    is_num(RowStatus, SQL_ROW_ERROR);
+    is_num(RowOperation, SQL_ROW_PROCEED);
+
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_UNBIND));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_STATUS_PTR, NULL, 0));
+    CHECK_STMT_RC(Stmt, SQLSetStmtAttr(Stmt, SQL_ATTR_ROW_OPERATION_PTR, NULL, 0));
+
+    return OK;
+}
+
 /*****************************************************************/
 // data type for metadata information relate apis:
 //SQLGetTypeInfo[CATALOG]  db's support data types
@@ -466,6 +544,8 @@ MA_ODBC_TESTS my_tests[]=
     {test_SQLDescribeParam_API,  "test_SQLDescribeCol_API"},
     {test_data_query,            "test_data_query"},
     {test_DatesAndTime,          "test_DatesAndTime"},
+    {test_NumericStruct,         "test_NumericStruct"},
+    {test_NumericOverflow,       "test_NumericOverflow"},
     {tests_cleanup,              "clean_up_dataset"},
     {NULL, NULL}
 };
@@ -0,0 +1,79 @@
+/*
+  Copyright (C) 2018-2020. Huawei Technologies Co., Ltd. All rights reserved.
+  
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+  
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "tap.h"
+
+#define MADB_ATTR_PS_CACHE_HITS   0x4001
+#define MADB_ATTR_PS_CACHE_MISSES 0x4002
+
+static int PrepareAndCheck(SQLHANDLE Stmt, const char *Query, SQLINTEGER Expected)
+{
+    SQLINTEGER Value = 0;
+
+    CHECK_STMT_RC(Stmt, SQLPrepare(Stmt, (SQLCHAR *)Query, SQL_NTS));
+    CHECK_STMT_RC(Stmt, SQLExecute(Stmt));
+    CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+    CHECK_STMT_RC(Stmt, SQLGetData(Stmt, 1, SQL_C_LONG, &Value, 0, NULL));
+    is_num(Value, Expected);
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+
+    return OK;
+}
+
+/* Re-prepared statement takes the handle from the connection's cache, least recently used handle is evicted */
+ODBC_TEST(test_ps_cache)
+{
+    SQLHANDLE henv1;
+    SQLHANDLE hdbc1;
+    SQLHANDLE hstmt1;
+    SQLULEN Hits, Misses;
+
+    IS(AllocEnvConn(&henv1, &hdbc1));
+    hstmt1 = DoConnect(hdbc1, FALSE, NULL, NULL, NULL, 0, NULL, NULL, NULL, "PS_CACHE_SIZE=2");
+    FAIL_IF(hstmt1 == NULL, "connect to dsn error.");
+
+    IS(PrepareAndCheck(hstmt1, "select 1", 1) == OK);
+    IS(PrepareAndCheck(hstmt1, "select 1", 1) == OK);
+    IS(PrepareAndCheck(hstmt1, "select 2", 2) == OK);
+    IS(PrepareAndCheck(hstmt1, "select 3", 3) == OK);
+    /* "select 1" is evicted by now */
+    IS(PrepareAndCheck(hstmt1, "select 1", 1) == OK);
+
+    CHECK_DBC_RC(hdbc1, SQLGetConnectAttr(hdbc1, MADB_ATTR_PS_CACHE_HITS, &Hits, 0, NULL));
+    CHECK_DBC_RC(hdbc1, SQLGetConnectAttr(hdbc1, MADB_ATTR_PS_CACHE_MISSES, &Misses, 0, NULL));
+    is_num(Hits, 1);
+    is_num(Misses, 4);
+
+    ODBC_Disconnect(henv1, hdbc1, hstmt1);
+
+    return OK;
+}
+
+MA_ODBC_TESTS my_tests[]=
+{
+    { test_ps_cache, "test_ps_cache" },
+    { NULL, NULL }
+};
+
+int main(int argc, char **argv)
+{
+  int tests= sizeof(my_tests)/sizeof(MA_ODBC_TESTS) - 1;
+  get_options(argc, argv);
+  plan(tests);
+  mark_all_tests_normal(my_tests);
+  return run_tests(my_tests);
+}
@@ -0,0 +1,65 @@
+/*
+  Copyright (C) 2018-2020. Huawei Technologies Co., Ltd. All rights reserved.
+  
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+  
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "tap.h"
+
+/* Long query is parsed once, and its next executions take parsed query from the cache */
+ODBC_TEST(test_long_query_reparse)
+{
+    SQLCHAR Query[4096];
+    SQLINTEGER Param, Value;
+    size_t Len;
+    int i;
+
+    /* Comment makes the query long enough to be cached */
+    strcpy((char *)Query, "/*");
+    Len = strlen((char *)Query);
+    memset(Query + Len, 'x', 2048);
+    strcpy((char *)Query + Len + 2048, "*/ select cast(? as integer) + x from unnest(sequence(1, 3)) as t(x) order by x");
+
+    CHECK_STMT_RC(Stmt, SQLBindParameter(Stmt, 1, SQL_PARAM_INPUT, SQL_C_LONG, SQL_INTEGER, 0, 0, &Param, 0, NULL));
+    CHECK_STMT_RC(Stmt, SQLBindCol(Stmt, 1, SQL_C_LONG, &Value, 0, NULL));
+
+    for (i = 0; i < 3; ++i)
+    {
+        Param = i * 10;
+        CHECK_STMT_RC(Stmt, SQLExecDirect(Stmt, Query, SQL_NTS));
+        CHECK_STMT_RC(Stmt, SQLFetch(Stmt));
+        is_num(Value, i * 10 + 1);
+        CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_CLOSE));
+    }
+
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_UNBIND));
+    CHECK_STMT_RC(Stmt, SQLFreeStmt(Stmt, SQL_RESET_PARAMS));
+
+    return OK;
+}
+
+MA_ODBC_TESTS my_tests[]=
+{
+    { test_long_query_reparse, "test_long_query_reparse" },
+    { NULL, NULL }
+};
+
+int main(int argc, char **argv)
+{
+  int tests= sizeof(my_tests)/sizeof(MA_ODBC_TESTS) - 1;
+  get_options(argc, argv);
+  plan(tests);
+  mark_all_tests_normal(my_tests);
+  return run_tests(my_tests);
+}
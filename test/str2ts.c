@@ -0,0 +1,368 @@
+/*
+  Copyright (C) 2018-2020. Huawei Technologies Co., Ltd. All rights reserved.
+  
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+  
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/* Tests of the date/time string parser. The parser is compared with the sscanf based one, it has replaced, on the
+   generated values. Does not need the server */
+
+#include <ctype.h>
+#include "tap.h"
+#include "ma_datetime.h"
+
+#define MAX_VALUE_LEN 128
+#define FUZZ_VALUES   200000
+
+/* Copy of the replaced parser, except that it uses a buffer on the stack, and returns FALSE instead of setting the error */
+static BOOL ReferenceStr2Ts(const char *Str, size_t Length, MYSQL_TIME *Tm, BOOL Interval, BOOL *isTime)
+{
+  char Buffer[MAX_VALUE_LEN + 1];
+  char *Start= Buffer, *Frac, *End= Start + Length;
+  my_bool isDate= 0;
+
+  memset(Tm, 0, sizeof(MYSQL_TIME));
+  memcpy(Start, Str, Length);
+  Start[Length]= '\0';
+
+  while (Length && isspace(*Start)) Start++, Length--;
+
+  if (Length == 0)
+  {
+    return TRUE;
+  }
+
+  if (strchr(Start, '-'))
+  {
+    if (sscanf(Start, "%d-%u-%u", &Tm->year, &Tm->month, &Tm->day) < 3)
+    {
+      return FALSE;
+    }
+    isDate= 1;
+    if (!(Start= strchr(Start, ' ')))
+    {
+      goto check;
+    }
+  }
+  if (!strchr(Start, ':'))
+  {
+    goto check;
+  }
+
+  if (isDate == 0)
+  {
+    *isTime= 1;
+  }
+
+  if ((Frac= strchr(Start, '.')) != NULL)
+  {
+    size_t FracMulIdx= End - (Frac + 1) - 1;
+    if (sscanf(Start, "%d:%u:%u.%6lu", &Tm->hour, &Tm->minute,
+      &Tm->second, &Tm->second_part) < 4)
+    {
+      return FALSE;
+    }
+    if (FracMulIdx < 6 - 1)
+    {
+      static unsigned long Mul[]= {100000, 10000, 1000, 100, 10};
+      Tm->second_part*= Mul[FracMulIdx];
+    }
+  }
+  else
+  {
+    if (sscanf(Start, "%d:%u:%u", &Tm->hour, &Tm->minute,
+      &Tm->second) < 3)
+    {
+      return FALSE;
+    }
+  }
+
+check:
+  if (Interval == FALSE)
+  {
+    if (isDate)
+    {
+      if (Tm->year > 0)
+      {
+        if (Tm->year < 70)
+        {
+          Tm->year+= 2000;
+        }
+        else if (Tm->year < 100)
+        {
+          Tm->year+= 1900;
+        }
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+
+static BOOL SameTime(MYSQL_TIME *A, MYSQL_TIME *B)
+{
+  return A->year == B->year && A->month == B->month && A->day == B->day && A->hour == B->hour && A->minute == B->minute
+      && A->second == B->second && A->second_part == B->second_part && A->neg == B->neg && A->time_type == B->time_type;
+}
+
+
+static void PrintTime(const char *Title, BOOL Result, BOOL isTime, MYSQL_TIME *Tm)
+{
+  diag("%s: %d isTime:%d %u-%u-%u %u:%u:%u.%lu", Title, Result, isTime, Tm->year, Tm->month, Tm->day, Tm->hour, Tm->minute,
+       Tm->second, Tm->second_part);
+}
+
+
+static int CompareWithReference(const char *Value, size_t Length, BOOL Interval)
+{
+  MYSQL_TIME Expected, Parsed;
+  BOOL       ExpectedIsTime= FALSE, ParsedIsTime= FALSE;
+  BOOL       ExpectedResult= ReferenceStr2Ts(Value, Length, &Expected, Interval, &ExpectedIsTime);
+  BOOL       ParsedResult=   MADB_ParseDateTime(Value, Length, &Parsed, Interval, &ParsedIsTime);
+
+  if (ExpectedResult != ParsedResult || ExpectedIsTime != ParsedIsTime || !SameTime(&Expected, &Parsed))
+  {
+    diag("Value: \"%.*s\" Interval:%d", (int)Length, Value, Interval);
+    PrintTime("Expected", ExpectedResult, ExpectedIsTime, &Expected);
+    PrintTime("Parsed  ", ParsedResult, ParsedIsTime, &Parsed);
+    return FAIL;
+  }
+  return OK;
+}
+
+
+ODBC_TEST(iso_layouts)
+{
+  MYSQL_TIME Tm;
+  BOOL       isTime= FALSE;
+  const char *Values[]= {"2021-03-04", "2021-03-04 05:06:07", "2021-03-04 05:06:07.1", "2021-03-04 05:06:07.123",
+                         "2021-03-04 05:06:07.123456", "2021-03-04 05:06:07.123456789", "05:06:07", "05:06:07.5",
+                         "838:59:59", "21-3-4", "99-12-31 23:59:59", "0000-00-00 00:00:00", "  2021-03-04 05:06:07",
+                         "2021-03-04T05:06:07", "", "   ", "-10:00:00", "2021-03", "05:06", "2021-03-04 05:06",
+                         "2021-03-04 05:06:07.", "12:00:00.5 ", "2021-13-45 25:61:61", "+2021-+3-4", NULL};
+  unsigned int i;
+
+  for (i= 0; Values[i] != NULL; ++i)
+  {
+    IS(CompareWithReference(Values[i], strlen(Values[i]), FALSE) == OK);
+    IS(CompareWithReference(Values[i], strlen(Values[i]), TRUE) == OK);
+  }
+
+  IS(MADB_ParseDateTime("2021-03-04 05:06:07.123", 23, &Tm, FALSE, &isTime));
+  is_num(isTime, FALSE);
+  is_num(Tm.year, 2021);
+  is_num(Tm.month, 3);
+  is_num(Tm.day, 4);
+  is_num(Tm.hour, 5);
+  is_num(Tm.minute, 6);
+  is_num(Tm.second, 7);
+  is_num(Tm.second_part, 123000);
+
+  /* Only the given length is parsed */
+  IS(MADB_ParseDateTime("05:06:07.123", 10, &Tm, FALSE, &isTime));
+  is_num(isTime, TRUE);
+  is_num(Tm.second, 7);
+  is_num(Tm.second_part, 100000);
+
+  IS(MADB_ParseDateTime("21-03-04", 8, &Tm, FALSE, &isTime));
+  is_num(Tm.year, 2021);
+  IS(MADB_ParseDateTime("21-03-04", 8, &Tm, TRUE, &isTime));
+  is_num(Tm.year, 21);
+
+  IS(!MADB_ParseDateTime("2021-03", 7, &Tm, FALSE, &isTime));
+  IS(!MADB_ParseDateTime("05:06", 5, &Tm, FALSE, &isTime));
+
+  return OK;
+}
+
+
+/* Deterministic generator, so that failures are reproducible on any platform */
+static unsigned int FuzzSeed= 20210304;
+
+static unsigned int FuzzRandom(unsigned int Limit)
+{
+  FuzzSeed= FuzzSeed * 1103515245 + 12345;
+  return (FuzzSeed >> 16) % Limit;
+}
+
+
+static size_t AppendDigits(char *Buffer, size_t Length, unsigned int MaxDigits)
+{
+  unsigned int Digits= FuzzRandom(MaxDigits + 1);
+
+  if (FuzzRandom(16) == 0)
+  {
+    Buffer[Length++]= FuzzRandom(2) ? '-' : '+';
+  }
+  while (Digits--)
+  {
+    Buffer[Length++]= '0' + FuzzRandom(10);
+  }
+  return Length;
+}
+
+
+static size_t AppendSeparator(char *Buffer, size_t Length, char Separator)
+{
+  static const char Alphabet[]= " \t-+:.T/0aZ";
+
+  switch (FuzzRandom(12))
+  {
+  case 0:
+    /* Missing separator */
+    break;
+  case 1:
+    Buffer[Length++]= Alphabet[FuzzRandom(sizeof(Alphabet) - 1)];
+    break;
+  case 2:
+    Buffer[Length++]= ' ';
+  default:
+    Buffer[Length++]= Separator;
+  }
+  return Length;
+}
+
+
+/* Generates value of one of the layouts the parser recognizes, with random number of digits in fields, and random
+   separators, whitespaces and junk */
+static size_t GenerateValue(char *Buffer)
+{
+  size_t       Length= 0;
+  unsigned int Layout= FuzzRandom(4), Mutations= FuzzRandom(3);
+
+  while (Length < 8 && FuzzRandom(4) == 0)
+  {
+    Buffer[Length++]= FuzzRandom(2) ? ' ' : '\t';
+  }
+  if (Layout != 2)
+  {
+    Length= AppendDigits(Buffer, Length, 5);
+    Length= AppendSeparator(Buffer, Length, '-');
+    Length= AppendDigits(Buffer, Length, 3);
+    Length= AppendSeparator(Buffer, Length, '-');
+    Length= AppendDigits(Buffer, Length, 3);
+  }
+  if (Layout == 1 || Layout == 3)
+  {
+    Length= AppendSeparator(Buffer, Length, ' ');
+  }
+  if (Layout != 0)
+  {
+    Length= AppendDigits(Buffer, Length, 4);
+    Length= AppendSeparator(Buffer, Length, ':');
+    Length= AppendDigits(Buffer, Length, 3);
+    Length= AppendSeparator(Buffer, Length, ':');
+    Length= AppendDigits(Buffer, Length, 3);
+    if (FuzzRandom(2))
+    {
+      Length= AppendSeparator(Buffer, Length, '.');
+      Length= AppendDigits(Buffer, Length, 12);
+    }
+  }
+  while (Length < MAX_VALUE_LEN - 8 && FuzzRandom(6) == 0)
+  {
+    Length= AppendSeparator(Buffer, Length, ' ');
+  }
+
+  while (Mutations-- && Length > 0)
+  {
+    size_t Position= FuzzRandom((unsigned int)Length);
+
+    switch (FuzzRandom(3))
+    {
+    case 0:
+      memmove(Buffer + Position, Buffer + Position + 1, Length - Position - 1);
+      --Length;
+      break;
+    case 1:
+      memmove(Buffer + Position + 1, Buffer + Position, Length - Position);
+      ++Length;
+      /* fall through */
+    default:
+      Buffer[Position]= " -:.90"[FuzzRandom(6)];
+    }
+  }
+
+  return Length;
+}
+
+
+/* sscanf saturates numbers, that do not fit into long, and the parser wraps them around. Values with such numbers are
+   skipped */
+static BOOL HasLongNumber(const char *Value, size_t Length)
+{
+  size_t Digits= 0;
+
+  while (Length--)
+  {
+    Digits= isdigit((unsigned char)*Value++) ? Digits + 1 : 0;
+    if (Digits > 18)
+    {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+
+ODBC_TEST(fuzz_equivalence)
+{
+  char         Value[MAX_VALUE_LEN];
+  unsigned int i;
+
+  for (i= 0; i < FUZZ_VALUES; ++i)
+  {
+    size_t Length= GenerateValue(Value);
+
+    if (HasLongNumber(Value, Length))
+    {
+      continue;
+    }
+    IS(CompareWithReference(Value, Length, FALSE) == OK);
+    IS(CompareWithReference(Value, Length, TRUE) == OK);
+  }
+
+  return OK;
+}
+
+
+MA_ODBC_TESTS my_tests[]=
+{
+  {iso_layouts,      "str2ts_iso_layouts",      NORMAL},
+  {fuzz_equivalence, "str2ts_fuzz_equivalence", NORMAL},
+  {NULL, NULL, 0}
+};
+
+
+int main(int argc, char **argv)
+{
+  MA_ODBC_TESTS *Test= my_tests;
+  int            rc, failed= 0, i= 1;
+
+  fprintf(stdout, "1..%d\n", (int)(sizeof(my_tests)/sizeof(MA_ODBC_TESTS) - 1));
+
+  while (Test->title != NULL)
+  {
+    rc= Test->my_test();
+    if (rc == FAIL)
+    {
+      ++failed;
+    }
+    fprintf(stdout, "%s %d - %s\n", test_status[rc], i++, Test->title);
+    ++Test;
+  }
+
+  return failed != 0;
+}
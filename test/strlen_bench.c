@@ -0,0 +1,131 @@
+/*
+  Copyright (C) 2018-2020. Huawei Technologies Co., Ltd. All rights reserved.
+  
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+  
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/* Microbenchmark of string length scanning on typical varchar payloads. Compares driver's kernels with character by
+   character scanning through charset's callback, that MbstrCharLen and SqlwcsLen used to do. Is not a part of the test
+   suite: odbc_strlen_bench [iterations] */
+
+#include <ma_odbc.h>
+#include <time.h>
+
+static SQLLEN CallbackCharLen(const char *str, SQLINTEGER OctetLen, MARIADB_CHARSET_INFO *cs)
+{
+  SQLLEN       result= 0;
+  const char   *ptr= str;
+  unsigned int charlen;
+
+  while (ptr < str + OctetLen && *ptr != '\0')
+  {
+    charlen= cs->mb_charlen((unsigned char)*ptr);
+    ptr+= charlen > 0 ? charlen : 1;
+    ++result;
+  }
+  return result;
+}
+
+static SQLLEN LoopWcsLen(SQLWCHAR *str, SQLLEN buff_length)
+{
+  SQLLEN result= 0;
+
+  while ((--buff_length) != -1 && *str)
+  {
+    ++result;
+    ++str;
+  }
+  return result;
+}
+
+static double Elapsed(clock_t Start)
+{
+  return (double)(clock() - Start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char **argv)
+{
+  MARIADB_CHARSET_INFO *cs= mariadb_get_charset_by_name("utf8mb4");
+  const char *Samples[]= {"Customer#000000042",
+                          "1996-01-02 10:11:12.123",
+                          "carefully final deposits detect slyly agai; furiously regular accounts haggle blithely",
+                          "Zürich Straße, Café Müller – Öffnungszeiten nach Vereinbarung, Größe 42",
+                          NULL};
+  char        Buffer[4096];
+  SQLWCHAR    WBuffer[4096];
+  long        Iterations= argc > 1 ? atol(argv[1]) : 2000000, i;
+  int         s;
+  size_t      Length;
+  volatile SQLLEN Sink= 0;
+  clock_t     Start;
+  double      Old, New;
+
+  if (cs == NULL)
+  {
+    fprintf(stderr, "utf8mb4 charset is not available\n");
+    return 1;
+  }
+
+  printf("%-12s %6s %10s %10s %8s\n", "function", "bytes", "old, s", "new, s", "speedup");
+  for (s= 0; s <= 4; ++s)
+  {
+    /* The last sample is a 1k value */
+    if (Samples[s] != NULL)
+    {
+      strcpy(Buffer, Samples[s]);
+    }
+    else
+    {
+      for (Buffer[0]= '\0'; strlen(Buffer) < 1024;)
+      {
+        strcat(Buffer, Samples[3]);
+      }
+    }
+    Length= strlen(Buffer);
+
+    Start= clock();
+    for (i= 0; i < Iterations; ++i)
+    {
+      Sink+= CallbackCharLen(Buffer, (SQLINTEGER)Length, cs);
+    }
+    Old= Elapsed(Start);
+    Start= clock();
+    for (i= 0; i < Iterations; ++i)
+    {
+      Sink+= MADB_Utf8CharLen(Buffer, Length);
+    }
+    New= Elapsed(Start);
+    printf("%-12s %6u %10.3f %10.3f %7.1fx\n", "MbstrCharLen", (unsigned int)Length, Old, New, New > 0 ? Old / New : 0);
+
+    for (i= 0; i <= (long)Length; ++i)
+    {
+      WBuffer[i]= (SQLWCHAR)(unsigned char)Buffer[i];
+    }
+    Start= clock();
+    for (i= 0; i < Iterations; ++i)
+    {
+      Sink+= LoopWcsLen(WBuffer, -1);
+    }
+    Old= Elapsed(Start);
+    Start= clock();
+    for (i= 0; i < Iterations; ++i)
+    {
+      Sink+= MADB_WcsLen(WBuffer, -1);
+    }
+    New= Elapsed(Start);
+    printf("%-12s %6u %10.3f %10.3f %7.1fx\n", "SqlwcsLen", (unsigned int)Length, Old, New, New > 0 ? Old / New : 0);
+  }
+
+  return Sink == 0;
+}